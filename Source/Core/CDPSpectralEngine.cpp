@@ -12,7 +12,9 @@
 #include "CDPSpectralEngine.h"
 #include "RealtimeMemoryManager.h"
 #include "PerformanceProfiler.h"
-#include <random>
+#include "../dsp/SpectralKernels.h"
+#include <limits>
+#include <numeric>
 #include <algorithm>
 #include <cmath>
 
@@ -23,41 +25,14 @@
 CDPSpectralEngine::CDPSpectralEngine()
     : currentWindowType(juce::dsp::WindowingFunction<float>::hann)
 {
-    // Initialize FFT with default size
     int fftSize = currentFFTSize.load();
-    forwardFFT = std::make_unique<juce::dsp::FFT>(std::log2(fftSize));
-    inverseFFT = std::make_unique<juce::dsp::FFT>(std::log2(fftSize));
-    windowFunction = std::make_unique<juce::dsp::WindowingFunction<float>>(fftSize, currentWindowType);
     
-    // Initialize phase vocoder
+    // Initialize phase vocoder (per-channel phase state lives in ChannelState)
     phaseVocoder = std::make_unique<PhaseVocoder>();
-    
-    // Initialize processing buffers
-    fftBuffer.resize(fftSize * 2, std::complex<float>(0.0f, 0.0f));
-    windowedInput.resize(fftSize, 0.0f);
-    overlapBuffer.resize(fftSize, 0.0f);
-    outputBuffer.resize(fftSize, 0.0f);
-    
-    // Initialize spectral data storage
-    int spectrumSize = fftSize / 2;
-    currentMagnitudes.resize(spectrumSize, 0.0f);
-    currentPhases.resize(spectrumSize, 0.0f);
-    processedMagnitudes.resize(spectrumSize, 0.0f);
-    processedPhases.resize(spectrumSize, 0.0f);
-    
-    // Initialize spectral history for temporal effects
-    spectralHistory.resize(SPECTRAL_HISTORY_SIZE);
-    frozenSpectrum.resize(SPECTRAL_HISTORY_SIZE);
-    for (auto& frame : spectralHistory)
-        frame.resize(spectrumSize, 0.0f);
-    for (auto& frame : frozenSpectrum)
-        frame.resize(spectrumSize, 0.0f);
-    
-    // Initialize phase vocoder
     phaseVocoder->analysisWindow.resize(fftSize, 0.0f);
     phaseVocoder->synthesisWindow.resize(fftSize, 0.0f);
-    phaseVocoder->previousPhases.resize(spectrumSize, 0.0f);
-    phaseVocoder->phaseAdvances.resize(spectrumSize, 0.0f);
+    
+    buildBlurTables();
     
     // Initialize effect parameters
     for (auto& param : effectParameters)
@@ -78,9 +53,9 @@ CDPSpectralEngine::CDPSpectralEngine()
     // Initialize spectral frame history
     for (auto& frame : spectralFrameHistory)
     {
-        frame.magnitudes.resize(spectrumSize, 0.0f);
-        frame.phases.resize(spectrumSize, 0.0f);
-        frame.processedMags.resize(spectrumSize, 0.0f);
+        frame.magnitudes.reserve(MAX_BINS);
+        frame.phases.reserve(MAX_BINS);
+        frame.processedMags.reserve(MAX_BINS);
     }
     
     // Initialize performance profiler
@@ -100,42 +75,46 @@ CDPSpectralEngine::~CDPSpectralEngine()
 
 void CDPSpectralEngine::prepareToPlay(double sampleRate, int samplesPerBlock, int numChannels)
 {
+    // A second prepare without release must not leave the old thread running
+    releaseResources();
+    
     currentSampleRate = sampleRate;
     currentSamplesPerBlock = samplesPerBlock;
     currentNumChannels = numChannels;
     
-    // Reinitialize FFT if needed
-    int fftSize = currentFFTSize.load();
-    if (!forwardFFT || forwardFFT->getSize() != fftSize)
-    {
-        forwardFFT = std::make_unique<juce::dsp::FFT>(std::log2(fftSize));
-        inverseFFT = std::make_unique<juce::dsp::FFT>(std::log2(fftSize));
-        windowFunction = std::make_unique<juce::dsp::WindowingFunction<float>>(fftSize, currentWindowType);
-        
-        // Resize buffers
-        fftBuffer.resize(fftSize * 2);
-        windowedInput.resize(fftSize);
-        overlapBuffer.resize(fftSize);
-        outputBuffer.resize(fftSize);
-        
-        int spectrumSize = fftSize / 2;
-        currentMagnitudes.resize(spectrumSize);
-        currentPhases.resize(spectrumSize);
-        processedMagnitudes.resize(spectrumSize);
-        processedPhases.resize(spectrumSize);
-        
-        // Resize spectral history
-        for (auto& frame : spectralHistory)
-            frame.resize(spectrumSize);
-        for (auto& frame : frozenSpectrum)
-            frame.resize(spectrumSize);
-        for (auto& frame : spectralFrameHistory)
-        {
-            frame.magnitudes.resize(spectrumSize);
-            frame.phases.resize(spectrumSize);
-            frame.processedMags.resize(spectrumSize);
-        }
-    }
+    // Per-channel spectral and effect state; all of it is sized for MAX_BINS
+    // so FFT size changes never allocate on the audio thread
+    namespace Det = SpectralCanvas::Determinism;
+    const uint32_t seed = Det::IsEnabled() ? Det::GetSeed()
+                                           : static_cast<uint32_t>(reinterpret_cast<uintptr_t>(this) >> 4) ^ 0x9E3779B9u;
+    channelStates.clear();
+    channelStates.resize((size_t) juce::jmax(1, numChannels));
+    for (size_t ch = 0; ch < channelStates.size(); ++ch)
+        prepareChannelState(channelStates[ch], seed + 0x9E3779B9u * static_cast<uint32_t>(ch));
+    
+    // Optional workers for parallel layers/channels; batches wait at most a
+    // tenth of a block for a worker to wake before running serially
+    if (numWorkerThreads > 0)
+        workerPool = std::make_unique<SpectralWorkerPool>(numWorkerThreads, sampleRate, samplesPerBlock);
+    parallelWakeBudgetTicks = static_cast<juce::int64>(juce::Time::getHighResolutionTicksPerSecond()
+                                                       * (samplesPerBlock / sampleRate) * 0.1);
+    
+    // Per-channel analysis/overlap-add state for the current FFT configuration
+    builtStftConfig = makeStftConfig();
+    stft = createStft(builtStftConfig);
+    stftConfigDirty.store(false);
+    
+    // Recent input to warm up a replacement STFT, and the old STFT's output
+    // for the block it is crossfaded out over
+    const int stftChannels = juce::jmax(1, numChannels);
+    inputHistory.setSize(stftChannels, MAX_FFT_SIZE);
+    inputHistory.clear();
+    historyWritePos = 0;
+    prerollInput.setSize(stftChannels, MAX_FFT_SIZE);
+    prerollOutput.setSize(stftChannels, MAX_FFT_SIZE);
+    crossfadeBuffer.setSize(stftChannels, juce::jmax(1, samplesPerBlock));
+    setNumBins(stft->getNumBins());
+    publishLatency(stft->getLatencySamples());
     
     // Initialize parameter smoothing time constants
     for (auto& smoother : parameterSmoothers)
@@ -149,99 +128,191 @@ void CDPSpectralEngine::prepareToPlay(double sampleRate, int samplesPerBlock, in
     DBG("🎨 CDPSpectralEngine prepared: " << sampleRate << "Hz, " << samplesPerBlock << " samples, " << numChannels << " channels");
 }
 
+CDPSpectralEngine::STFTConfig CDPSpectralEngine::makeStftConfig() const
+{
+    const int fftSize = currentFFTSize.load();
+    
+    // The hop must divide the FFT size: round the overlap to 1 - 1/2^k
+    const float overlap = currentOverlapFactor.load();
+    const int framesPerWindow = juce::nextPowerOfTwo(juce::jmax(1, juce::roundToInt(1.0f / (1.0f - overlap))));
+    const int hopSize = juce::jmax(1, fftSize / framesPerWindow);
+    
+    return { fftSize, hopSize, juce::jmax(1, currentNumChannels), currentWindowType.load() };
+}
+
+std::unique_ptr<CDPSpectralEngine::STFTEngine> CDPSpectralEngine::createStft(const STFTConfig& config)
+{
+    auto engine = std::make_unique<STFTEngine>();
+    engine->prepare(currentSampleRate, config);
+    engine->setFrameCallback([this](int channel, std::complex<float>* bins, int numBins)
+    {
+        processSpectrumFrame(channelStates[(size_t) juce::jmin(channel, (int) channelStates.size() - 1)],
+                             reinterpret_cast<float*>(bins), numBins);
+    });
+    engine->setFrameExecutor([this](STFTEngine::TaskFn task, void* context, int numTasks)
+    {
+        if (shouldParallelizeChannels(numTasks))
+            workerPool->run(task, context, numTasks);
+        else
+            for (int i = 0; i < numTasks; ++i)
+                task(context, i);
+    });
+    return engine;
+}
+
+void CDPSpectralEngine::EffectScratch::allocate(uint32_t seed)
+{
+    for (auto* v : { &mags, &phases })
+        v->reserve(MAX_BINS);
+    for (auto* v : { &a, &b, &blur })
+        v->assign(MAX_BINS, 0.0f);
+    indices.assign(MAX_BINS, 0);
+    rng = SpectralCanvas::Determinism::Lcg32(seed);
+}
+
+void CDPSpectralEngine::prepareChannelState(ChannelState& state, uint32_t seed)
+{
+    for (auto* v : { &state.currentMagnitudes, &state.currentPhases, &state.processedMagnitudes,
+                     &state.processedPhases, &state.previousPhases, &state.phaseAdvances })
+        v->reserve(MAX_BINS);
+    
+    state.spectralHistory.resize(SPECTRAL_HISTORY_SIZE);
+    state.frozenSpectrum.resize(SPECTRAL_HISTORY_SIZE);
+    for (auto& frame : state.spectralHistory)
+        frame.reserve(MAX_BINS);
+    for (auto& frame : state.frozenSpectrum)
+        frame.reserve(MAX_BINS);
+    
+    // Each layer gets its own generator so results never depend on which
+    // thread ran it, or in what order
+    state.scratch.allocate(seed);
+    for (size_t i = 0; i < state.layerScratch.size(); ++i)
+        state.layerScratch[i].allocate(seed ^ (0x85EBCA6Bu * static_cast<uint32_t>(i + 1)));
+    
+    state.freezeCaptured = false;
+    state.arpeggiateCounter = 0;
+    state.historyIndex = 0;
+}
+
+void CDPSpectralEngine::prerollStft(STFTEngine& engine, int numChannels) noexcept
+{
+    // Feed the engine the last fftSize input samples (oldest first) and
+    // discard what it outputs: its FIFO and overlap-add accumulators then hold
+    // exactly what they would had it been running all along, and its next
+    // output sample lines up with the outgoing engine's.
+    const int length = engine.getConfig().fftSize;
+    const int start = (historyWritePos - length + MAX_FFT_SIZE) % MAX_FFT_SIZE;
+    const int first = juce::jmin(length, MAX_FFT_SIZE - start);
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        prerollInput.copyFrom(ch, 0, inputHistory, ch, start, first);
+        if (first < length)
+            prerollInput.copyFrom(ch, first, inputHistory, ch, 0, length - first);
+    }
+    
+    engine.process(prerollInput.getArrayOfReadPointers(), prerollOutput.getArrayOfWritePointers(),
+                   numChannels, length);
+}
+
+void CDPSpectralEngine::publishLatency(int samples)
+{
+    latencySamples.store(samples);
+    if (latencyCallback)
+        latencyCallback(samples);
+}
+
+void CDPSpectralEngine::setNumBins(int numBins) noexcept
+{
+    // All vectors have MAX_BINS capacity, so none of this allocates
+    for (auto& state : channelStates)
+    {
+        for (auto* v : { &state.currentMagnitudes, &state.currentPhases, &state.processedMagnitudes,
+                         &state.processedPhases, &state.previousPhases, &state.phaseAdvances,
+                         &state.scratch.mags, &state.scratch.phases })
+            v->resize((size_t) numBins, 0.0f);
+        for (auto& layer : state.layerScratch)
+        {
+            layer.mags.resize((size_t) numBins, 0.0f);
+            layer.phases.resize((size_t) numBins, 0.0f);
+        }
+        for (auto& frame : state.spectralHistory)
+            frame.resize((size_t) numBins, 0.0f);
+        for (auto& frame : state.frozenSpectrum)
+            frame.resize((size_t) numBins, 0.0f);
+    }
+}
+
 void CDPSpectralEngine::processBlock(juce::AudioBuffer<float>& buffer)
 {
     // REAL-TIME SAFE: Use lock-free profiler with zero allocation
     RT_SCOPED_TIMER("CDPSpectralEngine::processBlock");
     
-    if (activeEffect.load() == SpectralEffect::None && activeLayerCount.load() == 0)
-    {
-        // No effects active, pass through
+    if (stft == nullptr)
         return;
-    }
     
-    const int numChannels = buffer.getNumChannels();
+    const int numChannels = juce::jmin(buffer.getNumChannels(), inputHistory.getNumChannels());
     const int numSamples = buffer.getNumSamples();
-    const int fftSize = currentFFTSize.load();
-    const float overlapFactor = currentOverlapFactor.load();
-    const int hopSize = static_cast<int>(fftSize * (1.0f - overlapFactor));
     
-    // Process each channel independently
-    for (int channel = 0; channel < numChannels; ++channel)
+    // Adopt a reconfigured STFT once the previous one has been collected. The
+    // old one renders this block once more so the two can be crossfaded; the
+    // new one is first warmed up on recent input so it starts with full
+    // overlap-add state instead of fftSize samples of silence.
+    std::unique_ptr<STFTEngine> outgoing;
+    if (retiredStft.load() == nullptr)
     {
-        auto* channelData = buffer.getWritePointer(channel);
-        
-        // Process in overlapping blocks
-        for (int sampleIndex = 0; sampleIndex < numSamples; sampleIndex += hopSize)
+        if (auto* fresh = pendingStft.exchange(nullptr))
         {
-            int samplesToProcess = std::min(hopSize, numSamples - sampleIndex);
+            outgoing = std::move(stft);
+            stft.reset(fresh);
             
-            // Copy input to windowed buffer
-            std::fill(windowedInput.begin(), windowedInput.end(), 0.0f);
-            for (int i = 0; i < samplesToProcess && i < fftSize; ++i)
+            const bool fade = numSamples <= crossfadeBuffer.getNumSamples();
+            if (fade)
             {
-                if (sampleIndex + i < numSamples)
-                    windowedInput[i] = channelData[sampleIndex + i];
+                for (int ch = 0; ch < numChannels; ++ch)
+                    crossfadeBuffer.copyFrom(ch, 0, buffer, ch, 0, numSamples);
+                outgoing->process(crossfadeBuffer.getArrayOfReadPointers(), crossfadeBuffer.getArrayOfWritePointers(),
+                                  numChannels, numSamples);
             }
             
-            // Apply window function
-            windowFunction->multiplyWithWindowingTable(windowedInput.data(), fftSize);
-            
-            // Forward FFT
-            std::fill(fftBuffer.begin(), fftBuffer.end(), std::complex<float>(0.0f, 0.0f));
-            for (int i = 0; i < fftSize; ++i)
-                fftBuffer[i] = std::complex<float>(windowedInput[i], 0.0f);
-            
-            forwardFFT->perform(fftBuffer.data(), reinterpret_cast<std::complex<float>*>(fftBuffer.data()), false);
-            
-            // Extract magnitude and phase
-            const int spectrumSize = fftSize / 2;
-            for (int i = 0; i < spectrumSize; ++i)
-            {
-                currentMagnitudes[i] = std::abs(fftBuffer[i]);
-                currentPhases[i] = std::arg(fftBuffer[i]);
-            }
+            setNumBins(stft->getNumBins());
+            prerollStft(*stft, numChannels);
             
-            // Copy to processed arrays
-            processedMagnitudes = currentMagnitudes;
-            processedPhases = currentPhases;
-            
-            // Apply active spectral effects
-            applyActiveSpectralEffects();
-            
-            // Reconstruct complex spectrum
-            for (int i = 0; i < spectrumSize; ++i)
+            if (! fade)
+                retiredStft.store(outgoing.release());
+        }
+    }
+    
+    // Keep the last MAX_FFT_SIZE input samples for the next pre-roll
+    for (int i = 0; i < numSamples; )
+    {
+        const int n = juce::jmin(numSamples - i, MAX_FFT_SIZE - historyWritePos);
+        for (int ch = 0; ch < numChannels; ++ch)
+            inputHistory.copyFrom(ch, historyWritePos, buffer, ch, i, n);
+        historyWritePos = (historyWritePos + n) % MAX_FFT_SIZE;
+        i += n;
+    }
+    
+    // The STFT runs even with no effect active (untouched bins reconstruct
+    // exactly), so the reported latency holds whatever is enabled. In-place
+    // processing is safe: each chunk is read into the FIFO before it is written.
+    stft->process(buffer.getArrayOfReadPointers(), buffer.getArrayOfWritePointers(),
+                  buffer.getNumChannels(), numSamples);
+    
+    if (outgoing != nullptr)
+    {
+        // Linear crossfade from the outgoing STFT's output to the new one's
+        const float step = 1.0f / (float) numSamples;
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            auto* out = buffer.getWritePointer(ch);
+            const auto* old = crossfadeBuffer.getReadPointer(ch);
+            for (int i = 0; i < numSamples; ++i)
             {
-                float mag = processedMagnitudes[i];
-                float phase = processedPhases[i];
-                fftBuffer[i] = std::complex<float>(mag * std::cos(phase), mag * std::sin(phase));
-                // Mirror for real signal
-                if (i > 0 && i < spectrumSize - 1)
-                    fftBuffer[fftSize - i] = std::conj(fftBuffer[i]);
+                const float g = (float) (i + 1) * step;
+                out[i] = g * out[i] + (1.0f - g) * old[i];
             }
-            
-            // Inverse FFT
-            inverseFFT->perform(fftBuffer.data(), reinterpret_cast<std::complex<float>*>(fftBuffer.data()), true);
-            
-            // Extract real part and apply window
-            for (int i = 0; i < fftSize; ++i)
-                outputBuffer[i] = fftBuffer[i].real();
-            
-            windowFunction->multiplyWithWindowingTable(outputBuffer.data(), fftSize);
-            
-            // Overlap-add to output
-            for (int i = 0; i < samplesToProcess && i < fftSize; ++i)
-            {
-                if (sampleIndex + i < numSamples)
-                {
-                    channelData[sampleIndex + i] = outputBuffer[i] + overlapBuffer[i];
-                }
-            }
-            
-            // Store overlap for next frame
-            std::copy(outputBuffer.begin() + hopSize, outputBuffer.end(), overlapBuffer.begin());
-            std::fill(overlapBuffer.begin() + (fftSize - hopSize), overlapBuffer.end(), 0.0f);
         }
+        retiredStft.store(outgoing.release());
     }
     
     // Update performance statistics
@@ -262,6 +333,11 @@ void CDPSpectralEngine::releaseResources()
         processingThread.reset();
     }
     
+    // Nothing else touches the hand-over slots once the thread has stopped
+    delete pendingStft.exchange(nullptr);
+    delete retiredStft.exchange(nullptr);
+    workerPool.reset();
+    
     processingStats.isProcessingThreadActive.store(false);
     
     DBG("🎨 CDPSpectralEngine resources released");
@@ -451,6 +527,25 @@ void CDPSpectralEngine::processingThreadFunction()
         // Adaptive processing updates
         updateAdaptiveProcessing();
         
+        // Free an STFT the audio thread has replaced, then build the next one
+        // if the FFT configuration changed (allocation stays off the audio thread)
+        // Settings that round to the same hop and window need no new engine
+        delete retiredStft.exchange(nullptr);
+        if (stftConfigDirty.exchange(false))
+        {
+            const auto config = makeStftConfig();
+            if (config.fftSize != builtStftConfig.fftSize || config.hopSize != builtStftConfig.hopSize
+                || config.window != builtStftConfig.window)
+            {
+                builtStftConfig = config;
+                auto fresh = createStft(config);
+                const int latency = fresh->getLatencySamples();
+                delete pendingStft.exchange(fresh.release()); // an unadopted older one is dropped
+                if (latency != latencySamples.load())        // overlap/window changes keep the latency
+                    publishLatency(latency);
+            }
+        }
+        
         // Sleep briefly to avoid consuming too much CPU
         std::this_thread::sleep_for(std::chrono::microseconds(100));
     }
@@ -484,10 +579,60 @@ bool CDPSpectralEngine::popCommand(ProcessingCommand& command)
 // Individual Spectral Effects Implementation
 //==============================================================================
 
-void CDPSpectralEngine::applyActiveSpectralEffects()
+void CDPSpectralEngine::processSpectrumFrame(ChannelState& state, float* bins, int numBins)
+{
+    // Untouched bins resynthesise the input exactly
+    if (activeEffect.load() == SpectralEffect::None && activeLayerCount.load() == 0)
+        return;
+    
+    // Magnitudes are always needed; phases only when an effect rewrites them.
+    // Magnitude-only chains rescale the cartesian bins in place, so most
+    // frames never touch atan2/sin/cos.
+    const bool withPhases = effectChainUsesPhase();
+    
+    SpectralKernels::magnitudes(bins, state.currentMagnitudes.data(), numBins);
+    juce::FloatVectorOperations::copy(state.processedMagnitudes.data(), state.currentMagnitudes.data(), numBins);
+    
+    if (withPhases)
+    {
+        SpectralKernels::phases(bins, state.currentPhases.data(), numBins);
+        juce::FloatVectorOperations::copy(state.processedPhases.data(), state.currentPhases.data(), numBins);
+    }
+    
+    applyActiveSpectralEffects(state, withPhases);
+    
+    if (withPhases)
+        SpectralKernels::fromPolar(state.processedMagnitudes.data(), state.processedPhases.data(), bins, numBins);
+    else
+        SpectralKernels::applyMagnitudes(bins, state.currentMagnitudes.data(), state.processedMagnitudes.data(), numBins);
+}
+
+bool CDPSpectralEngine::effectUsesPhase(SpectralEffect effect) noexcept
+{
+    return effect == SpectralEffect::Randomize
+        || effect == SpectralEffect::Shuffle
+        || effect == SpectralEffect::TimeExpand;
+}
+
+bool CDPSpectralEngine::effectChainUsesPhase() const noexcept
+{
+    if (effectIntensity.load() > 0.0f && effectUsesPhase(activeEffect.load()))
+        return true;
+    
+    const int layerCount = activeLayerCount.load();
+    for (int i = 0; i < layerCount && i < MAX_EFFECT_LAYERS; ++i)
+        if (effectLayers[i].active && effectLayers[i].intensity > 0.0f && effectUsesPhase(effectLayers[i].effect))
+            return true;
+    
+    return false;
+}
+
+void CDPSpectralEngine::applyActiveSpectralEffects(ChannelState& state, bool withPhases)
 {
     SpectralEffect primaryEffect = activeEffect.load();
     float intensity = effectIntensity.load();
+    auto& magnitudes = state.processedMagnitudes;
+    auto& phases = state.processedPhases;
     
     if (primaryEffect != SpectralEffect::None && intensity > 0.0f)
     {
@@ -495,32 +640,32 @@ void CDPSpectralEngine::applyActiveSpectralEffects()
         switch (primaryEffect)
         {
             case SpectralEffect::Blur:
-                applySpectralBlur(processedMagnitudes, intensity);
+                applySpectralBlur(magnitudes, intensity, state.scratch);
                 break;
                 
             case SpectralEffect::Randomize:
-                applySpectralRandomize(processedMagnitudes, processedPhases, intensity);
+                applySpectralRandomize(magnitudes, phases, intensity, state.scratch);
                 break;
                 
             case SpectralEffect::Shuffle:
-                applySpectralShuffle(processedMagnitudes, processedPhases, intensity);
+                applySpectralShuffle(magnitudes, phases, intensity, state.scratch);
                 break;
                 
             case SpectralEffect::Freeze:
-                applySpectralFreeze(processedMagnitudes, processedPhases, intensity);
+                applySpectralFreeze(magnitudes, phases, intensity, state);
                 break;
                 
             case SpectralEffect::Arpeggiate:
                 {
                     float rate = effectParameters[0].load();
-                    applySpectralArpeggiate(processedMagnitudes, processedPhases, rate, intensity);
+                    applySpectralArpeggiate(magnitudes, phases, rate, intensity, state);
                 }
                 break;
                 
             case SpectralEffect::TimeExpand:
                 {
                     float factor = effectParameters[0].load();
-                    applySpectralTimeExpand(processedMagnitudes, processedPhases, factor);
+                    applySpectralTimeExpand(magnitudes, phases, factor, state);
                 }
                 break;
                 
@@ -530,92 +675,215 @@ void CDPSpectralEngine::applyActiveSpectralEffects()
     }
     
     // Apply layered effects
+    if (layerRouting.load() == LayerRouting::Parallel)
+    {
+        applyParallelLayers(state, withPhases);
+        return;
+    }
+    
     int layerCount = activeLayerCount.load();
     for (int i = 0; i < layerCount && i < MAX_EFFECT_LAYERS; ++i)
     {
         if (effectLayers[i].active && effectLayers[i].intensity > 0.0f)
         {
-            // Store original state
-            auto originalMags = processedMagnitudes;
-            auto originalPhases = processedPhases;
+            // Store original state in preallocated scratch
+            const int numBins = static_cast<int>(magnitudes.size());
+            float* originalMags = state.scratch.mags.data();
+            float* originalPhases = state.scratch.phases.data();
+            juce::FloatVectorOperations::copy(originalMags, magnitudes.data(), numBins);
+            if (withPhases)
+                juce::FloatVectorOperations::copy(originalPhases, phases.data(), numBins);
             
             // Apply layer effect
-            float layerIntensity = effectLayers[i].intensity;
-            switch (effectLayers[i].effect)
-            {
-                case SpectralEffect::Blur:
-                    applySpectralBlur(processedMagnitudes, layerIntensity);
-                    break;
-                    
-                case SpectralEffect::Randomize:
-                    applySpectralRandomize(processedMagnitudes, processedPhases, layerIntensity);
-                    break;
-                    
-                // Add other effects as needed
-                default:
-                    break;
-            }
+            applyLayerEffect(effectLayers[i], magnitudes, phases, state.layerScratch[(size_t) i]);
             
             // Mix with original based on layer mix amount
             float mix = effectLayers[i].mix;
-            for (size_t j = 0; j < processedMagnitudes.size(); ++j)
-            {
-                processedMagnitudes[j] = originalMags[j] * (1.0f - mix) + processedMagnitudes[j] * mix;
-                processedPhases[j] = originalPhases[j] * (1.0f - mix) + processedPhases[j] * mix;
-            }
+            for (size_t j = 0; j < magnitudes.size(); ++j)
+                magnitudes[j] = originalMags[j] * (1.0f - mix) + magnitudes[j] * mix;
+            
+            if (withPhases)
+                for (size_t j = 0; j < phases.size(); ++j)
+                    phases[j] = originalPhases[j] * (1.0f - mix) + phases[j] * mix;
         }
     }
 }
 
-void CDPSpectralEngine::applySpectralBlur(std::vector<float>& magnitudes, float intensity)
+void CDPSpectralEngine::applyLayerEffect(const EffectLayer& layer, std::vector<float>& magnitudes,
+                                         std::vector<float>& phases, EffectScratch& scratch)
+{
+    switch (layer.effect)
+    {
+        case SpectralEffect::Blur:
+            applySpectralBlur(magnitudes, layer.intensity, scratch);
+            break;
+            
+        case SpectralEffect::Randomize:
+            applySpectralRandomize(magnitudes, phases, layer.intensity, scratch);
+            break;
+            
+        // Add other effects as needed
+        default:
+            break;
+    }
+}
+
+void CDPSpectralEngine::applyParallelLayers(ChannelState& state, bool withPhases)
+{
+    std::array<int, MAX_EFFECT_LAYERS> layers{};
+    int numLayers = 0;
+    const int layerCount = activeLayerCount.load();
+    for (int i = 0; i < layerCount && i < MAX_EFFECT_LAYERS; ++i)
+        if (effectLayers[i].active && effectLayers[i].intensity > 0.0f)
+            layers[(size_t) numLayers++] = i;
+    
+    if (numLayers == 0)
+        return;
+    
+    // Every layer starts from the same input, so the branches are independent
+    const int numBins = static_cast<int>(state.processedMagnitudes.size());
+    auto runLayer = [&](int k)
+    {
+        const int i = layers[(size_t) k];
+        auto& scratch = state.layerScratch[(size_t) i];
+        juce::FloatVectorOperations::copy(scratch.mags.data(), state.processedMagnitudes.data(), numBins);
+        if (withPhases)
+            juce::FloatVectorOperations::copy(scratch.phases.data(), state.processedPhases.data(), numBins);
+        applyLayerEffect(effectLayers[i], scratch.mags, scratch.phases, scratch);
+    };
+    
+    if (shouldRunParallel(numLayers, numBins))
+        workerPool->runEach(numLayers, runLayer);
+    else
+        for (int k = 0; k < numLayers; ++k)
+            runLayer(k);
+    
+    // Sum each branch's mix-weighted change onto the shared input
+    float* deltaMags = state.scratch.a.data();
+    float* deltaPhases = state.scratch.b.data();
+    juce::FloatVectorOperations::clear(deltaMags, numBins);
+    if (withPhases)
+        juce::FloatVectorOperations::clear(deltaPhases, numBins);
+    
+    for (int k = 0; k < numLayers; ++k)
+    {
+        const int i = layers[(size_t) k];
+        const float mix = effectLayers[i].mix;
+        const auto& scratch = state.layerScratch[(size_t) i];
+        for (int j = 0; j < numBins; ++j)
+            deltaMags[j] += mix * (scratch.mags[(size_t) j] - state.processedMagnitudes[(size_t) j]);
+        if (withPhases)
+            for (int j = 0; j < numBins; ++j)
+                deltaPhases[j] += mix * (scratch.phases[(size_t) j] - state.processedPhases[(size_t) j]);
+    }
+    
+    juce::FloatVectorOperations::add(state.processedMagnitudes.data(), deltaMags, numBins);
+    if (withPhases)
+        juce::FloatVectorOperations::add(state.processedPhases.data(), deltaPhases, numBins);
+    
+    // Summed branches can push a bin below zero
+    juce::FloatVectorOperations::clip(state.processedMagnitudes.data(), state.processedMagnitudes.data(),
+                                      0.0f, std::numeric_limits<float>::max(), numBins);
+}
+
+bool CDPSpectralEngine::shouldRunParallel(int numTasks, int binsPerTask) noexcept
+{
+    return workerPool != nullptr
+        && numTasks > 1
+        && numTasks * binsPerTask >= PARALLEL_MIN_BINS
+        && workerPool->isResponsive(parallelWakeBudgetTicks);
+}
+
+bool CDPSpectralEngine::shouldParallelizeChannels(int numChannels) noexcept
+{
+    // With parallel routing and at least as many layers as channels, the
+    // layers make better use of the pool (nested batches would run serially)
+    if (layerRouting.load() == LayerRouting::Parallel && activeLayerCount.load() >= numChannels)
+        return false;
+    
+    const int numBins = channelStates.empty() ? 0 : static_cast<int>(channelStates[0].processedMagnitudes.size());
+    return shouldRunParallel(numChannels, numBins);
+}
+
+void CDPSpectralEngine::applySpectralBlur(std::vector<float>& magnitudes, float intensity, EffectScratch& scratch)
 {
     if (intensity <= 0.0f) return;
     
-    // CDP-style spectral blur using convolution with gaussian-like kernel
-    float kernelSize = 1.0f + intensity * 8.0f; // 1-9 bin kernel
-    int kernelRadius = static_cast<int>(kernelSize);
+    // Two cascaded running-sum boxes with the variance of the original
+    // truncated Gaussian (sigma = radius = 1 + 8 * intensity): O(bins) for any radius
+    const int step = juce::jlimit(0, BLUR_INTENSITY_STEPS - 1, juce::roundToInt(intensity * (BLUR_INTENSITY_STEPS - 1)));
+    const auto& radii = blurBoxRadii[(size_t) step];
+    const int numBins = static_cast<int>(magnitudes.size());
     
-    std::vector<float> blurred(magnitudes.size(), 0.0f);
+    float* blurred = scratch.blur.data();
+    boxBlur(magnitudes.data(), scratch.a.data(), numBins, radii[0]);
+    boxBlur(scratch.a.data(), blurred, numBins, radii[1]);
     
-    for (size_t i = 0; i < magnitudes.size(); ++i)
+    // Mix with original based on intensity
+    for (int i = 0; i < numBins; ++i)
+        magnitudes[i] = magnitudes[i] * (1.0f - intensity) + blurred[i] * intensity;
+}
+
+void CDPSpectralEngine::boxBlur(const float* src, float* dst, int numBins, int radius) noexcept
+{
+    if (radius <= 0)
     {
-        float sum = 0.0f;
-        float weightSum = 0.0f;
+        std::copy(src, src + numBins, dst);
+        return;
+    }
+    
+    // Sliding window sum; edge windows are normalised by the bins they cover,
+    // like the original kernel's weightSum
+    double sum = 0.0;
+    int lo = 0, hi = 0; // window is [lo, hi)
+    for (int i = 0; i < numBins; ++i)
+    {
+        const int wantHi = std::min(numBins, i + radius + 1);
+        const int wantLo = std::max(0, i - radius);
+        while (hi < wantHi) sum += src[hi++];
+        while (lo < wantLo) sum -= src[lo++];
+        dst[i] = static_cast<float>(sum / (hi - lo));
+    }
+}
+
+void CDPSpectralEngine::buildBlurTables()
+{
+    for (int step = 0; step < BLUR_INTENSITY_STEPS; ++step)
+    {
+        const float intensity = static_cast<float>(step) / (BLUR_INTENSITY_STEPS - 1);
+        const float sigma = 1.0f + intensity * 8.0f;
+        const int radius = static_cast<int>(sigma);
         
-        for (int k = -kernelRadius; k <= kernelRadius; ++k)
+        // Variance of the truncated Gaussian kernel the blur used to convolve with
+        double weightSum = 0.0, variance = 0.0;
+        for (int k = -radius; k <= radius; ++k)
         {
-            int index = static_cast<int>(i) + k;
-            if (index >= 0 && index < static_cast<int>(magnitudes.size()))
-            {
-                float weight = std::exp(-0.5f * (k * k) / (kernelSize * kernelSize));
-                sum += magnitudes[index] * weight;
-                weightSum += weight;
-            }
+            const double w = std::exp(-0.5 * k * k / (sigma * sigma));
+            weightSum += w;
+            variance += w * k * k;
         }
+        variance /= weightSum;
         
-        if (weightSum > 0.0f)
-            blurred[i] = sum / weightSum;
-    }
-    
-    // Mix with original based on intensity
-    for (size_t i = 0; i < magnitudes.size(); ++i)
-    {
-        magnitudes[i] = magnitudes[i] * (1.0f - intensity) + blurred[i] * intensity;
+        // A box of radius r has variance r(r+1)/3; split it across two boxes
+        auto boxVariance = [](int r) { return r * (r + 1) / 3.0; };
+        int r1 = 0;
+        while (boxVariance(r1 + 1) <= variance * 0.5) ++r1;
+        int r2 = r1;
+        while (std::abs(boxVariance(r1) + boxVariance(r2 + 1) - variance) < std::abs(boxVariance(r1) + boxVariance(r2) - variance))
+            ++r2;
+        blurBoxRadii[(size_t) step] = { r1, r2 };
     }
 }
 
-void CDPSpectralEngine::applySpectralRandomize(std::vector<float>& magnitudes, std::vector<float>& phases, float intensity)
+void CDPSpectralEngine::applySpectralRandomize(std::vector<float>& magnitudes, std::vector<float>& phases, float intensity,
+                                               EffectScratch& scratch)
 {
     if (intensity <= 0.0f) return;
     
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    std::uniform_real_distribution<float> dis(-1.0f, 1.0f);
-    
     // Randomize phases (CDP-style spectral scrambling)
     for (size_t i = 0; i < phases.size(); ++i)
     {
-        float randomPhase = dis(gen) * juce::MathConstants<float>::pi;
+        float randomPhase = scratch.nextBipolar() * juce::MathConstants<float>::pi;
         phases[i] = phases[i] * (1.0f - intensity) + randomPhase * intensity;
     }
     
@@ -625,53 +893,50 @@ void CDPSpectralEngine::applySpectralRandomize(std::vector<float>& magnitudes, s
     {
         for (size_t i = 0; i < magnitudes.size(); ++i)
         {
-            float randomFactor = 1.0f + dis(gen) * magRandomization * 0.2f;
+            float randomFactor = 1.0f + scratch.nextBipolar() * magRandomization * 0.2f;
             magnitudes[i] *= randomFactor;
         }
     }
 }
 
-void CDPSpectralEngine::applySpectralShuffle(std::vector<float>& magnitudes, std::vector<float>& phases, float intensity)
+void CDPSpectralEngine::applySpectralShuffle(std::vector<float>& magnitudes, std::vector<float>& phases, float intensity,
+                                             EffectScratch& scratch)
 {
     if (intensity <= 0.0f) return;
     
     // CDP-style frequency bin shuffling
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    
-    // Create shuffled indices
-    std::vector<int> indices(magnitudes.size());
-    std::iota(indices.begin(), indices.end(), 0);
+    const int numBins = static_cast<int>(magnitudes.size());
+    int* indices = scratch.indices.data();
+    std::iota(indices, indices + numBins, 0);
     
     // Shuffle with intensity control
-    int shuffleAmount = static_cast<int>(intensity * magnitudes.size() * 0.5f);
+    int shuffleAmount = static_cast<int>(intensity * numBins * 0.5f);
     for (int i = 0; i < shuffleAmount; ++i)
     {
-        std::uniform_int_distribution<int> indexDis(0, static_cast<int>(magnitudes.size()) - 1);
-        int idx1 = indexDis(gen);
-        int idx2 = indexDis(gen);
+        int idx1 = static_cast<int>(scratch.rng.nextU32() % static_cast<uint32_t>(numBins));
+        int idx2 = static_cast<int>(scratch.rng.nextU32() % static_cast<uint32_t>(numBins));
         std::swap(indices[idx1], indices[idx2]);
     }
     
     // Apply shuffle
-    std::vector<float> shuffledMags(magnitudes.size());
-    std::vector<float> shuffledPhases(phases.size());
-    
-    for (size_t i = 0; i < magnitudes.size(); ++i)
+    float* shuffledMags = scratch.a.data();
+    float* shuffledPhases = scratch.b.data();
+    for (int i = 0; i < numBins; ++i)
     {
         shuffledMags[i] = magnitudes[indices[i]];
         shuffledPhases[i] = phases[indices[i]];
     }
     
     // Mix with original
-    for (size_t i = 0; i < magnitudes.size(); ++i)
+    for (int i = 0; i < numBins; ++i)
     {
         magnitudes[i] = magnitudes[i] * (1.0f - intensity) + shuffledMags[i] * intensity;
         phases[i] = phases[i] * (1.0f - intensity) + shuffledPhases[i] * intensity;
     }
 }
 
-void CDPSpectralEngine::applySpectralFreeze(std::vector<float>& magnitudes, std::vector<float>& phases, float intensity)
+void CDPSpectralEngine::applySpectralFreeze(std::vector<float>& magnitudes, std::vector<float>& phases, float intensity,
+                                            ChannelState& state)
 {
     if (intensity <= 0.0f) return;
     
@@ -684,40 +949,39 @@ void CDPSpectralEngine::applySpectralFreeze(std::vector<float>& magnitudes, std:
                          static_cast<int>(magnitudes.size()));
     
     // Store frozen spectrum on first frame or update
-    static bool freezeUpdated = false;
-    if (!freezeUpdated || intensity > 0.9f) // Update frozen spectrum when intensity is high
+    if (!state.freezeCaptured || intensity > 0.9f) // Update frozen spectrum when intensity is high
     {
-        if (!frozenSpectrum.empty() && !frozenSpectrum[0].empty())
+        if (!state.frozenSpectrum.empty() && !state.frozenSpectrum[0].empty())
         {
             for (int i = startBin; i < endBin; ++i)
             {
-                if (i < static_cast<int>(frozenSpectrum[0].size()))
-                    frozenSpectrum[0][i] = magnitudes[i];
+                if (i < static_cast<int>(state.frozenSpectrum[0].size()))
+                    state.frozenSpectrum[0][i] = magnitudes[i];
             }
         }
-        freezeUpdated = true;
+        state.freezeCaptured = true;
     }
     
     // Apply frozen spectrum
-    if (!frozenSpectrum.empty() && !frozenSpectrum[0].empty())
+    if (!state.frozenSpectrum.empty() && !state.frozenSpectrum[0].empty())
     {
         for (int i = startBin; i < endBin; ++i)
         {
-            if (i < static_cast<int>(magnitudes.size()) && i < static_cast<int>(frozenSpectrum[0].size()))
+            if (i < static_cast<int>(magnitudes.size()) && i < static_cast<int>(state.frozenSpectrum[0].size()))
             {
-                magnitudes[i] = magnitudes[i] * (1.0f - intensity) + frozenSpectrum[0][i] * intensity;
+                magnitudes[i] = magnitudes[i] * (1.0f - intensity) + state.frozenSpectrum[0][i] * intensity;
             }
         }
     }
 }
 
-void CDPSpectralEngine::applySpectralArpeggiate(std::vector<float>& magnitudes, std::vector<float>& phases, float rate, float intensity)
+void CDPSpectralEngine::applySpectralArpeggiate(std::vector<float>& magnitudes, std::vector<float>& phases, float rate, float intensity,
+                                                ChannelState& state)
 {
     if (intensity <= 0.0f) return;
     
     // CDP-style spectral arpeggiation - temporal sequencing of frequency bands
-    static int arpeggiateCounter = 0;
-    arpeggiateCounter++;
+    state.arpeggiateCounter++;
     
     // Calculate arpeggiate step based on rate and tempo
     double tempo = hostTempo.load();
@@ -726,7 +990,7 @@ void CDPSpectralEngine::applySpectralArpeggiate(std::vector<float>& magnitudes,
     
     if (stepSize <= 0) stepSize = 1;
     
-    int currentStep = (arpeggiateCounter / stepSize) % 8; // 8-step arpeggiator
+    int currentStep = (state.arpeggiateCounter / stepSize) % 8; // 8-step arpeggiator
     
     // Apply arpeggiation by emphasizing certain frequency bands
     int bandsPerStep = static_cast<int>(magnitudes.size()) / 8;
@@ -758,13 +1022,12 @@ void CDPSpectralEngine::applySpectralArpeggiate(std::vector<float>& magnitudes,
     }
 }
 
-void CDPSpectralEngine::applySpectralTimeExpand(std::vector<float>& magnitudes, std::vector<float>& phases, float factor)
+void CDPSpectralEngine::applySpectralTimeExpand(std::vector<float>& magnitudes, std::vector<float>& phases, float factor,
+                                                ChannelState& state)
 {
     // CDP-style time expansion using phase vocoder
     if (factor <= 0.0f) factor = 1.0f;
     
-    phaseVocoder->timeStretchRatio = factor;
-    
     // Update phase advances for time stretching
     int spectrumSize = static_cast<int>(phases.size());
     float fundamental = 2.0f * juce::MathConstants<float>::pi * currentFFTSize.load() / (4.0f * currentSampleRate);
@@ -772,7 +1035,7 @@ void CDPSpectralEngine::applySpectralTimeExpand(std::vector<float>& magnitudes,
     for (int i = 0; i < spectrumSize; ++i)
     {
         float expectedPhaseAdvance = fundamental * i;
-        float phaseDeviation = phases[i] - phaseVocoder->previousPhases[i] - expectedPhaseAdvance;
+        float phaseDeviation = phases[i] - state.previousPhases[i] - expectedPhaseAdvance;
         
         // Wrap phase deviation to [-π, π]
         while (phaseDeviation > juce::MathConstants<float>::pi) 
@@ -784,38 +1047,41 @@ void CDPSpectralEngine::applySpectralTimeExpand(std::vector<float>& magnitudes,
         float trueFreq = expectedPhaseAdvance + phaseDeviation;
         
         // Update phase for time stretching
-        phaseVocoder->phaseAdvances[i] += trueFreq / factor;
-        phases[i] = phaseVocoder->phaseAdvances[i];
+        state.phaseAdvances[i] += trueFreq / factor;
+        // Keep the accumulator wrapped so it never loses float precision
+        state.phaseAdvances[i] -= juce::MathConstants<float>::twoPi
+            * std::round(state.phaseAdvances[i] / juce::MathConstants<float>::twoPi);
+        phases[i] = state.phaseAdvances[i];
         
         // Store current phase for next frame
-        phaseVocoder->previousPhases[i] = phases[i];
+        state.previousPhases[i] = phases[i];
     }
 }
 
-void CDPSpectralEngine::applySpectralAverage(std::vector<float>& magnitudes, int windowSize)
+void CDPSpectralEngine::applySpectralAverage(std::vector<float>& magnitudes, int windowSize, ChannelState& state)
 {
     // CDP-style spectral averaging across time
-    if (windowSize <= 1 || spectralHistory.empty()) return;
+    if (windowSize <= 1 || state.spectralHistory.empty()) return;
     
-    // Add current frame to history
-    static int historyIndex = 0;
-    if (historyIndex < static_cast<int>(spectralHistory.size()))
+    // Add current frame to history (capacity is reserved, so no allocation)
+    if (state.historyIndex < static_cast<int>(state.spectralHistory.size()))
     {
-        spectralHistory[historyIndex] = magnitudes;
-        historyIndex = (historyIndex + 1) % spectralHistory.size();
+        state.spectralHistory[state.historyIndex] = magnitudes;
+        state.historyIndex = (state.historyIndex + 1) % static_cast<int>(state.spectralHistory.size());
     }
     
     // Calculate average
-    std::vector<float> averaged(magnitudes.size(), 0.0f);
-    int framesToAverage = std::min(windowSize, static_cast<int>(spectralHistory.size()));
+    float* averaged = state.scratch.a.data();
+    std::fill(averaged, averaged + magnitudes.size(), 0.0f);
+    int framesToAverage = std::min(windowSize, static_cast<int>(state.spectralHistory.size()));
     
     for (int frame = 0; frame < framesToAverage; ++frame)
     {
-        if (frame < static_cast<int>(spectralHistory.size()))
+        if (frame < static_cast<int>(state.spectralHistory.size()))
         {
-            for (size_t bin = 0; bin < magnitudes.size() && bin < spectralHistory[frame].size(); ++bin)
+            for (size_t bin = 0; bin < magnitudes.size() && bin < state.spectralHistory[frame].size(); ++bin)
             {
-                averaged[bin] += spectralHistory[frame][bin];
+                averaged[bin] += state.spectralHistory[frame][bin];
             }
         }
     }
@@ -858,27 +1124,29 @@ CDPSpectralEngine::SpectralEffect CDPSpectralEngine::hueToSpectralEffect(float h
 
 void CDPSpectralEngine::updateAdaptiveProcessing()
 {
-    if (currentProcessingMode.load() == ProcessingMode::Adaptive)
+    if (currentProcessingMode.load() != ProcessingMode::Adaptive)
+        return;
+    
+    // Only the overlap adapts: the FFT size sets the reported latency and is
+    // left to the user. Each step restarts overlap-add, so steps are spaced
+    // at least ADAPTIVE_DWELL_MS apart and the 0.4-0.8 band gives hysteresis.
+    const auto now = std::chrono::high_resolution_clock::now();
+    if (now < nextAdaptiveStep)
+        return;
+    
+    const float cpuUsage = processingStats.cpuUsage.load();
+    const float overlap = currentOverlapFactor.load();
+    
+    float target = overlap;
+    if (cpuUsage > 0.8f && overlap > 0.5f)          // High load: fewer frames per block
+        target = overlap - 0.125f;
+    else if (cpuUsage < 0.4f && overlap < 0.75f)    // Headroom: restore quality
+        target = overlap + 0.125f;
+    
+    if (target != overlap)
     {
-        // Monitor CPU usage and adjust processing parameters
-        float cpuUsage = processingStats.cpuUsage.load();
-        
-        if (cpuUsage > 0.8f) // High CPU usage
-        {
-            // Reduce quality for performance
-            if (currentFFTSize.load() > 512)
-                setFFTSize(currentFFTSize.load() / 2);
-            if (currentOverlapFactor.load() > 0.5f)
-                setOverlapFactor(currentOverlapFactor.load() - 0.125f);
-        }
-        else if (cpuUsage < 0.4f) // Low CPU usage
-        {
-            // Increase quality if we have headroom
-            if (currentFFTSize.load() < 2048)
-                setFFTSize(currentFFTSize.load() * 2);
-            if (currentOverlapFactor.load() < 0.75f)
-                setOverlapFactor(currentOverlapFactor.load() + 0.125f);
-        }
+        setOverlapFactor(target);
+        nextAdaptiveStep = now + std::chrono::milliseconds(ADAPTIVE_DWELL_MS);
     }
 }
 
@@ -904,43 +1172,48 @@ void CDPSpectralEngine::updateProcessingStats()
 
 void CDPSpectralEngine::storeSpectralFrame()
 {
+    if (channelStates.empty())
+        return;
+    
+    // The first channel stands in for the whole signal
+    const auto& state = channelStates[0];
     int index = spectralFrameIndex.load();
     
     SpectralFrame& frame = spectralFrameHistory[index];
-    frame.magnitudes = currentMagnitudes;
-    frame.phases = currentPhases;
-    frame.processedMags = processedMagnitudes;
+    frame.magnitudes = state.currentMagnitudes;
+    frame.phases = state.currentPhases;
+    frame.processedMags = state.processedMagnitudes;
     frame.timestamp = std::chrono::high_resolution_clock::now();
     
     // Calculate spectral features
-    if (!currentMagnitudes.empty())
+    if (!state.currentMagnitudes.empty())
     {
         // Spectral centroid
         float weightedSum = 0.0f;
         float magnitudeSum = 0.0f;
-        for (size_t i = 0; i < currentMagnitudes.size(); ++i)
+        for (size_t i = 0; i < state.currentMagnitudes.size(); ++i)
         {
-            weightedSum += i * currentMagnitudes[i];
-            magnitudeSum += currentMagnitudes[i];
+            weightedSum += i * state.currentMagnitudes[i];
+            magnitudeSum += state.currentMagnitudes[i];
         }
         frame.spectralCentroid = magnitudeSum > 0.0f ? weightedSum / magnitudeSum : 0.0f;
         
         // Spectral spread
         float variance = 0.0f;
-        for (size_t i = 0; i < currentMagnitudes.size(); ++i)
+        for (size_t i = 0; i < state.currentMagnitudes.size(); ++i)
         {
             float deviation = i - frame.spectralCentroid;
-            variance += deviation * deviation * currentMagnitudes[i];
+            variance += deviation * deviation * state.currentMagnitudes[i];
         }
         frame.spectralSpread = magnitudeSum > 0.0f ? std::sqrt(variance / magnitudeSum) : 0.0f;
         
         // Spectral entropy (simplified)
         float entropy = 0.0f;
-        for (size_t i = 0; i < currentMagnitudes.size(); ++i)
+        for (size_t i = 0; i < state.currentMagnitudes.size(); ++i)
         {
-            if (currentMagnitudes[i] > 0.0f)
+            if (state.currentMagnitudes[i] > 0.0f)
             {
-                float probability = currentMagnitudes[i] / magnitudeSum;
+                float probability = state.currentMagnitudes[i] / magnitudeSum;
                 entropy -= probability * std::log2(probability);
             }
         }
@@ -986,9 +1259,10 @@ void CDPSpectralEngine::setFFTSize(int fftSize)
     while (validSize < fftSize && validSize < 8192)
         validSize *= 2;
     
-    if (validSize >= 512 && validSize <= 4096)
+    if (validSize >= 512 && validSize <= MAX_FFT_SIZE && validSize != currentFFTSize.load())
     {
         currentFFTSize.store(validSize);
+        stftConfigDirty.store(true);
         DBG("🎨 FFT size set to: " << validSize);
     }
 }
@@ -996,14 +1270,15 @@ void CDPSpectralEngine::setFFTSize(int fftSize)
 void CDPSpectralEngine::setOverlapFactor(float overlap)
 {
     float validOverlap = juce::jlimit(0.25f, 0.875f, overlap);
-    currentOverlapFactor.store(validOverlap);
+    if (validOverlap != currentOverlapFactor.exchange(validOverlap))
+        stftConfigDirty.store(true);
     DBG("🎨 Overlap factor set to: " << validOverlap);
 }
 
 void CDPSpectralEngine::setWindowType(juce::dsp::WindowingFunction<float>::WindowingMethod windowType)
 {
-    currentWindowType = windowType;
-    windowFunction = std::make_unique<juce::dsp::WindowingFunction<float>>(currentFFTSize.load(), windowType);
+    if (windowType != currentWindowType.exchange(windowType))
+        stftConfigDirty.store(true);
     DBG("🎨 Window type set to: " << static_cast<int>(windowType));
 }
 
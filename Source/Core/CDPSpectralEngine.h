@@ -25,6 +25,10 @@
 #include <complex>
 #include <thread>
 #include <chrono>
+#include <functional>
+#include "../Spectral/STFTEngine.h"
+#include "../Util/Determinism.h"
+#include "SpectralWorkerPool.h"
 
 // Forward declarations
 class PerformanceProfiler;
@@ -75,6 +79,19 @@ public:
     void clearSpectralLayers();
     int getActiveLayerCount() const;
     
+    // Serial (default): each layer processes the previous layer's output.
+    // Parallel: every layer processes the same input and the mix-weighted
+    // changes are summed, so layers are independent and can run concurrently.
+    enum class LayerRouting { Serial, Parallel };
+    void setLayerRouting(LayerRouting routing) { layerRouting.store(routing); }
+    LayerRouting getLayerRouting() const { return layerRouting.load(); }
+    
+    // Realtime-priority workers that run independent layers and channels
+    // alongside the audio thread. Applied at the next prepareToPlay; 0 (the
+    // default) keeps all spectral work on the audio thread. Results do not
+    // depend on the worker count.
+    void setNumWorkerThreads(int numThreads) { numWorkerThreads = juce::jlimit(0, 16, numThreads); }
+    
     // Visual feedback support for MetaSynth-style canvas
     SpectralEffect getCurrentEffect() const { return currentEffect.load(); }
     float getCurrentIntensity() const { return currentIntensity.load(); }
@@ -105,7 +122,7 @@ public:
     {
         RealTime,       // Optimized for low latency (smaller FFT, less overlap)
         Quality,        // Optimized for audio quality (larger FFT, more overlap)
-        Adaptive        // Automatically adjusts based on current load
+        Adaptive        // Adjusts overlap to the current load; FFT size (latency) is kept
     };
     
     void setProcessingMode(ProcessingMode mode);
@@ -119,6 +136,12 @@ public:
     int getCurrentFFTSize() const { return currentFFTSize.load(); }
     float getCurrentOverlapFactor() const { return currentOverlapFactor.load(); }
     
+    // Processing delay in samples (one FFT frame). The owning AudioProcessor
+    // passes it to setLatencySamples(); the callback fires after prepareToPlay
+    // and whenever an FFT size change takes effect (from the processing thread).
+    int getLatencySamples() const noexcept { return latencySamples.load(); }
+    void setLatencyCallback(std::function<void(int)> callback) { latencyCallback = std::move(callback); }
+    
     //==============================================================================
     // Performance & Threading
     
@@ -203,42 +226,53 @@ private:
     //==============================================================================
     // Core Processing Engine
     
-    // Hybrid processing approach
-    std::unique_ptr<juce::dsp::FFT> forwardFFT;
-    std::unique_ptr<juce::dsp::FFT> inverseFFT;
-    std::unique_ptr<juce::dsp::WindowingFunction<float>> windowFunction;
+    // Analysis/resynthesis with per-channel input FIFOs and overlap-add state;
+    // frames fire whenever a hop of input has arrived, across host blocks.
+    // The audio thread owns `stft`. FFT size, overlap or window changes build a
+    // new engine on the processing thread and hand it over via pendingStft; the
+    // audio thread warms it up on inputHistory and crossfades to it over one
+    // block, then the replaced one comes back through retiredStft to be freed
+    // off the audio thread.
+    using STFTEngine = SpectralCanvas::spectral::STFTEngine;
+    using STFTConfig = SpectralCanvas::spectral::STFTConfig;
+    std::unique_ptr<STFTEngine> stft;
+    std::atomic<STFTEngine*> pendingStft{nullptr};
+    std::atomic<STFTEngine*> retiredStft{nullptr};
+    std::atomic<bool> stftConfigDirty{false};
+    STFTConfig builtStftConfig{1024, 256, 1};   // last configuration built (processing thread)
+    std::atomic<int> latencySamples{0};
+    std::function<void(int)> latencyCallback;
+    
+    juce::AudioBuffer<float> inputHistory;      // ring of the last MAX_FFT_SIZE input samples
+    int historyWritePos = 0;
+    juce::AudioBuffer<float> prerollInput, prerollOutput;
+    juce::AudioBuffer<float> crossfadeBuffer;   // outgoing STFT's output, one block
+    
+    STFTConfig makeStftConfig() const;
+    std::unique_ptr<STFTEngine> createStft(const STFTConfig& config);
+    void prerollStft(STFTEngine& engine, int numChannels) noexcept;
+    void publishLatency(int samples);
+    void setNumBins(int numBins) noexcept;
+    
+    static constexpr int MAX_FFT_SIZE = 4096;
+    static constexpr int MAX_BINS = MAX_FFT_SIZE / 2 + 1;
     
     // Phase-vocoder for time/pitch manipulation
     struct PhaseVocoder
     {
         std::vector<float> analysisWindow;
         std::vector<float> synthesisWindow;
-        std::vector<float> previousPhases;
-        std::vector<float> phaseAdvances;
         float timeStretchRatio = 1.0f;
         float pitchShiftRatio = 1.0f;
     };
     
     std::unique_ptr<PhaseVocoder> phaseVocoder;
     
-    //==============================================================================
-    // Spectral Processing Buffers
-    
-    // FFT processing buffers
-    std::vector<std::complex<float>> fftBuffer;
-    std::vector<float> windowedInput;
-    std::vector<float> overlapBuffer;
-    std::vector<float> outputBuffer;
-    
-    // Spectral data storage
-    std::vector<float> currentMagnitudes;
-    std::vector<float> currentPhases;
-    std::vector<float> processedMagnitudes;
-    std::vector<float> processedPhases;
-    
-    // Multi-frame storage for temporal effects
-    std::vector<std::vector<float>> spectralHistory;    // For averaging, morphing
-    std::vector<std::vector<float>> frozenSpectrum;     // For freeze effect
+    // Blur: radii of two cascaded box filters per quantised intensity step
+    static constexpr int BLUR_INTENSITY_STEPS = 64;
+    std::array<std::array<int, 2>, BLUR_INTENSITY_STEPS> blurBoxRadii{};
+    void buildBlurTables();
+    static void boxBlur(const float* src, float* dst, int numBins, int radius) noexcept;
     
     //==============================================================================
     // Real-time Threading System
@@ -272,7 +306,7 @@ private:
     std::atomic<ProcessingMode> currentProcessingMode{ProcessingMode::Adaptive};
     std::atomic<int> currentFFTSize{1024};
     std::atomic<float> currentOverlapFactor{0.75f};
-    juce::dsp::WindowingFunction<float>::WindowingMethod currentWindowType;
+    std::atomic<juce::dsp::WindowingFunction<float>::WindowingMethod> currentWindowType;
     
     double currentSampleRate = 44100.0;
     int currentSamplesPerBlock = 512;
@@ -299,8 +333,67 @@ private:
     static constexpr int MAX_EFFECT_LAYERS = 8;
     std::array<EffectLayer, MAX_EFFECT_LAYERS> effectLayers;
     std::atomic<int> activeLayerCount{0};
+    std::atomic<LayerRouting> layerRouting{LayerRouting::Serial};
     int maxConcurrentEffects = 4;
     
+    //==============================================================================
+    // Spectral Processing Buffers
+    
+    // Effect temporaries, sized to MAX_BINS up front so no kernel allocates on
+    // the audio thread. mags/phases follow the current bin count.
+    struct EffectScratch
+    {
+        std::vector<float> mags, phases;    // layer branch output, or the dry copy for serial layers
+        std::vector<float> a, b, blur;
+        std::vector<int> indices;
+        SpectralCanvas::Determinism::Lcg32 rng{0x9E3779B9u};
+        
+        void allocate(uint32_t seed);
+        float nextBipolar() noexcept { return rng.nextFloat01() * 2.0f - 1.0f; }
+    };
+    
+    // Everything a frame writes, per channel, so frames of different channels
+    // can run concurrently. Spectra are N/2 + 1 bins with MAX_BINS capacity.
+    // Phases are only computed for frames where an active effect needs them;
+    // see effectChainUsesPhase().
+    struct ChannelState
+    {
+        std::vector<float> currentMagnitudes;
+        std::vector<float> currentPhases;
+        std::vector<float> processedMagnitudes;
+        std::vector<float> processedPhases;
+        
+        // Multi-frame storage for temporal effects
+        std::vector<std::vector<float>> spectralHistory;    // For averaging, morphing
+        std::vector<std::vector<float>> frozenSpectrum;     // For freeze effect
+        std::vector<float> previousPhases;                  // Phase vocoder (TimeExpand)
+        std::vector<float> phaseAdvances;
+        
+        EffectScratch scratch;                              // Primary effect
+        std::array<EffectScratch, MAX_EFFECT_LAYERS> layerScratch;
+        
+        bool freezeCaptured = false;
+        int arpeggiateCounter = 0;
+        int historyIndex = 0;
+    };
+    
+    std::vector<ChannelState> channelStates;
+    void prepareChannelState(ChannelState& state, uint32_t seed);
+    
+    //==============================================================================
+    // Parallel Layers & Channels
+    
+    // Below this much work per batch (tasks x bins) waking workers costs more
+    // than it saves
+    static constexpr int PARALLEL_MIN_BINS = 4096;
+    
+    int numWorkerThreads = 0;
+    std::unique_ptr<SpectralWorkerPool> workerPool;
+    juce::int64 parallelWakeBudgetTicks = 0;
+    
+    bool shouldRunParallel(int numTasks, int binsPerTask) noexcept;
+    bool shouldParallelizeChannels(int numChannels) noexcept;
+    
     //==============================================================================
     // Tempo & Synchronization
     
@@ -318,6 +411,8 @@ private:
     
     ProcessingStats processingStats;
     std::chrono::high_resolution_clock::time_point lastProcessTime;
+    std::chrono::high_resolution_clock::time_point nextAdaptiveStep;   // processing thread only
+    static constexpr int ADAPTIVE_DWELL_MS = 1000;
     std::unique_ptr<PerformanceProfiler> performanceProfiler;
     
     //==============================================================================
@@ -354,17 +449,23 @@ private:
     //==============================================================================
     // Individual Effect Implementation Methods
     
-    void applySpectralBlur(std::vector<float>& magnitudes, float intensity);
-    void applySpectralRandomize(std::vector<float>& magnitudes, std::vector<float>& phases, float intensity);
-    void applySpectralShuffle(std::vector<float>& magnitudes, std::vector<float>& phases, float intensity);
-    void applySpectralFreeze(std::vector<float>& magnitudes, std::vector<float>& phases, float intensity);
-    void applySpectralArpeggiate(std::vector<float>& magnitudes, std::vector<float>& phases, float rate, float intensity);
-    void applySpectralTimeExpand(std::vector<float>& magnitudes, std::vector<float>& phases, float factor);
-    void applySpectralAverage(std::vector<float>& magnitudes, int windowSize);
+    void applySpectralBlur(std::vector<float>& magnitudes, float intensity, EffectScratch& scratch);
+    void applySpectralRandomize(std::vector<float>& magnitudes, std::vector<float>& phases, float intensity, EffectScratch& scratch);
+    void applySpectralShuffle(std::vector<float>& magnitudes, std::vector<float>& phases, float intensity, EffectScratch& scratch);
+    void applySpectralFreeze(std::vector<float>& magnitudes, std::vector<float>& phases, float intensity, ChannelState& state);
+    void applySpectralArpeggiate(std::vector<float>& magnitudes, std::vector<float>& phases, float rate, float intensity, ChannelState& state);
+    void applySpectralTimeExpand(std::vector<float>& magnitudes, std::vector<float>& phases, float factor, ChannelState& state);
+    void applySpectralAverage(std::vector<float>& magnitudes, int windowSize, ChannelState& state);
     void applySpectralMorph(std::vector<float>& magnitudes, const std::vector<float>& targetMags, float amount);
     
     // Core processing methods
-    void applyActiveSpectralEffects();
+    void processSpectrumFrame(ChannelState& state, float* bins, int numBins);
+    void applyActiveSpectralEffects(ChannelState& state, bool withPhases);
+    void applyLayerEffect(const EffectLayer& layer, std::vector<float>& magnitudes,
+                          std::vector<float>& phases, EffectScratch& scratch);
+    void applyParallelLayers(ChannelState& state, bool withPhases);
+    bool effectChainUsesPhase() const noexcept;
+    static bool effectUsesPhase(SpectralEffect effect) noexcept;
     
     // Utility methods
     void updateAdaptiveProcessing();
@@ -0,0 +1,152 @@
+/******************************************************************************
+ * File: CommandArena.h
+ * Description: Lock-free side storage for the rare commands that carry a path
+ *
+ * Commands are fixed 32-byte records so that dense paint traffic copies as
+ * little as possible through the command queue. The few commands that need
+ * a string (file paths, export targets) park it here and carry a 32-bit
+ * handle instead. Slots are claimed with a CAS by any producer thread and
+ * released by whoever consumes the command, so neither side ever locks or
+ * allocates. The queue's own release/acquire ordering publishes the bytes.
+ *
+ * Copyright (c) 2025 Spectral Audio Systems
+ ******************************************************************************/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <cstring>
+
+class CommandArena
+{
+public:
+    static constexpr int kNumSlots = 64;
+    static constexpr size_t kSlotBytes = 1024;
+
+    // 0 is never a valid handle. Low byte: slot + 1; upper bits: the slot's
+    // generation, so a handle that outlives its slot is caught in debug builds
+    using Handle = juce::uint32;
+
+    static CommandArena& getInstance() noexcept
+    {
+        static CommandArena arena;
+        return arena;
+    }
+
+    // Any thread. Copies numBytes into a free slot; returns 0 when the
+    // bytes do not fit or every slot is in use.
+    Handle store(const void* data, size_t numBytes) noexcept
+    {
+        const int index = numBytes <= kSlotBytes ? claimSlot() : -1;
+        if (index < 0)
+            return 0;
+
+        auto& slot = slots[(size_t) index];
+        if (numBytes > 0)
+            std::memcpy(slot.bytes.data(), data, numBytes);
+        return publish(index, numBytes);
+    }
+
+    // Stores a NUL-terminated string, truncated to fit a slot
+    Handle storeString(const char* text) noexcept
+    {
+        const int index = text != nullptr ? claimSlot() : -1;
+        if (index < 0)
+            return 0;
+
+        auto& slot = slots[(size_t) index];
+        const size_t length = juce::jmin(std::strlen(text), kSlotBytes - 1);
+        std::memcpy(slot.bytes.data(), text, length);
+        slot.bytes[length] = '\0';
+        return publish(index, length + 1);
+    }
+
+    // Consumer. Valid until the handle is released.
+    const void* getData(Handle handle, size_t& numBytes) const noexcept
+    {
+        if (const auto* slot = find(handle))
+        {
+            numBytes = slot->size;
+            return slot->bytes.data();
+        }
+
+        numBytes = 0;
+        return nullptr;
+    }
+
+    const char* getString(Handle handle) const noexcept
+    {
+        size_t numBytes = 0;
+        const auto* data = static_cast<const char*>(getData(handle, numBytes));
+        return numBytes > 0 ? data : "";
+    }
+
+    // Consumer, once the command is done with. Releasing 0 is a no-op.
+    void release(Handle handle) noexcept
+    {
+        if (const auto* slot = find(handle))
+            slots[(size_t) (slot - slots.data())].inUse.store(false, std::memory_order_release);
+    }
+
+    int getNumSlotsInUse() const noexcept
+    {
+        int inUse = 0;
+        for (const auto& slot : slots)
+            inUse += slot.inUse.load(std::memory_order_relaxed) ? 1 : 0;
+        return inUse;
+    }
+
+private:
+    static_assert((kNumSlots & (kNumSlots - 1)) == 0 && kNumSlots < 256, "slot index must fit the handle's low byte");
+
+    struct Slot
+    {
+        std::atomic<bool> inUse{false};
+        juce::uint32 generation = 0;
+        size_t size = 0;
+        std::array<char, kSlotBytes> bytes;
+    };
+
+    int claimSlot() noexcept
+    {
+        const auto first = nextSlot.fetch_add(1, std::memory_order_relaxed);
+        for (unsigned int i = 0; i < (unsigned int) kNumSlots; ++i)
+        {
+            const int index = (int) ((first + i) & (kNumSlots - 1));
+
+            bool expected = false;
+            if (slots[(size_t) index].inUse.compare_exchange_strong(expected, true, std::memory_order_acquire))
+                return index;
+        }
+
+        return -1;
+    }
+
+    Handle publish(int index, size_t numBytes) noexcept
+    {
+        auto& slot = slots[(size_t) index];
+        slot.size = numBytes;
+        ++slot.generation;
+        return (slot.generation << 8) | (Handle) (index + 1);
+    }
+
+    const Slot* find(Handle handle) const noexcept
+    {
+        const int index = (int) (handle & 0xff) - 1;
+        if (! juce::isPositiveAndBelow(index, kNumSlots))
+            return nullptr;
+
+        const auto& slot = slots[(size_t) index];
+        jassert(slot.inUse.load(std::memory_order_relaxed) && (slot.generation << 8) == (handle & ~0xffu));
+        return &slot;
+    }
+
+    CommandArena() = default;
+
+    std::array<Slot, kNumSlots> slots;
+    std::atomic<unsigned int> nextSlot{0};   // spreads claims so a scan rarely starts on a busy slot
+
+    JUCE_DECLARE_NON_COPYABLE(CommandArena)
+};
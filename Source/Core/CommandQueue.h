@@ -16,6 +16,11 @@
  * - Pre-allocated command buffer to avoid real-time memory allocation
  * - Overflow protection with statistics
  * - Performance monitoring
+ * - Batched, in-place dequeue: commands are handled straight from the ring,
+ *   one prepareToRead/finishedRead pair per batch
+ *
+ * The queue owns the CommandArena string of every command pushed to it: it
+ * is released after the command is processed, or at once if the push fails.
  */
 template <size_t Capacity = 256>
 class CommandQueue
@@ -64,6 +69,9 @@ public:
         else
         {
             // Queue is full or fragmented
+            if (cmd.hasStringParam())
+                CommandArena::getInstance().release(cmd.stringHandle);
+            
             overflowCount.fetch_add(1, std::memory_order_relaxed);
             return false;
         }
@@ -71,7 +79,8 @@ public:
     
     /**
      * Pop a command from the queue (called from audio thread)
-     * Returns true if a command was retrieved, false if queue is empty
+     * Returns true if a command was retrieved, false if queue is empty.
+     * The caller takes over the command's string and must release it.
      * 
      * RELIABILITY FIX: Removed race condition by eliminating pre-check.
      * Added memory barriers for guaranteed cross-thread visibility.
@@ -111,60 +120,22 @@ public:
      */
     int processAll(std::function<void(const Command&)> processor)
     {
-        int processed = 0;
-        Command cmd;
-        
-        while (pop(cmd))
-        {
-            processor(cmd);
-            processed++;
-        }
-        
-        // Update max batch size if necessary
-        if (processed > 0)
-        {
-            int currentMax = maxBatchSize.load(std::memory_order_relaxed);
-            while (processed > currentMax)
-            {
-                if (maxBatchSize.compare_exchange_weak(currentMax, processed,
-                                                      std::memory_order_relaxed))
-                {
-                    break;
-                }
-            }
-        }
-        
-        return processed;
+        return processBatches(processor, [] { return false; });
     }
     
     /**
      * Process commands with a time limit (called from audio thread)
-     * Returns the number of commands processed
+     * Returns the number of commands processed. Commands left when the time
+     * runs out stay queued for the next call.
      */
     int processWithTimeLimit(std::function<void(const Command&)> processor,
                            double maxProcessingTimeMs)
     {
-        auto startTime = juce::Time::getMillisecondCounterHiRes();
-        int processed = 0;
-        Command cmd;
-        
-        while (pop(cmd))
-        {
-            // Check time limit
-            auto elapsedTime = juce::Time::getMillisecondCounterHiRes() - startTime;
-            if (elapsedTime >= maxProcessingTimeMs)
-            {
-                // Put the command back (push to front)
-                // Note: This is not ideal but JUCE's AbstractFifo doesn't support push-front
-                // In practice, we should process all critical commands first
-                break;
-            }
-            
-            processor(cmd);
-            processed++;
-        }
+        const auto startTime = juce::Time::getMillisecondCounterHiRes();
         
-        return processed;
+        return processBatches(processor, [startTime, maxProcessingTimeMs] {
+            return juce::Time::getMillisecondCounterHiRes() - startTime >= maxProcessingTimeMs;
+        });
     }
     
     /**
@@ -172,7 +143,9 @@ public:
      */
     void clear()
     {
-        fifo.reset();
+        Command cmd;
+        while (pop(cmd))
+            cmd.releaseStringParam();
     }
     
     /**
@@ -230,6 +203,52 @@ public:
     }
     
 private:
+    static constexpr int batchSize = 32;    // one KB of commands per prepareToRead
+    
+    // Runs the processor on commands where they sit in the ring and hands
+    // each batch back with a single finishedRead. shouldStop is checked after
+    // every command, so at least one is processed and none are dropped.
+    template <typename StopCondition>
+    int processBatches(const std::function<void(const Command&)>& processor, StopCondition&& shouldStop)
+    {
+        int processed = 0;
+        bool stopped = false;
+        
+        while (! stopped)
+        {
+            int start1, size1, start2, size2;
+            fifo.prepareToRead(batchSize, start1, size1, start2, size2);
+            if (size1 + size2 == 0)
+                break;
+            
+            int done = 0;
+            for (int i = 0; i < size1 + size2 && ! stopped; ++i)
+            {
+                auto& cmd = buffer[(size_t) (i < size1 ? start1 + i : start2 + i - size1)];
+                processor(cmd);
+                cmd.releaseStringParam();
+                
+                ++done;
+                stopped = shouldStop();
+            }
+            
+            fifo.finishedRead(done);
+            processed += done;
+        }
+        
+        totalPopped.fetch_add((uint64_t) processed, std::memory_order_relaxed);
+        
+        // Update max batch size if necessary
+        int currentMax = maxBatchSize.load(std::memory_order_relaxed);
+        while (processed > currentMax)
+        {
+            if (maxBatchSize.compare_exchange_weak(currentMax, processed, std::memory_order_relaxed))
+                break;
+        }
+        
+        return processed;
+    }
+    
     // JUCE's thread-safe FIFO
     juce::AbstractFifo fifo;
     
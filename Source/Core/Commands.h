@@ -7,7 +7,7 @@
 #endif
 // ──────────────────────────────────────────────────────────────────────────────
 #include <JuceHeader.h>
-#include <cstring> // For strncpy
+#include "CommandArena.h"
 
 // Unique, project-scoped identifiers -----------------------------------------
 enum class ForgeCommandID
@@ -86,169 +86,130 @@ enum class RecordingCommandID
 };
 
 // FIFO message object ---------------------------------------------------------
+// A fixed 32-byte record: the queue copies it for every paint point, so it
+// carries no inline string. The rare path-carrying commands keep their text
+// in CommandArena and hold a handle in the slot paint commands use for the
+// colour; the queue releases it once the command has been processed.
 struct Command
 {
     // Command type - can be either ForgeCommandID or PaintCommandID
-    int commandId = static_cast<int>(ForgeCommandID::Test);
+    juce::int16    commandId = static_cast<juce::int16>(ForgeCommandID::Test);
+    bool           boolParam = false;    // flag / toggle
+    juce::uint8    flags = 0;            // hasString
     
     // Basic parameters
     int            intParam = -1;        // slot / index / mode
     float          floatParam = 0.0f;    // numeric value
-    double         doubleParam = 0.0;    // double precision value
-    bool           boolParam = false;    // flag / toggle
-    char           stringParam[256];     // path / text (fixed-size to avoid dynamic allocation)
+    float          floatParam2 = 0.0f;   // second value (height / range max)
+    
+    // Extended parameters for PaintEngine
+    float          x = 0.0f;             // Canvas X position
+    float          y = 0.0f;             // Canvas Y position
+    float          pressure = 1.0f;      // Brush pressure
+    union
+    {
+        juce::uint32           colourARGB = 0;   // Brush color
+        CommandArena::Handle   stringHandle;     // path / text, when hasStringParam()
+    };
+    
+    juce::Colour getColour() const noexcept { return juce::Colour(colourARGB); }
+    
+    static constexpr juce::uint8 hasStringFlag = 0x01;
     
-    // Helper method to safely set string parameter
+    // Stores the string in the arena. Paths longer than a slot are truncated;
+    // empty strings, or a full arena, leave the command without one.
     void setStringParam(const juce::String& str)
     {
-        const char* cStr = str.toUTF8();
-        strncpy_s(stringParam, sizeof(stringParam), cStr, _TRUNCATE);
+        setStringParam(str.toRawUTF8());
     }
     
     void setStringParam(const char* cStr)
     {
-        if (cStr != nullptr)
+        releaseStringParam();
+        if (cStr == nullptr || *cStr == '\0')
+            return;
+        
+        const auto handle = CommandArena::getInstance().storeString(cStr);
+        if (handle != 0)
         {
-            strncpy_s(stringParam, sizeof(stringParam), cStr, _TRUNCATE);
-        }
-        else
-        {
-            stringParam[0] = '\0'; // Empty string
+            stringHandle = handle;
+            flags |= hasStringFlag;
         }
     }
     
+    bool hasStringParam() const noexcept { return (flags & hasStringFlag) != 0; }
+    
     // Helper method to get string parameter as juce::String
     juce::String getStringParam() const
     {
-        return juce::String(stringParam);
+        return hasStringParam() ? juce::String::fromUTF8(CommandArena::getInstance().getString(stringHandle))
+                                : juce::String();
     }
     
-    // Extended parameters for PaintEngine
-    float          x = 0.0f;             // Canvas X position
-    float          y = 0.0f;             // Canvas Y position  
-    float          pressure = 1.0f;      // Brush pressure
-    juce::Colour   color;                // Brush color
-
-    // Constructors for Forge commands
-    Command()
+    // Called by whoever consumes the command (CommandQueue after processing,
+    // or the producer if the command is never queued)
+    void releaseStringParam() noexcept
     {
-        stringParam[0] = '\0'; // Initialize empty string
-    }
-    explicit Command(ForgeCommandID c) : commandId(static_cast<int>(c))
-    {
-        stringParam[0] = '\0';
-    }
-    Command(ForgeCommandID c, int s) : commandId(static_cast<int>(c)), intParam(s)
-    {
-        stringParam[0] = '\0';
-    }
-    Command(ForgeCommandID c, int s, float v) : commandId(static_cast<int>(c)), intParam(s), floatParam(v)
-    {
-        stringParam[0] = '\0';
-    }
-    Command(ForgeCommandID c, int s, bool  b) : commandId(static_cast<int>(c)), intParam(s), boolParam(b)
-    {
-        stringParam[0] = '\0';
+        if (hasStringParam())
+        {
+            CommandArena::getInstance().release(stringHandle);
+            flags &= static_cast<juce::uint8>(~hasStringFlag);
+            colourARGB = 0;
+        }
     }
-    Command(ForgeCommandID c, int s, const juce::String& p) : commandId(static_cast<int>(c)), intParam(s)
+
+    // Constructors for Forge commands
+    Command() = default;
+    explicit Command(ForgeCommandID c) : commandId(static_cast<juce::int16>(c)) {}
+    Command(ForgeCommandID c, int s) : commandId(static_cast<juce::int16>(c)), intParam(s) {}
+    Command(ForgeCommandID c, int s, float v) : commandId(static_cast<juce::int16>(c)), intParam(s), floatParam(v) {}
+    Command(ForgeCommandID c, int s, bool  b) : commandId(static_cast<juce::int16>(c)), boolParam(b), intParam(s) {}
+    Command(ForgeCommandID c, int s, const juce::String& p) : commandId(static_cast<juce::int16>(c)), intParam(s)
     {
         setStringParam(p);
     }
-    Command(ForgeCommandID c, float v) : commandId(static_cast<int>(c)), floatParam(v)
-    {
-        stringParam[0] = '\0';
-    }
-    Command(ForgeCommandID c, bool b) : commandId(static_cast<int>(c)), boolParam(b)
-    {
-        stringParam[0] = '\0';
-    }
-    Command(ForgeCommandID c, const juce::String& p) : commandId(static_cast<int>(c))
+    Command(ForgeCommandID c, float v) : commandId(static_cast<juce::int16>(c)), floatParam(v) {}
+    Command(ForgeCommandID c, bool b) : commandId(static_cast<juce::int16>(c)), boolParam(b) {}
+    Command(ForgeCommandID c, const juce::String& p) : commandId(static_cast<juce::int16>(c))
     {
         setStringParam(p);
     }
     
     // Constructors for SampleMasking commands
-    explicit Command(SampleMaskingCommandID c) : commandId(static_cast<int>(c))
-    {
-        stringParam[0] = '\0';
-    }
-    Command(SampleMaskingCommandID c, const juce::String& path) : commandId(static_cast<int>(c))
+    explicit Command(SampleMaskingCommandID c) : commandId(static_cast<juce::int16>(c)) {}
+    Command(SampleMaskingCommandID c, const juce::String& path) : commandId(static_cast<juce::int16>(c))
     {
         setStringParam(path);
     }
-    Command(SampleMaskingCommandID c, int id) : commandId(static_cast<int>(c)), intParam(id)
-    {
-        stringParam[0] = '\0';
-    }
-    Command(SampleMaskingCommandID c, float value) : commandId(static_cast<int>(c)), floatParam(value)
-    {
-        stringParam[0] = '\0';
-    }
-    Command(SampleMaskingCommandID c, bool value) : commandId(static_cast<int>(c)), boolParam(value)
-    {
-        stringParam[0] = '\0';
-    }
+    Command(SampleMaskingCommandID c, int id) : commandId(static_cast<juce::int16>(c)), intParam(id) {}
+    Command(SampleMaskingCommandID c, float value) : commandId(static_cast<juce::int16>(c)), floatParam(value) {}
+    Command(SampleMaskingCommandID c, bool value) : commandId(static_cast<juce::int16>(c)), boolParam(value) {}
     Command(SampleMaskingCommandID c, int id, float x_, float y_, float pressure_ = 1.0f)
-        : commandId(static_cast<int>(c)), intParam(id), x(x_), y(y_), pressure(pressure_)
-    {
-        stringParam[0] = '\0';
-    }
-    Command(SampleMaskingCommandID c, int id, int mode) : commandId(static_cast<int>(c)), intParam(id), floatParam(static_cast<float>(mode))
-    {
-        stringParam[0] = '\0';
-    }
+        : commandId(static_cast<juce::int16>(c)), intParam(id), x(x_), y(y_), pressure(pressure_) {}
+    Command(SampleMaskingCommandID c, int id, int mode)
+        : commandId(static_cast<juce::int16>(c)), intParam(id), floatParam(static_cast<float>(mode)) {}
     Command(SampleMaskingCommandID c, float width, float height)
-        : commandId(static_cast<int>(c)), floatParam(width), doubleParam(height)
-    {
-        stringParam[0] = '\0';
-    }
+        : commandId(static_cast<juce::int16>(c)), floatParam(width), floatParam2(height) {}
     Command(SampleMaskingCommandID c, float x_, float y_, float pressure_, juce::Colour color_)
-        : commandId(static_cast<int>(c)), x(x_), y(y_), pressure(pressure_), color(color_)
-    {
-        stringParam[0] = '\0';
-    }
+        : commandId(static_cast<juce::int16>(c)), x(x_), y(y_), pressure(pressure_), colourARGB(color_.getARGB()) {}
 
     // Constructors for Paint commands
-    explicit Command(PaintCommandID c) : commandId(static_cast<int>(c))
-    {
-        stringParam[0] = '\0';
-    }
+    explicit Command(PaintCommandID c) : commandId(static_cast<juce::int16>(c)) {}
     Command(PaintCommandID c, float x_, float y_, float pressure_ = 1.0f, juce::Colour color_ = juce::Colours::white)
-        : commandId(static_cast<int>(c)), x(x_), y(y_), pressure(pressure_), color(color_)
-    {
-        stringParam[0] = '\0';
-    }
+        : commandId(static_cast<juce::int16>(c)), x(x_), y(y_), pressure(pressure_), colourARGB(color_.getARGB()) {}
     Command(PaintCommandID c, float x_, float y_, float width, float height)
-        : commandId(static_cast<int>(c)), x(x_), y(y_), floatParam(width), doubleParam(height)
-    {
-        stringParam[0] = '\0';
-    }
-    Command(PaintCommandID c, float value) : commandId(static_cast<int>(c)), floatParam(value)
-    {
-        stringParam[0] = '\0';
-    }
-    Command(PaintCommandID c, bool value) : commandId(static_cast<int>(c)), boolParam(value)
-    {
-        stringParam[0] = '\0';
-    }
-    Command(PaintCommandID c, float min, float max) : commandId(static_cast<int>(c)), floatParam(min), doubleParam(max)
-    {
-        stringParam[0] = '\0';
-    }
+        : commandId(static_cast<juce::int16>(c)), floatParam(width), floatParam2(height), x(x_), y(y_) {}
+    Command(PaintCommandID c, float value) : commandId(static_cast<juce::int16>(c)), floatParam(value) {}
+    Command(PaintCommandID c, bool value) : commandId(static_cast<juce::int16>(c)), boolParam(value) {}
+    Command(PaintCommandID c, float min, float max) : commandId(static_cast<juce::int16>(c)), floatParam(min), floatParam2(max) {}
     
     // Constructors for Recording commands
-    explicit Command(RecordingCommandID c) : commandId(static_cast<int>(c))
-    {
-        stringParam[0] = '\0';
-    }
-    Command(RecordingCommandID c, const juce::String& path) : commandId(static_cast<int>(c))
+    explicit Command(RecordingCommandID c) : commandId(static_cast<juce::int16>(c)) {}
+    Command(RecordingCommandID c, const juce::String& path) : commandId(static_cast<juce::int16>(c))
     {
         setStringParam(path);
     }
-    Command(RecordingCommandID c, int format) : commandId(static_cast<int>(c)), intParam(format)
-    {
-        stringParam[0] = '\0';
-    }
+    Command(RecordingCommandID c, int format) : commandId(static_cast<juce::int16>(c)), intParam(format) {}
     
     // Helper methods to check command type
     bool isForgeCommand() const { return commandId < 100; }
@@ -259,4 +220,6 @@ struct Command
     SampleMaskingCommandID getSampleMaskingCommandID() const { return static_cast<SampleMaskingCommandID>(commandId); }
     PaintCommandID getPaintCommandID() const { return static_cast<PaintCommandID>(commandId); }
     RecordingCommandID getRecordingCommandID() const { return static_cast<RecordingCommandID>(commandId); }
-};
\ No newline at end of file
+};
+
+static_assert(sizeof(Command) == 32, "Command must stay a 32-byte record");
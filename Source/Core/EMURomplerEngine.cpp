@@ -1,8 +1,10 @@
 #include "EMURomplerEngine.h"
+#include "../dsp/InterpolationKernels.h"
+#include <cstring>
 
 //==============================================================================
-// EMU Rompler Engine - Stub Implementation
-// TODO: Implement full EMU Audity emulation
+// EMU Rompler Engine
+// TODO: Implement Audity vintage character processing
 //==============================================================================
 
 EMURomplerEngine::EMURomplerEngine()
@@ -10,11 +12,10 @@ EMURomplerEngine::EMURomplerEngine()
     // Initialize voice pool
     for (int i = 0; i < MAX_VOICES; ++i)
     {
-        voices[i] = std::make_unique<EMUVoice>();
+        voices[i] = std::make_unique<EMUVoice>(streamer);
     }
     
-    // Setup audio format manager
-    formatManager.registerBasicFormats();
+    sampleLibrary.reserve(SampleStreamer::kMaxSamples);
 }
 
 EMURomplerEngine::~EMURomplerEngine()
@@ -31,45 +32,104 @@ void EMURomplerEngine::prepareToPlay(double sampleRate, int samplesPerBlock, int
     currentBlockSize = samplesPerBlock;
     this->numChannels = numChannels;
     
-    // Prepare all voices
+    // Voices give their streams back before the stream pool is rebuilt
     for (auto& voice : voices)
     {
         if (voice)
+        {
+            voice->stopNote(false);
             voice->prepare(sampleRate, samplesPerBlock);
+        }
     }
+    sustainHeld = false;
+    
+    // Two streams per voice, so a retriggered voice never waits for its old
+    // stream to be recycled; each ring holds roughly 250ms of read-ahead
+    streamer.prepare(MAX_VOICES * 2, juce::nextPowerOfTwo(static_cast<int>(sampleRate / 4.0)));
+}
+
+void EMURomplerEngine::releaseResources()
+{
+    for (auto& voice : voices)
+    {
+        if (voice)
+            voice->stopNote(false);
+    }
+    
+    streamer.releaseResources();
 }
 
 void EMURomplerEngine::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
-    // Process MIDI events
+    buffer.clear();
+    
+    // Render up to each event before applying it, so a note lands on the
+    // sample it was sent for instead of the start of the block
+    const int numSamples = buffer.getNumSamples();
+    int position = 0;
+    
     for (const auto metadata : midiMessages)
     {
-        auto message = metadata.getMessage();
+        const int eventPosition = juce::jlimit(position, numSamples, metadata.samplePosition);
+        renderVoices(buffer, position, eventPosition - position);
+        position = eventPosition;
         
-        if (message.isNoteOn())
-        {
-            noteOn(message.getNoteNumber(), message.getFloatVelocity());
-        }
-        else if (message.isNoteOff())
-        {
-            noteOff(message.getNoteNumber());
-        }
+        handleMidiEvent(metadata.getMessage());
     }
     
-    // Clear buffer
-    buffer.clear();
+    renderVoices(buffer, position, numSamples - position);
+    
+    // Apply master volume
+    buffer.applyGain(masterVolume.load());
+    
+    int active = 0;
+    for (const auto& voice : voices)
+    {
+        if (voice && voice->isActive())
+            ++active;
+    }
+    activeVoiceCount.store(active, std::memory_order_relaxed);
+}
+
+void EMURomplerEngine::renderVoices(juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    if (numSamples <= 0)
+        return;
     
-    // Render all active voices
+    // Parameters are picked up per slice, so a pitch bend takes effect at its event
     for (auto& voice : voices)
     {
         if (voice && voice->isActive())
         {
-            voice->renderNextBlock(buffer, 0, buffer.getNumSamples());
+            applyVoiceParameters(*voice);
+            voice->renderNextBlock(buffer, startSample, numSamples);
         }
     }
-    
-    // Apply master volume
-    buffer.applyGain(masterVolume.load());
+}
+
+void EMURomplerEngine::handleMidiEvent(const juce::MidiMessage& message)
+{
+    if (message.isNoteOn())
+    {
+        noteOn(message.getNoteNumber(), message.getFloatVelocity());
+    }
+    else if (message.isNoteOff())
+    {
+        noteOff(message.getNoteNumber());
+    }
+    else if (message.isPitchWheel())
+    {
+        // Standard +/-2 semitone bend range
+        setPitchBend((message.getPitchWheelValue() - 8192) / 8192.0f * 2.0f);
+    }
+    else if (message.isSustainPedalOn() || message.isSustainPedalOff())
+    {
+        sustainPedal(message.isSustainPedalOn());
+    }
+    else if (message.isAllNotesOff() || message.isAllSoundOff())
+    {
+        allNotesOff();
+    }
 }
 
 //==============================================================================
@@ -77,32 +137,199 @@ void EMURomplerEngine::processBlock(juce::AudioBuffer<float>& buffer, juce::Midi
 
 void EMURomplerEngine::noteOn(int midiNote, float velocity, int voiceId)
 {
-    // RT-SAFE: Removed lock - using lock-free voice allocation
-    // TODO(RT-safety): Implement proper lock-free voice management
-    
     auto* voice = findFreeVoice();
-    if (voice && !sampleLibrary.empty())
+    const int sampleIndex = currentSampleIndex.load();
+    if (voice && sampleIndex < numLibrarySamples.load())
     {
-        voice->startNote(midiNote, velocity, sampleLibrary[currentSampleIndex.load()]);
+        applyVoiceParameters(*voice);
+        voice->startNote(midiNote, velocity, sampleLibrary[static_cast<size_t>(sampleIndex)]);
     }
 }
 
 void EMURomplerEngine::noteOff(int midiNote, int voiceId)
 {
-    juce::ScopedLock lock(voiceLock);
-    
     for (auto& voice : voices)
     {
         if (voice && voice->isPlayingNote(midiNote))
         {
+            // With the pedal down the voice keeps playing until it is lifted
+            if (sustainHeld)
+                voice->setHeldBySustain(true);
+            else
+                voice->stopNote(true);
+        }
+    }
+}
+
+void EMURomplerEngine::allNotesOff()
+{
+    for (auto& voice : voices)
+    {
+        if (voice && voice->isActive())
+            voice->stopNote(true);
+    }
+}
+
+void EMURomplerEngine::sustainPedal(bool isDown)
+{
+    sustainHeld = isDown;
+    if (isDown)
+        return;
+    
+    for (auto& voice : voices)
+    {
+        if (voice && voice->isActive() && voice->isHeldBySustain())
             voice->stopNote(true);
+    }
+}
+
+//==============================================================================
+// Sample Library
+
+void EMURomplerEngine::loadSampleLibrary(const juce::File& libraryDirectory)
+{
+    auto files = libraryDirectory.findChildFiles(juce::File::findFiles, true, "*.wav;*.aif;*.aiff;*.flac;*.ogg");
+    files.sort();
+    
+    static const juce::StringArray categoryNames { "Bass", "Leads", "Pads", "Strings",
+                                                   "Brass", "Drums", "Textures", "Effects" };
+    
+    for (const auto& file : files)
+    {
+        // Libraries are organised as one folder per category
+        const int category = categoryNames.indexOf(file.getParentDirectory().getFileName(), true);
+        
+        SampleInfo info;
+        info.name = file.getFileNameWithoutExtension();
+        info.category = category >= 0 ? static_cast<SampleCategory>(category) : SampleCategory::Textures;
+        info.sampleFile = file;
+        addSample(info);
+    }
+}
+
+bool EMURomplerEngine::addSample(const SampleInfo& sampleInfo)
+{
+    const juce::ScopedLock lock(libraryLock);
+    
+    if (numLibrarySamples.load() >= SampleStreamer::kMaxSamples)
+        return false;
+    
+    // Opens the file and preloads its head; the rest is streamed on demand
+    const int streamIndex = streamer.addSample(sampleInfo.sampleFile);
+    if (streamIndex < 0)
+        return false;
+    
+    sampleLibrary.push_back(sampleInfo);
+    sampleLibrary.back().streamIndex = streamIndex;
+    numLibrarySamples.store(static_cast<int>(sampleLibrary.size()));
+    return true;
+}
+
+void EMURomplerEngine::setCurrentSample(int sampleIndex)
+{
+    if (juce::isPositiveAndBelow(sampleIndex, numLibrarySamples.load()))
+        currentSampleIndex = sampleIndex;
+}
+
+void EMURomplerEngine::setCurrentSample(const juce::String& sampleName)
+{
+    const juce::ScopedLock lock(libraryLock);
+    
+    for (size_t i = 0; i < sampleLibrary.size(); ++i)
+    {
+        if (sampleLibrary[i].name == sampleName)
+        {
+            currentSampleIndex = static_cast<int>(i);
+            return;
         }
     }
 }
 
+juce::StringArray EMURomplerEngine::getSampleNames(SampleCategory category) const
+{
+    const juce::ScopedLock lock(libraryLock);
+    
+    juce::StringArray names;
+    for (const auto& info : sampleLibrary)
+    {
+        if (info.category == category)
+            names.add(info.name);
+    }
+    return names;
+}
+
+EMURomplerEngine::SampleInfo EMURomplerEngine::getCurrentSampleInfo() const
+{
+    const juce::ScopedLock lock(libraryLock);
+    
+    const int sampleIndex = currentSampleIndex.load();
+    return juce::isPositiveAndBelow(sampleIndex, static_cast<int>(sampleLibrary.size()))
+        ? sampleLibrary[static_cast<size_t>(sampleIndex)] : SampleInfo();
+}
+
 //==============================================================================
 // Parameter Control (Stub implementations)
 
+void EMURomplerEngine::setPitchBend(float semitones)
+{
+    pitchBend = juce::jlimit(-12.0f, 12.0f, semitones);
+}
+
+void EMURomplerEngine::setFineTune(float cents)
+{
+    fineTune = juce::jlimit(-100.0f, 100.0f, cents);
+}
+
+void EMURomplerEngine::setCoarseTune(int semitones)
+{
+    coarseTune = juce::jlimit(-24, 24, semitones);
+}
+
+void EMURomplerEngine::setFilterType(int type)
+{
+    globalFilterType = juce::jlimit(0, 3, type);
+}
+
+void EMURomplerEngine::setAttackTime(float timeSeconds)
+{
+    globalAttack = juce::jlimit(0.001f, 10.0f, timeSeconds);
+}
+
+void EMURomplerEngine::setDecayTime(float timeSeconds)
+{
+    globalDecay = juce::jlimit(0.001f, 10.0f, timeSeconds);
+}
+
+void EMURomplerEngine::setSustainLevel(float level)
+{
+    globalSustain = juce::jlimit(0.0f, 1.0f, level);
+}
+
+void EMURomplerEngine::setReleaseTime(float timeSeconds)
+{
+    globalRelease = juce::jlimit(0.001f, 10.0f, timeSeconds);
+}
+
+void EMURomplerEngine::setLFORate(float hz)
+{
+    globalLFORate = juce::jlimit(0.1f, 20.0f, hz);
+}
+
+void EMURomplerEngine::setLFODepth(float depth)
+{
+    globalLFODepth = juce::jlimit(0.0f, 1.0f, depth);
+}
+
+void EMURomplerEngine::setLFODestination(int dest)
+{
+    globalLFODestination = juce::jlimit(0, 2, dest);
+}
+
+void EMURomplerEngine::setLFOWaveform(int waveform)
+{
+    globalLFOWaveform = juce::jlimit(0, 3, waveform);
+}
+
 void EMURomplerEngine::setFilterCutoff(float cutoff)
 {
     globalFilterCutoff = juce::jlimit(0.0f, 1.0f, cutoff);
@@ -133,9 +360,36 @@ void EMURomplerEngine::setAnalogNoise(float amount)
     globalAnalogNoise = juce::jlimit(0.0f, 1.0f, amount);
 }
 
+void EMURomplerEngine::setMasterVolume(float volume)
+{
+    masterVolume = juce::jlimit(0.0f, 1.0f, volume);
+}
+
+//==============================================================================
+// Performance & Monitoring
+
+EMURomplerEngine::PerformanceInfo EMURomplerEngine::getPerformanceInfo() const
+{
+    PerformanceInfo info;
+    info.activeVoices = activeVoiceCount.load(std::memory_order_relaxed);
+    info.cpuUsagePercent = cpuUsage.load();
+    info.memoryUsageMB = static_cast<float>(streamer.getMemoryUsageBytes()) / (1024.0f * 1024.0f);
+    info.samplesCacheHits = cacheHits.load();
+    info.samplesCacheMisses = streamer.getUnderrunCount();
+    return info;
+}
+
 //==============================================================================
 // Helper Methods
 
+void EMURomplerEngine::applyVoiceParameters(EMUVoice& voice)
+{
+    voice.pitchWheelMoved(pitchBend.load() + static_cast<float>(coarseTune.load()) + fineTune.load() / 100.0f);
+    voice.setFilterParams(globalFilterCutoff.load(), globalFilterResonance.load(), globalFilterType.load());
+    voice.setEnvelopeParams(globalAttack.load(), globalDecay.load(), globalSustain.load(), globalRelease.load());
+    voice.setLFOParams(globalLFORate.load(), globalLFODepth.load(), globalLFODestination.load(), globalLFOWaveform.load());
+}
+
 EMURomplerEngine::EMUVoice* EMURomplerEngine::findFreeVoice()
 {
     for (auto& voice : voices)
@@ -157,9 +411,12 @@ EMURomplerEngine::EMUVoice* EMURomplerEngine::findVoicePlayingNote(int midiNote)
 }
 
 //==============================================================================
-// EMUVoice Implementation (Basic Stub)
+// EMUVoice Implementation
 
-EMURomplerEngine::EMUVoice::EMUVoice()
+EMURomplerEngine::EMUVoice::EMUVoice(SampleStreamer& sampleStreamer)
+    : streamer(sampleStreamer),
+      sourceWindow(2, WINDOW_SIZE),
+      renderBuffer(2, MAX_CHUNK)
 {
 }
 
@@ -181,32 +438,142 @@ bool EMURomplerEngine::EMUVoice::renderNextBlock(juce::AudioBuffer<float>& outpu
     if (!isActive())
         return false;
     
-    // Simple sine wave synthesis for testing
-    for (int sample = 0; sample < numSamples; ++sample)
+    auto* const* channels = output.getArrayOfWritePointers();
+    const int numOutputChannels = juce::jmin(output.getNumChannels(), CEM3389Filter::MAX_CHANNELS);
+    
+    for (int offset = 0; offset < numSamples; offset += MAX_CHUNK)
     {
-        float frequency = 440.0f * std::pow(2.0f, (currentMidiNote - 69) / 12.0f);
-        float sineValue = std::sin(currentSamplePosition * 2.0f * juce::MathConstants<float>::pi * frequency / static_cast<float>(sampleRate));
+        if (!renderChunk(channels, numOutputChannels, startSample + offset, juce::jmin(MAX_CHUNK, numSamples - offset)))
+            return false;
+    }
+    
+    return isActive();
+}
+
+bool EMURomplerEngine::EMUVoice::renderChunk(float* const* output, int numOutputChannels, int startSample, int numSamples)
+{
+    const int numSubBlocks = (numSamples + SUB_BLOCK_SIZE - 1) / SUB_BLOCK_SIZE;
+    
+    // Drop consumed frames, keeping one frame of history for the interpolator
+    const int keepFrom = static_cast<int>(windowPosition) - 1;
+    if (keepFrom > 0)
+    {
+        for (int channel = 0; channel < sourceChannels; ++channel)
+        {
+            auto* data = sourceWindow.getWritePointer(channel);
+            std::memmove(data, data + keepFrom, static_cast<size_t>(windowFill - keepFrom) * sizeof(float));
+        }
+        windowFill -= keepFrom;
+        windowSampleEnd -= keepFrom;
+        windowPosition -= keepFrom;
+    }
+    
+    // 1. Modulation at sub-block rate
+    double increments[MAX_SUB_BLOCKS];
+    float lfoValues[MAX_SUB_BLOCKS];
+    double lastPosition = windowPosition;
+    double position = windowPosition;
+    for (int sub = 0; sub < numSubBlocks; ++sub)
+    {
+        const int length = juce::jmin(SUB_BLOCK_SIZE, numSamples - sub * SUB_BLOCK_SIZE);
+        lfoValues[sub] = lfo.advance(length);
         
-        float envelope = amplifierEnvelope.getNextValue();
-        float outputSample = sineValue * envelope * currentVelocity * 0.3f;
+        double increment = noteIncrement * pitchOffsetRatio;
+        if (lfo.destination == 0 && lfo.depth > 0.0f)
+            increment *= std::exp2(lfoValues[sub] * (2.0 / 12.0));   // up to +-2 semitones of vibrato
         
-        for (int channel = 0; channel < output.getNumChannels(); ++channel)
+        increments[sub] = juce::jmin(increment, MAX_PITCH_RATIO);
+        lastPosition = position + (length - 1) * increments[sub];
+        position += length * increments[sub];
+    }
+    
+    // 2. Pull the source frames the interpolator will touch (frame floor + 2),
+    // and at least up to where the next chunk starts so none are skipped
+    const int needed = juce::jmax(static_cast<int>(lastPosition) + 3, static_cast<int>(position) + 1);
+    if (needed > windowFill)
+    {
+        const int count = needed - windowFill;
+        if (sourceEnded)
+        {
+            for (int channel = 0; channel < sourceChannels; ++channel)
+                juce::FloatVectorOperations::clear(sourceWindow.getWritePointer(channel, windowFill), count);
+        }
+        else
         {
-            output.addSample(channel, startSample + sample, outputSample);
+            float* destinations[2] = { sourceWindow.getWritePointer(0, windowFill), sourceWindow.getWritePointer(1, windowFill) };
+            const int frames = streamer.read(cursor, destinations, sourceChannels, count);
+            if (frames < count)
+            {
+                sourceEnded = true;
+                windowSampleEnd = windowFill + frames;
+            }
         }
+        windowFill = needed;
+    }
+    
+    // 3. Interpolate, filter and apply the gain ramp, one sub-block at a time
+    const float* sources[2] = { sourceWindow.getReadPointer(0), sourceWindow.getReadPointer(1) };
+    const int numRenderChannels = juce::jmin(sourceChannels, numOutputChannels);
+    
+    for (int sub = 0; sub < numSubBlocks; ++sub)
+    {
+        const int offset = sub * SUB_BLOCK_SIZE;
+        const int length = juce::jmin(SUB_BLOCK_SIZE, numSamples - offset);
+        const float lfoValue = lfoValues[sub];
         
-        currentSamplePosition += 1.0;
+        float* rendered[2] = { renderBuffer.getWritePointer(0, offset), renderBuffer.getWritePointer(1, offset) };
+        const double increment = increments[sub];
+        windowPosition = InterpolationKernels::hermite(sources, rendered, numRenderChannels, length, windowPosition, increment);
+        currentSamplePosition += length * increment;
         
-        // Stop voice if envelope is done
-        if (isReleasing && envelope < 0.001f)
+        const float cutoffOffset = lfo.destination == 1 ? lfoValue * 0.5f : 0.0f;
+        if (!filter.isBypassed(cutoffOffset))
         {
-            isPlaying = false;
-            isReleasing = false;
+            filter.updateCoefficients(cutoffOffset);
+            filter.process(rendered, numRenderChannels, length);
+        }
+        
+        float startGain = amplifierEnvelope.currentLevel;
+        float endGain = amplifierEnvelope.advance(length);
+        float amplitude = currentVelocity;
+        if (lfo.destination == 2)
+            amplitude *= 1.0f - 0.5f * lfo.depth + 0.5f * lfoValue;   // tremolo between 1 - depth and 1
+        startGain *= amplitude;
+        endGain *= amplitude;
+        
+        const float gainStep = (endGain - startGain) / static_cast<float>(length);
+        for (int channel = 0; channel < numOutputChannels; ++channel)
+        {
+            const float* in = rendered[juce::jmin(channel, numRenderChannels - 1)];
+            float* out = output[channel] + startSample + offset;
+            for (int i = 0; i < length; ++i)
+                out[i] += in[i] * (startGain + gainStep * static_cast<float>(i));
+        }
+        
+        // Release finished
+        if (amplifierEnvelope.currentStage == AMPLIFIERenvelope::Stage::Idle)
+        {
+            finishNote();
             return false;
         }
     }
     
-    return isActive();
+    // Everything up to the last frame's interpolation tail has been played
+    if (sourceEnded && windowPosition >= windowSampleEnd + 1)
+    {
+        finishNote();
+        return false;
+    }
+    
+    return true;
+}
+
+void EMURomplerEngine::EMUVoice::finishNote()
+{
+    isPlaying = false;
+    isReleasing = false;
+    isSustained = false;
+    streamer.stop(cursor);
 }
 
 void EMURomplerEngine::EMUVoice::startNote(int midiNote, float velocity, const SampleInfo& sample)
@@ -214,8 +581,34 @@ void EMURomplerEngine::EMUVoice::startNote(int midiNote, float velocity, const S
     currentMidiNote = midiNote;
     currentVelocity = velocity;
     currentSamplePosition = 0.0;
+    
+    // The head is already in RAM, so the note sounds immediately while the
+    // streamer starts reading the rest of the file in the background
+    if (!streamer.start(cursor, sample.streamIndex))
+        return;
+    
+    // Source frames per output sample: sample rate conversion, transposition
+    // from the root key and the sample's own tuning
+    const double sourceRate = streamer.getSampleRate(sample.streamIndex);
+    noteIncrement = sourceRate / sampleRate
+                  * std::exp2((midiNote - sample.rootNote) / 12.0)
+                  * (sample.baseTuning / 440.0);
+    sourceChannels = juce::jlimit(1, 2, streamer.getNumChannels(sample.streamIndex));
+    
+    // One frame of silence ahead of the sample gives the interpolator its history
+    for (int channel = 0; channel < sourceChannels; ++channel)
+        sourceWindow.setSample(channel, 0, 0.0f);
+    windowFill = 1;
+    windowPosition = 1.0;
+    windowSampleEnd = 0;
+    sourceEnded = false;
+    
+    filter.reset();
+    lfo.reset();
+    
     isPlaying = true;
     isReleasing = false;
+    isSustained = false;
     amplifierEnvelope.noteOn();
 }
 
@@ -224,36 +617,38 @@ void EMURomplerEngine::EMUVoice::stopNote(float allowTailOff)
     if (allowTailOff)
     {
         isReleasing = true;
+        isSustained = false;
         amplifierEnvelope.noteOff();
     }
     else
     {
-        isPlaying = false;
-        isReleasing = false;
+        finishNote();
     }
 }
 
-void EMURomplerEngine::EMUVoice::pitchWheelMoved(float newPitchWheelValue)
+void EMURomplerEngine::EMUVoice::pitchWheelMoved(float semitones)
 {
-    // Stub implementation
+    pitchOffsetRatio = std::exp2(semitones / 12.0);
 }
 
 void EMURomplerEngine::EMUVoice::setFilterParams(float cutoff, float resonance, int type)
 {
+    filter.type = type;
     filter.setParams(cutoff, resonance);
 }
 
 void EMURomplerEngine::EMUVoice::setEnvelopeParams(float attack, float decay, float sustain, float release)
 {
-    amplifierEnvelope.attackRate = attack;
-    amplifierEnvelope.decayRate = decay;
+    amplifierEnvelope.attackTime = attack;
+    amplifierEnvelope.decayTime = decay;
     amplifierEnvelope.sustainLevel = sustain;
-    amplifierEnvelope.releaseRate = release;
+    amplifierEnvelope.releaseTime = release;
 }
 
 void EMURomplerEngine::EMUVoice::setLFOParams(float rate, float depth, int destination, int waveform)
 {
-    lfo.setRate(rate);
+    if (rate != lfo.rate)
+        lfo.setRate(rate);
     lfo.depth = depth;
     lfo.destination = destination;
     lfo.waveform = waveform;
@@ -267,44 +662,73 @@ void EMURomplerEngine::EMUVoice::setVintageParams(float amount, int converterTyp
 //==============================================================================
 // Envelope Implementation
 
-float EMURomplerEngine::EMUVoice::AMPLIFIERenvelope::getNextValue()
+float EMURomplerEngine::EMUVoice::AMPLIFIERenvelope::advance(int numSamples)
 {
-    switch (currentStage)
+    // Linear segments; a stage that ends inside the block hands the rest of
+    // the block to the next one
+    auto remaining = static_cast<float>(numSamples);
+    const auto samplesFor = [this](float seconds) { return juce::jmax(1.0f, seconds * static_cast<float>(sampleRate)); };
+    
+    while (remaining > 0.0f)
     {
-        case Stage::Attack:
-            currentLevel += attackRate / static_cast<float>(sampleRate);
-            if (currentLevel >= 1.0f)
+        switch (currentStage)
+        {
+            case Stage::Attack:
             {
-                currentLevel = 1.0f;
-                currentStage = Stage::Decay;
+                const float step = 1.0f / samplesFor(attackTime);
+                const float needed = (1.0f - currentLevel) / step;
+                if (needed > remaining)
+                {
+                    currentLevel += step * remaining;
+                    remaining = 0.0f;
+                }
+                else
+                {
+                    currentLevel = 1.0f;
+                    remaining -= needed;
+                    currentStage = Stage::Decay;
+                }
+                break;
             }
-            break;
-            
-        case Stage::Decay:
-            currentLevel -= decayRate / static_cast<float>(sampleRate);
-            if (currentLevel <= sustainLevel)
+                
+            case Stage::Decay:
             {
-                currentLevel = sustainLevel;
-                currentStage = Stage::Sustain;
+                const float step = (1.0f - sustainLevel) / samplesFor(decayTime);
+                const float needed = step > 0.0f ? (currentLevel - sustainLevel) / step : 0.0f;
+                if (needed > remaining)
+                {
+                    currentLevel -= step * remaining;
+                    remaining = 0.0f;
+                }
+                else
+                {
+                    currentLevel = sustainLevel;
+                    remaining -= juce::jmax(0.0f, needed);
+                    currentStage = Stage::Sustain;
+                }
+                break;
             }
-            break;
-            
-        case Stage::Sustain:
-            currentLevel = sustainLevel;
-            break;
-            
-        case Stage::Release:
-            currentLevel -= releaseRate / static_cast<float>(sampleRate);
-            if (currentLevel <= 0.0f)
-            {
+                
+            case Stage::Sustain:
+                currentLevel = sustainLevel;
+                remaining = 0.0f;
+                break;
+                
+            case Stage::Release:
+                currentLevel -= releaseStep * remaining;
+                remaining = 0.0f;
+                if (currentLevel <= 0.0f)
+                {
+                    currentLevel = 0.0f;
+                    currentStage = Stage::Idle;
+                }
+                break;
+                
+            case Stage::Idle:
                 currentLevel = 0.0f;
-                currentStage = Stage::Idle;
-            }
-            break;
-            
-        case Stage::Idle:
-            currentLevel = 0.0f;
-            break;
+                remaining = 0.0f;
+                break;
+        }
     }
     
     return currentLevel;
@@ -318,15 +742,18 @@ void EMURomplerEngine::EMUVoice::AMPLIFIERenvelope::noteOn()
 
 void EMURomplerEngine::EMUVoice::AMPLIFIERenvelope::noteOff()
 {
+    // Release takes releaseTime from wherever the envelope is
+    releaseStep = juce::jmax(currentLevel, 1.0e-3f) / juce::jmax(1.0f, releaseTime * static_cast<float>(sampleRate));
     currentStage = Stage::Release;
 }
 
 //==============================================================================
-// Filter Stub Implementation
+// Filter Implementation
 
 void EMURomplerEngine::EMUVoice::CEM3389Filter::setSampleRate(double sr)
 {
     sampleRate = sr;
+    lastCutoff = -1.0f;
 }
 
 void EMURomplerEngine::EMUVoice::CEM3389Filter::setParams(float newCutoff, float newResonance)
@@ -335,10 +762,76 @@ void EMURomplerEngine::EMUVoice::CEM3389Filter::setParams(float newCutoff, float
     resonance = newResonance;
 }
 
-float EMURomplerEngine::EMUVoice::CEM3389Filter::process(float input)
+void EMURomplerEngine::EMUVoice::CEM3389Filter::reset()
 {
-    // Simple lowpass filter for now
-    return input; // TODO: Implement CEM3389 filter
+    for (int channel = 0; channel < MAX_CHANNELS; ++channel)
+    {
+        stage1[channel].ic1eq = stage1[channel].ic2eq = 0.0f;
+        stage2[channel].ic1eq = stage2[channel].ic2eq = 0.0f;
+    }
+}
+
+void EMURomplerEngine::EMUVoice::CEM3389Filter::updateCoefficients(float cutoffOffset)
+{
+    const float effectiveCutoff = juce::jlimit(0.0f, 1.0f, cutoff + cutoffOffset);
+    if (effectiveCutoff == lastCutoff && resonance == lastResonance)
+        return;
+    
+    lastCutoff = effectiveCutoff;
+    lastResonance = resonance;
+    
+    // 20Hz-20kHz, exponential, kept clear of Nyquist
+    frequencyHz = juce::jmin(20.0f * std::pow(1000.0f, effectiveCutoff), 0.45f * static_cast<float>(sampleRate));
+    const float g = std::tan(juce::MathConstants<float>::pi * frequencyHz / static_cast<float>(sampleRate));
+    
+    // Butterworth 4-pole at zero resonance; resonance sharpens the second
+    // stage towards (but never into) self-oscillation
+    const float k1 = 1.8478f;
+    const float k2 = 0.7654f * (1.0f - 0.96f * resonance);
+    
+    const auto setCoefficients = [g](SVFStage& stage, float k)
+    {
+        stage.k = k;
+        stage.a1 = 1.0f / (1.0f + g * (g + k));
+        stage.a2 = g * stage.a1;
+        stage.a3 = g * stage.a2;
+    };
+    
+    for (int channel = 0; channel < MAX_CHANNELS; ++channel)
+    {
+        setCoefficients(stage1[channel], k1);
+        setCoefficients(stage2[channel], k2);
+    }
+}
+
+void EMURomplerEngine::EMUVoice::CEM3389Filter::process(float* const* data, int numChannels, int numSamples)
+{
+    const auto tick = [this](SVFStage& s, float x)
+    {
+        const float v3 = x - s.ic2eq;
+        const float v1 = s.a1 * s.ic1eq + s.a2 * v3;
+        const float v2 = s.ic2eq + s.a2 * s.ic1eq + s.a3 * v3;
+        s.ic1eq = 2.0f * v1 - s.ic1eq;
+        s.ic2eq = 2.0f * v2 - s.ic2eq;
+        
+        switch (type)
+        {
+            case 1:  return x - s.k * v1 - v2;  // high-pass
+            case 2:  return v1;                 // band-pass
+            case 3:  return x - s.k * v1;       // notch
+            default: return v2;                 // low-pass
+        }
+    };
+    
+    for (int channel = 0; channel < juce::jmin(numChannels, MAX_CHANNELS); ++channel)
+    {
+        float* samples = data[channel];
+        auto& first = stage1[channel];
+        auto& second = stage2[channel];
+        
+        for (int i = 0; i < numSamples; ++i)
+            samples[i] = tick(second, tick(first, samples[i]));
+    }
 }
 
 //==============================================================================
@@ -356,13 +849,23 @@ void EMURomplerEngine::EMUVoice::LFO::setRate(float hz)
     phaseIncrement = static_cast<float>(hz * 2.0 * juce::MathConstants<double>::pi / sampleRate);
 }
 
-float EMURomplerEngine::EMUVoice::LFO::getNextValue()
+float EMURomplerEngine::EMUVoice::LFO::advance(int numSamples)
 {
-    float value = std::sin(phase) * depth;
-    phase += phaseIncrement;
-    if (phase >= 2.0f * juce::MathConstants<float>::pi)
-        phase -= 2.0f * juce::MathConstants<float>::pi;
-    return value;
+    constexpr float twoPi = juce::MathConstants<float>::twoPi;
+    const float cycle = phase / twoPi;
+    
+    float value;
+    switch (waveform)
+    {
+        case 1:  value = cycle < 0.5f ? 4.0f * cycle - 1.0f : 3.0f - 4.0f * cycle;  break;   // Triangle
+        case 2:  value = cycle < 0.5f ? 1.0f : -1.0f;                               break;   // Square
+        case 3:  value = 2.0f * cycle - 1.0f;                                       break;   // Saw
+        default: value = std::sin(phase);                                           break;   // Sine
+    }
+    
+    phase += phaseIncrement * static_cast<float>(numSamples);
+    phase -= twoPi * std::floor(phase / twoPi);
+    return value * depth;
 }
 
 //==============================================================================
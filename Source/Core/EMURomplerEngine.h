@@ -1,8 +1,8 @@
 #pragma once
 #include <JuceHeader.h>
+#include "SampleStreamer.h"
 #include <memory>
 #include <atomic>
-#include <unordered_map>
 
 /**
  * EMU Rompler Engine - "Vintage Vault"
@@ -54,6 +54,7 @@ public:
         bool hasVelocityLayers = false;
         int numVelocityLayers = 1;
         juce::File sampleFile;
+        int streamIndex = -1;  // SampleStreamer index, set by addSample()
         
         // EMU-specific properties
         bool useEMUFilter = true;
@@ -62,19 +63,24 @@ public:
         bool useVintageCharacter = true;
     };
     
-    // Sample library management
+    // Sample library management (message thread). Samples are streamed from
+    // disk; only their first few milliseconds are held in RAM, so libraries
+    // of any size load quickly and program changes are instant.
     void loadSampleLibrary(const juce::File& libraryDirectory);
-    void addSample(const SampleInfo& sampleInfo);
+    bool addSample(const SampleInfo& sampleInfo);
     void setCurrentSample(int sampleIndex);
     void setCurrentSample(const juce::String& sampleName);
+    void setPreloadTime(int milliseconds) { streamer.setPreloadTime(milliseconds); }
     
     juce::StringArray getSampleNames(SampleCategory category = SampleCategory::Bass) const;
     SampleInfo getCurrentSampleInfo() const;
-    int getNumSamples() const { return static_cast<int>(sampleLibrary.size()); }
+    int getNumSamples() const { return numLibrarySamples.load(); }
     
     //==============================================================================
     // Voice Management & Synthesis
     
+    // Audio thread only: processBlock calls these at each event's sample
+    // position. Voice state is owned by the audio thread, so none of them lock.
     void noteOn(int midiNote, float velocity, int voiceId = -1);
     void noteOff(int midiNote, int voiceId = -1);
     void allNotesOff();
@@ -150,7 +156,7 @@ private:
     class EMUVoice
     {
     public:
-        EMUVoice();
+        explicit EMUVoice(SampleStreamer& streamer);
         ~EMUVoice();
         
         void prepare(double sampleRate, int samplesPerBlock);
@@ -158,10 +164,12 @@ private:
         
         void startNote(int midiNote, float velocity, const SampleInfo& sample);
         void stopNote(float allowTailOff);
-        void pitchWheelMoved(float newPitchWheelValue);
+        void pitchWheelMoved(float semitones);      // bend plus coarse/fine tune
         
         bool isActive() const { return isPlaying || isReleasing; }
-        bool isPlayingNote(int midiNote) const { return currentMidiNote == midiNote && isPlaying; }
+        bool isPlayingNote(int midiNote) const { return currentMidiNote == midiNote && isPlaying && !isReleasing && !isSustained; }
+        bool isHeldBySustain() const { return isSustained; }
+        void setHeldBySustain(bool held) { isSustained = held; }
         
         // Parameter control
         void setFilterParams(float cutoff, float resonance, int type);
@@ -170,37 +178,64 @@ private:
         void setVintageParams(float amount, int converterType, float noiseAmount);
         
     private:
-        // Voice state
-        std::atomic<bool> isPlaying{false};
-        std::atomic<bool> isReleasing{false};
+        // Voice state (audio thread only)
+        bool isPlaying = false;
+        bool isReleasing = false;
+        bool isSustained = false;                   // key released while the pedal was down
         int currentMidiNote = -1;
         float currentVelocity = 0.0f;
         
-        // Sample playback
-        std::unique_ptr<juce::AudioFormatReader> sampleReader;
-        double currentSamplePosition = 0.0;
+        // Modulation, filter coefficients and pitch are updated once per
+        // sub-block; only interpolation, filtering and the gain ramp run
+        // per sample. Host blocks are rendered in chunks of at most
+        // MAX_CHUNK samples so the source window has a fixed size.
+        static constexpr int SUB_BLOCK_SIZE = 32;
+        static constexpr int MAX_CHUNK = 512;
+        static constexpr int MAX_SUB_BLOCKS = MAX_CHUNK / SUB_BLOCK_SIZE;
+        static constexpr double MAX_PITCH_RATIO = 8.0;
+        static constexpr int WINDOW_SIZE = static_cast<int>(MAX_CHUNK * MAX_PITCH_RATIO) + 8;
+        
+        bool renderChunk(float* const* output, int numOutputChannels, int startSample, int numSamples);
+        void finishNote();
+        
+        // Sample playback: frames pulled from the streamer into a window that
+        // keeps one frame of history for the interpolator
+        SampleStreamer& streamer;
+        SampleStreamer::Cursor cursor;
+        juce::AudioBuffer<float> sourceWindow;
+        juce::AudioBuffer<float> renderBuffer;
+        int windowFill = 0;                 // valid frames in sourceWindow
+        int windowSampleEnd = 0;            // window index where the sample ends, once read
+        bool sourceEnded = false;
+        int sourceChannels = 2;
+        double windowPosition = 0.0;        // read position within sourceWindow
+        double currentSamplePosition = 0.0; // read position within the sample
         double sampleRate = 44100.0;
-        float pitchRatio = 1.0f;
+        double noteIncrement = 1.0;         // source frames per output sample at zero pitch offset
+        double pitchOffsetRatio = 1.0;
         
         // Synthesis components
         struct AMPLIFIERenvelope
         {
-            float attackRate = 0.01f;
-            float decayRate = 0.1f; 
+            float attackTime = 0.01f;       // seconds
+            float decayTime = 0.1f;
             float sustainLevel = 0.7f;
-            float releaseRate = 0.3f;
+            float releaseTime = 0.3f;
             
             enum class Stage { Attack, Decay, Sustain, Release, Idle };
             Stage currentStage = Stage::Idle;
             float currentLevel = 0.0f;
             
-            float getNextValue();
+            // Advances numSamples samples and returns the new level (the
+            // voice ramps its gain linearly between successive calls)
+            float advance(int numSamples);
             void noteOn();
             void noteOff();
             void setSampleRate(double sr) { sampleRate = sr; }
             
         private:
             double sampleRate = 44100.0;
+            float releaseStep = 0.0f;
         } amplifierEnvelope;
         
         // Authentic CEM3389 4-pole resonant filter emulation
@@ -208,19 +243,20 @@ private:
         {
             float cutoff = 1.0f;           // 0.0-1.0 normalized cutoff
             float resonance = 0.0f;        // 0.0-1.0 resonance amount
+            int type = 0;                  // 0=LPF, 1=HPF, 2=BPF, 3=Notch
             
             // 4-pole (24dB/octave) implementation using cascaded SVF stages
+            // (trapezoidal integration, so it stays stable under modulation)
             struct SVFStage
             {
-                float low = 0.0f;
-                float band = 0.0f;
-                float high = 0.0f;
-                float notch = 0.0f;
-                float f = 0.0f;    // frequency coefficient
-                float fb = 0.0f;   // feedback coefficient
+                float ic1eq = 0.0f;  // integrator states
+                float ic2eq = 0.0f;
+                float k = 2.0f;      // damping, 1/Q
+                float a1 = 0.0f, a2 = 0.0f, a3 = 0.0f;
             };
             
-            SVFStage stage1, stage2;  // Two 2-pole stages = 4-pole total
+            static constexpr int MAX_CHANNELS = 2;
+            SVFStage stage1[MAX_CHANNELS], stage2[MAX_CHANNELS];  // Two 2-pole stages = 4-pole total
             
             // CEM3389-specific characteristics
             float selfOscLevel = 0.0f;           // Self-oscillation amplitude
@@ -239,7 +275,14 @@ private:
             
             void setSampleRate(double sr);
             void setParams(float newCutoff, float newResonance);
-            float process(float input);
+            void reset();
+            
+            // Fully open low-pass: nothing to do
+            bool isBypassed(float cutoffOffset) const { return type == 0 && cutoff + cutoffOffset >= 0.999f && resonance < 0.001f; }
+            
+            // Sub-block rate: recomputes coefficients for cutoff + cutoffOffset
+            void updateCoefficients(float cutoffOffset);
+            void process(float* const* data, int numChannels, int numSamples);
             
             // CEM3389-specific methods
             void updateAnalogDrift();            // Simulate analog component drift
@@ -265,7 +308,10 @@ private:
             
             void setSampleRate(double sr);
             void setRate(float hz);
-            float getNextValue();
+            void reset() { phase = 0.0f; }
+            
+            // Current value (scaled by depth), then moves on numSamples samples
+            float advance(int numSamples);
             
         private:
             double sampleRate = 44100.0;
@@ -323,31 +369,31 @@ private:
     //==============================================================================
     // Engine Implementation
     
+    // Sample streaming (declared before the voices, which hold a reference)
+    SampleStreamer streamer;
+    
     // Voice management
     static constexpr int MAX_VOICES = 64;
     std::array<std::unique_ptr<EMUVoice>, MAX_VOICES> voices;
     std::atomic<int> maxPolyphony{32};
     
     EMUVoice* findFreeVoice();
+    void applyVoiceParameters(EMUVoice& voice);
     EMUVoice* findVoicePlayingNote(int midiNote);
     void killQuietestVoice();  // Voice stealing
     
-    // Sample library
+    // Block slicing: voices are rendered up to each MIDI event, then the
+    // event is applied, so notes start and stop on their own sample
+    void renderVoices(juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
+    void handleMidiEvent(const juce::MidiMessage& message);
+    bool sustainHeld = false;                       // audio thread only
+    std::atomic<int> activeVoiceCount{0};           // published once per block
+    
+    // Sample library: reserved to SampleStreamer::kMaxSamples so entries never
+    // move; the audio thread only reads the first numLibrarySamples of them
     std::vector<SampleInfo> sampleLibrary;
+    std::atomic<int> numLibrarySamples{0};
     std::atomic<int> currentSampleIndex{0};
-    juce::AudioFormatManager formatManager;
-    
-    // Sample caching system
-    struct CacheEntry
-    {
-        std::unique_ptr<juce::AudioBuffer<float>> buffer;
-        juce::uint32 lastAccessTime;
-        bool isLoaded = false;
-    };
-    
-    static constexpr int MAX_CACHE_SIZE = 50; // Number of samples to keep in memory
-    std::unordered_map<int, CacheEntry> sampleCache;
-    void manageSampleCache();
     
     // Audio processing state
     double currentSampleRate = 44100.0;
@@ -390,9 +436,8 @@ private:
     std::atomic<int> cacheMisses{0};
     juce::Time lastProcessTime;
     
-    // Thread safety
-    juce::CriticalSection voiceLock;
-    juce::CriticalSection cacheLock;
+    // Thread safety (library edits only; the note path never locks)
+    juce::CriticalSection libraryLock;
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EMURomplerEngine)
 };
\ No newline at end of file
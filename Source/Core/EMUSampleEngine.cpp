@@ -25,6 +25,7 @@ void EMUSampleVoice::startNote(int midiNote, float velocity, const juce::AudioSa
     currentVelocity = velocity;
     currentSample = sample;
     samplePosition = 0.0;
+    loopWrapped = false;
     
     // Calculate playback rate based on MIDI note (assuming sample is C4 = 60)
     const float baseMidiNote = 60.0f;
@@ -62,7 +63,13 @@ void EMUSampleVoice::renderNextBlock(juce::AudioSampleBuffer& outputBuffer, int
         return;
         
     const int sampleLength = currentSample->getNumSamples();
-    const int numChannels = juce::jmin(outputBuffer.getNumChannels(), currentSample->getNumChannels());
+    const int numChannels = juce::jmin(outputBuffer.getNumChannels(), currentSample->getNumChannels(),
+                                       SampleResampler::kMaxChannels);
+    // Loop points past the sample's end are clamped to it
+    const int loopEndClamped = juce::jmin(loopEnd, sampleLength);
+    const bool looping = loopEnabled && loopEndClamped > loopStart;
+    const double loopLength = (double) (loopEndClamped - loopStart);
+    float frame[SampleResampler::kMaxChannels];
     
     for (int sample = 0; sample < numSamples; ++sample)
     {
@@ -81,39 +88,30 @@ void EMUSampleVoice::renderNextBlock(juce::AudioSampleBuffer& outputBuffer, int
             envelope = juce::jmin(1.0f, envelope + envelopeRate);
         }
         
-        // Check if we've reached the end
-        int currentPos = (int)samplePosition;
-        if (currentPos >= sampleLength)
+        // Jump back by whole loop lengths at the loop end, keeping the
+        // fractional overshoot so the loop period stays exact
+        if (looping && samplePosition >= loopEndClamped)
         {
-            if (loopEnabled && loopEnd > loopStart)
-            {
-                samplePosition = loopStart;
-                currentPos = loopStart;
-            }
-            else
-            {
-                active.store(false);
-                return;
-            }
+            samplePosition = loopStart + std::fmod(samplePosition - loopStart, loopLength);
+            loopWrapped = true;
+        }
+        else if (samplePosition >= sampleLength)
+        {
+            active.store(false);
+            return;
         }
         
-        // Simple linear interpolation
-        float frac = samplePosition - currentPos;
-        int nextPos = juce::jmin(currentPos + 1, sampleLength - 1);
+        // Interpolate all channels of this frame together; a looping voice's
+        // kernel reads across the seam within the loop region, while the
+        // attack before loopStart plays as recorded
+        const SampleResampler::Loop loop { looping ? loopStart : 0, looping ? loopEndClamped : 0, loopWrapped };
+        resampler.readFrame(*currentSample, samplePosition, playbackRate, loop, frame, numChannels);
+        const float gain = envelope * amplitudeModulation * currentVelocity; // Velocity scaling
         
         for (int ch = 0; ch < numChannels; ++ch)
         {
-            float sample1 = currentSample->getSample(ch, currentPos);
-            float sample2 = currentSample->getSample(ch, nextPos);
-            float interpolatedSample = sample1 + frac * (sample2 - sample1);
-            
-            // Apply modulation
-            interpolatedSample *= envelope;
-            interpolatedSample *= amplitudeModulation;
-            interpolatedSample *= currentVelocity; // Velocity scaling
-            
             // Add to output buffer
-            outputBuffer.addSample(ch, startSample + sample, interpolatedSample);
+            outputBuffer.addSample(ch, startSample + sample, frame[ch] * gain);
         }
         
         // Advance sample position
@@ -318,73 +316,93 @@ void EMUSampleEngine::processBlock(juce::AudioSampleBuffer& buffer, juce::MidiBu
     // Clear the buffer
     buffer.clear();
     
-    // Process MIDI messages
+    // Render up to each event before applying it, so notes start and stop
+    // on the sample they were sent for rather than at the block start
+    const int numSamples = buffer.getNumSamples();
+    int position = 0;
+    
     for (const auto metadata : midiMessages)
     {
-        auto message = metadata.getMessage();
+        const int eventPosition = juce::jlimit(position, numSamples, metadata.samplePosition);
+        renderVoices(buffer, position, eventPosition - position);
+        position = eventPosition;
         
-        if (message.isNoteOn())
+        handleMidiEvent(metadata.getMessage());
+    }
+    
+    renderVoices(buffer, position, numSamples - position);
+    
+    // Apply master volume
+    buffer.applyGain(masterVolume);
+    
+    // Update voice count
+    updateVoiceCount();
+    
+    // Calculate CPU usage
+    auto endTime = juce::Time::getHighResolutionTicks();
+    auto elapsed = juce::Time::highResolutionTicksToSeconds(endTime - startTime);
+    auto blockDuration = buffer.getNumSamples() / currentSampleRate;
+    cpuUsage.store((float)(elapsed / blockDuration));
+}
+
+void EMUSampleEngine::renderVoices(juce::AudioSampleBuffer& buffer, int startSample, int numSamples)
+{
+    if (numSamples <= 0)
+        return;
+    
+    for (auto& voice : voices)
+    {
+        if (voice.isActive())
         {
-            int note = message.getNoteNumber();
-            float velocity = message.getFloatVelocity();
-            
-            // Map note to sample slot (simple mapping for now)
-            int slotIndex = mapPaintToSampleSlot((float)note / 127.0f);
-            
-            if (slotIndex < NUM_SAMPLE_SLOTS && sampleSlots[slotIndex].hasSample())
-            {
-                auto* voice = findFreeVoice();
-                if (voice)
-                {
-                    const auto* sample = sampleSlots[slotIndex].getVelocityLayer((int)(velocity * 127));
-                    voice->startNote(note, velocity, sample);
-                }
-            }
+            voice.renderNextBlock(buffer, startSample, numSamples);
         }
-        else if (message.isNoteOff())
+    }
+}
+
+void EMUSampleEngine::handleMidiEvent(const juce::MidiMessage& message)
+{
+    if (message.isNoteOn())
+    {
+        int note = message.getNoteNumber();
+        float velocity = message.getFloatVelocity();
+        
+        // Map note to sample slot (simple mapping for now)
+        int slotIndex = mapPaintToSampleSlot((float)note / 127.0f);
+        
+        if (slotIndex < NUM_SAMPLE_SLOTS && sampleSlots[slotIndex].hasSample())
         {
-            int note = message.getNoteNumber();
-            auto* voice = findVoiceForNote(note);
+            auto* voice = findFreeVoice();
             if (voice)
             {
-                voice->stopNote(true);
+                const auto* sample = sampleSlots[slotIndex].getVelocityLayer((int)(velocity * 127));
+                voice->startNote(note, velocity, sample);
             }
         }
-        else if (message.isPitchWheel())
+    }
+    else if (message.isNoteOff())
+    {
+        // Every voice holding this key, not just the first
+        for (auto& voice : voices)
         {
-            float pitchBend = (message.getPitchWheelValue() - 8192) / 8192.0f * pitchBendRange;
-            
-            // Apply pitch bend to all active voices
-            for (auto& voice : voices)
+            if (voice.isPlayingNote(message.getNoteNumber()))
             {
-                if (voice.isActive())
-                {
-                    voice.setPitch(pitchBend);
-                }
+                voice.stopNote(true);
             }
         }
     }
-    
-    // Render all active voices
-    for (auto& voice : voices)
+    else if (message.isPitchWheel())
     {
-        if (voice.isActive())
+        float pitchBend = (message.getPitchWheelValue() - 8192) / 8192.0f * pitchBendRange;
+        
+        // Apply pitch bend to all active voices
+        for (auto& voice : voices)
         {
-            voice.renderNextBlock(buffer, 0, buffer.getNumSamples());
+            if (voice.isActive())
+            {
+                voice.setPitch(pitchBend);
+            }
         }
     }
-    
-    // Apply master volume
-    buffer.applyGain(masterVolume);
-    
-    // Update voice count
-    updateVoiceCount();
-    
-    // Calculate CPU usage
-    auto endTime = juce::Time::getHighResolutionTicks();
-    auto elapsed = juce::Time::highResolutionTicksToSeconds(endTime - startTime);
-    auto blockDuration = buffer.getNumSamples() / currentSampleRate;
-    cpuUsage.store((float)(elapsed / blockDuration));
 }
 
 void EMUSampleEngine::releaseResources()
@@ -449,6 +467,14 @@ void EMUSampleEngine::setPolyphony(int maxVoices)
     maxPolyphony = juce::jlimit(1, MAX_VOICES, maxVoices);
 }
 
+void EMUSampleEngine::setResamplerQuality(SampleResampler::Quality quality)
+{
+    for (auto& voice : voices)
+    {
+        voice.setResamplerQuality(quality);
+    }
+}
+
 void EMUSampleEngine::handlePaintStroke(float x, float y, float pressure, juce::Colour color, bool isStart)
 {
     if (isStart)
@@ -557,11 +583,9 @@ EMUSampleVoice* EMUSampleEngine::findFreeVoice()
 
 EMUSampleVoice* EMUSampleEngine::findVoiceForNote(int midiNote)
 {
-    // For now, just return the first active voice
-    // In a full implementation, we'd track note assignments properly
     for (auto& voice : voices)
     {
-        if (voice.isActive())
+        if (voice.isPlayingNote(midiNote))
             return &voice;
     }
     return nullptr;
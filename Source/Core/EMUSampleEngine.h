@@ -6,6 +6,7 @@
 
 #pragma once
 #include <JuceHeader.h>
+#include "../dsp/SampleResampler.h"
 #include <memory>
 #include <vector>
 #include <array>
@@ -24,6 +25,7 @@ public:
     void startNote(int midiNote, float velocity, const juce::AudioSampleBuffer* sample);
     void stopNote(bool allowTailOff);
     bool isActive() const { return active.load(); }
+    bool isPlayingNote(int midiNote) const { return isActive() && !isReleasing && currentNote == midiNote; }
     void renderNextBlock(juce::AudioSampleBuffer& outputBuffer, int startSample, int numSamples);
     
     // EMU-style parameters
@@ -33,6 +35,7 @@ public:
     void setLoopMode(bool enabled);
     void setLoopPoints(int start, int end);
     void setVelocityLayer(int layer);            // 0-3 velocity layers
+    void setResamplerQuality(SampleResampler::Quality quality) { resampler.setQuality(quality); }
     
     // Modulation inputs (from paint canvas and EMU controls)
     void modulatePitch(float modulation);        // Real-time pitch modulation
@@ -49,6 +52,8 @@ private:
     const juce::AudioSampleBuffer* currentSample = nullptr;
     double samplePosition = 0.0;
     double playbackRate = 1.0;
+    bool loopWrapped = false;                // passed loopEnd at least once this note
+    SampleResampler resampler{ SampleResampler::Quality::Hermite };   // cheap enough for full polyphony
     
     // EMU parameters
     float transpose = 0.0f;
@@ -159,6 +164,7 @@ public:
     void setMasterTuning(float cents);           // -100 to +100 cents
     void setPitchBendRange(int semitones);       // 1-12 semitones
     void setPolyphony(int maxVoices);            // 1-64 voices
+    void setResamplerQuality(SampleResampler::Quality quality); // all voices
     
     // Paint canvas integration
     void handlePaintStroke(float x, float y, float pressure, juce::Colour color, bool isStart);
@@ -212,6 +218,8 @@ private:
     // Internal methods
     EMUSampleVoice* findFreeVoice();
     EMUSampleVoice* findVoiceForNote(int midiNote);
+    void renderVoices(juce::AudioSampleBuffer& buffer, int startSample, int numSamples);
+    void handleMidiEvent(const juce::MidiMessage& message);
     void updateVoiceCount();
     int mapPaintToSampleSlot(float x) const;
     float mapPaintToPitch(float y) const;
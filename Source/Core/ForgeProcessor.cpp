@@ -55,6 +55,19 @@ void ForgeProcessor::loadSampleIntoSlot(int slotIdx, const juce::File& file)
     }
 }
 
+//------------------------------------------------------------------------------
+void ForgeProcessor::adoptSampleIntoSlot(int slotIdx, juce::AudioBuffer<float>& buffer, juce::String& name,
+                                         std::vector<SpectralMask::SpectralFrame>& maskFrames) noexcept
+{
+    if (slotIdx < 0 || slotIdx >= (int)voices.size())
+        return;
+
+    voices[(size_t)slotIdx].adoptSample(buffer, name, maskFrames, 120.0);
+
+    // AUDIO FIX: Auto-start playback for immediate beatmaker feedback
+    voices[(size_t)slotIdx].start();
+}
+
 //------------------------------------------------------------------------------
 ForgeVoice& ForgeProcessor::getVoice(int index)
 {
@@ -18,6 +18,10 @@ public:
 
     // commands
     void loadSampleIntoSlot(int slotIdx, const juce::File& file);
+    // Audio thread: installs a sample decoded by SampleLoader and starts the
+    // slot; buffer, name and maskFrames come back holding the slot's previous sample
+    void adoptSampleIntoSlot(int slotIdx, juce::AudioBuffer<float>& buffer, juce::String& name,
+                             std::vector<SpectralMask::SpectralFrame>& maskFrames) noexcept;
     ForgeVoice& getVoice(int index);
     void        setHostBPM(double bpm);
     
@@ -35,6 +35,20 @@ void ForgeVoice::setSample(juce::AudioBuffer<float>&& newBuffer, double original
     }
 }
 
+void ForgeVoice::adoptSample(juce::AudioBuffer<float>& newBuffer, juce::String& name,
+                             std::vector<SpectralMask::SpectralFrame>& maskFrames, double originalBPM) noexcept
+{
+    std::swap(buffer, newBuffer);
+    sampleName.swapWith(name);
+    this->originalBPM = originalBPM;
+    reset();
+
+    // Keep the mask in step with the sample even while masking is switched
+    // off; without a mask, enableSpectralMask() analyses the buffer itself
+    if (spectralMask)
+        spectralMask->swapAnalysis(maskFrames);
+}
+
 void ForgeVoice::process(juce::AudioBuffer<float>& output, int startSample, int numSamples)
 {
     // AUDIO DEBUG: Log voice activity (occasionally)
@@ -55,42 +69,33 @@ void ForgeVoice::process(juce::AudioBuffer<float>& output, int startSample, int
     pitchSmooth.setTargetValue(pitch);
     volumeSmooth.setTargetValue(volume);
 
-    const int numChannels = juce::jmin(output.getNumChannels(), buffer.getNumChannels());
+    const int numChannels = juce::jmin(output.getNumChannels(), buffer.getNumChannels(), SampleResampler::kMaxChannels);
+    const double length = static_cast<double>(buffer.getNumSamples());
+    float frame[SampleResampler::kMaxChannels];
 
     for (int sample = 0; sample < numSamples; ++sample)
     {
         // Update playback rate for this sample
         updatePlaybackRate();
+        const double increment = playbackRate * pitchSmooth.getNextValue();
 
-        // Get interpolated sample
-        const int pos = static_cast<int>(position);
-        const float frac = static_cast<float>(position - pos);
+        // Read every channel of this frame at once; the sample loops
+        resampler.readFrame(buffer, position, increment, true, frame, numChannels);
+        const float gain = volumeSmooth.getNextValue();
 
         for (int ch = 0; ch < numChannels; ++ch)
         {
-            if (pos < buffer.getNumSamples() - 1)
-            {
-                const float* channelData = buffer.getReadPointer(ch % buffer.getNumChannels());
-                float sampleValue = channelData[pos] * (1.0f - frac) + channelData[pos + 1] * frac;
-
-                // Apply processing
-                sampleValue = processSample(sampleValue);
-
-                // Apply volume with smoothing
-                sampleValue *= volumeSmooth.getNextValue();
-
-                // Write to output
-                output.addSample(ch, startSample + sample, sampleValue);
-            }
+            // Apply processing, then volume with smoothing
+            output.addSample(ch, startSample + sample, processSample(frame[ch]) * gain);
         }
 
         // Advance position
-        position += playbackRate * pitchSmooth.getNextValue();
+        position += increment;
 
         // Handle loop/stop
-        if (position >= buffer.getNumSamples())
+        if (position >= length)
         {
-            position = 0.0;
+            position = std::fmod(position, length);
             // For now, just loop. Later we can add one-shot mode
         }
     }
@@ -7,9 +7,8 @@
 #include <juce_gui_basics/juce_gui_basics.h>
 #include <juce_dsp/juce_dsp.h>
 #include <memory>
-
-// Forward declaration
-class SpectralMask;
+#include "../dsp/SampleResampler.h"
+#include "SpectralMask.h"
 
 class ForgeVoice
 {
@@ -18,6 +17,11 @@ public:
 
     void prepare(double sampleRate, int blockSize);
     void setSample(juce::AudioBuffer<float>&& newBuffer, double originalBPM = 120.0);
+    // Audio thread: swaps in a sample decoded off-thread together with its
+    // spectral-mask analysis (see SampleLoader::decode); newBuffer, name and
+    // maskFrames come back holding the previous sample. No allocation.
+    void adoptSample(juce::AudioBuffer<float>& newBuffer, juce::String& name,
+                     std::vector<SpectralMask::SpectralFrame>& maskFrames, double originalBPM = 120.0) noexcept;
     void process(juce::AudioBuffer<float>& output, int startSample, int numSamples);
 
     // Control
@@ -34,6 +38,7 @@ public:
     void setVolume(float vol) { volume = vol; }
     void setDrive(float drv) { drive = juce::jlimit(1.0f, 10.0f, drv); }
     void setCrush(float bits) { crushBits = juce::jlimit(1.0f, 16.0f, bits); }
+    void setResamplerQuality(SampleResampler::Quality quality) { resampler.setQuality(quality); }
 
     // Info
     juce::String getSampleName() const { return sampleName; }
@@ -71,6 +76,7 @@ private:
     double sampleRate = 44100.0;
 
     // DSP
+    SampleResampler resampler{ SampleResampler::Quality::Sinc16 };
     juce::dsp::Oversampling<float> oversampling{ 2, 2, juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR };
     juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> pitchSmooth;
     juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> volumeSmooth;
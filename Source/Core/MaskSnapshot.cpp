@@ -1,15 +1,25 @@
 #include "MaskSnapshot.h"
 
+namespace
+{
+    inline bool isActiveValue(float value) noexcept { return std::abs(value - 1.0f) > 0.001f; }
+}
+
+const std::shared_ptr<const MaskSnapshot::MaskTile>& MaskSnapshot::blankTile()
+{
+    static const std::shared_ptr<const MaskTile> blank = std::make_shared<const MaskTile>();
+    return blank;
+}
+
 MaskSnapshot::MaskSnapshot()
 {
     // Allocate buffers on construction (not in RT thread)
     workBuffer = std::make_unique<MaskData>();
-    pendingBuffer = std::make_unique<MaskData>();
-    audioBuffer1 = std::make_unique<MaskData>();
-    audioBuffer2 = std::make_unique<MaskData>();
+    for (auto& buffer : publishBuffers)
+        buffer = std::make_unique<MaskData>();
     
-    // Initialize with buffer1 as current snapshot
-    currentSnapshot.store(audioBuffer1.get(), std::memory_order_release);
+    // Audio thread starts on buffer 0, the GUI fills buffer 1, buffer 2 is spare
+    currentSnapshot.store(publishBuffers[(size_t) readIndex].get(), std::memory_order_release);
     
     DBG("MaskSnapshot initialized with " << MASK_WIDTH << "x" << MASK_HEIGHT << " resolution");
 }
@@ -37,9 +47,139 @@ void MaskSnapshot::prepareToPlay(double sampleRate, int samplesPerBlock)
     };
     
     initializeBuffer(workBuffer.get());
-    initializeBuffer(pendingBuffer.get());
-    initializeBuffer(audioBuffer1.get());
-    initializeBuffer(audioBuffer2.get());
+    for (auto& buffer : publishBuffers)
+        initializeBuffer(buffer.get());
+    
+    // The frequency range depends on the sample rate, so remap existing bins
+    if (binRowMap.fftSize > 0)
+        prepareBinMapping(binRowMap.fftSize, sampleRate);
+}
+
+void MaskSnapshot::prepareBinMapping(int fftSize, double sampleRate)
+{
+    const int numBins = juce::jmax(0, fftSize / 2 + 1);
+    binRowMap.fftSize = fftSize;
+    binRowMap.sampleRate = sampleRate;
+    binRowMap.rows.assign((size_t) numBins, 0);
+    binRowMap.fractions.assign((size_t) numBins, 0.0f);
+    
+    // Same logarithmic mapping as frequencyToY(), computed exactly once per bin
+    const double minFreq = workBuffer ? workBuffer->minFreq : 20.0;
+    const double maxFreq = workBuffer ? workBuffer->maxFreq : sampleRate / 3.0;
+    const double logRange = std::log2(maxFreq / minFreq);
+    
+    for (int bin = 0; bin < numBins; ++bin)
+    {
+        const double frequency = bin * sampleRate / fftSize;
+        double y = 0.0;
+        if (frequency >= maxFreq)
+            y = MASK_HEIGHT - 1;
+        else if (frequency > minFreq)
+            y = std::log2(frequency / minFreq) / logRange * (MASK_HEIGHT - 1);
+        
+        const int row = juce::jlimit(0, MASK_HEIGHT - 1, int(y));
+        binRowMap.rows[(size_t) bin] = row;
+        binRowMap.fractions[(size_t) bin] = float(y - row);
+    }
+}
+
+void MaskSnapshot::extractColumnRows(float timeNorm, const MaskData& snapshot, float* column) const noexcept
+{
+    // Blend the two mask columns either side of x for every row, one tile
+    // column at a time; column[MASK_HEIGHT] repeats the top row so per-bin
+    // interpolation never needs a bounds check
+    const float x = timeToX(timeNorm);
+    const int x0 = int(x);
+    const int x1 = juce::jmin(x0 + 1, MASK_WIDTH - 1);
+    const float fx = x - float(x0);
+    
+    for (int tileY = 0; tileY < TILES_Y; ++tileY)
+    {
+        const float* tile0 = snapshot.tiles[(size_t) (tileY * TILES_X + x0 / TILE_SIZE)]->values + x0 % TILE_SIZE;
+        const float* tile1 = snapshot.tiles[(size_t) (tileY * TILES_X + x1 / TILE_SIZE)]->values + x1 % TILE_SIZE;
+        float* out = column + tileY * TILE_SIZE;
+        
+        for (int row = 0; row < TILE_SIZE; ++row)
+        {
+            const float v0 = tile0[row * TILE_SIZE];
+            out[row] = v0 + fx * (tile1[row * TILE_SIZE] - v0);
+        }
+    }
+    column[MASK_HEIGHT] = column[MASK_HEIGHT - 1];
+}
+
+void MaskSnapshot::computeBinGains(const float* column, int firstBin, int numBins, float* gains) const noexcept
+{
+    const int* rows = binRowMap.rows.data() + firstBin;
+    const float* fractions = binRowMap.fractions.data() + firstBin;
+    
+    for (int i = 0; i < numBins; ++i)
+    {
+        const float v0 = column[rows[i]];
+        gains[i] = v0 + fractions[i] * (column[rows[i] + 1] - v0);
+    }
+    
+    // Branch-free form of sampleMask()'s threshold feather, strength and blend
+    const float thresh = threshold.load(std::memory_order_acquire);
+    const float strength = maskStrength.load(std::memory_order_acquire);
+    const float blend = maskBlend.load(std::memory_order_acquire);
+    const float invFeatherRange = 1.0f / 0.1f;
+    
+    for (int i = 0; i < numBins; ++i)
+    {
+        const float v = gains[i];
+        const float above = std::max(v - thresh, 0.0f);
+        const float feathered = std::min(v, thresh) + std::min(above * invFeatherRange, 1.0f) * above;
+        const float shaped = std::min(std::max(feathered * strength, 0.0f), 1.0f);
+        gains[i] = std::min(std::max((1.0f - blend) + blend * shaped, 0.0f), 1.0f);
+    }
+}
+
+void MaskSnapshot::extractColumn(float timeNorm, float* gains, int numBins) const noexcept
+{
+    const MaskData* snapshot = currentSnapshot.load(std::memory_order_acquire);
+    const int mapped = snapshot ? juce::jlimit(0, juce::jmax(numBins, 0), getNumMappedBins()) : 0;
+    
+    if (mapped > 0)
+    {
+        float column[MASK_HEIGHT + 1];
+        extractColumnRows(timeNorm, *snapshot, column);
+        computeBinGains(column, 0, mapped, gains);
+    }
+    
+    // No masking for bins the table does not cover
+    for (int bin = mapped; bin < numBins; ++bin)
+        gains[bin] = 1.0f;
+}
+
+void MaskSnapshot::applyMask(float timeNorm, std::complex<float>* bins, int numBins) const noexcept
+{
+    const MaskData* snapshot = currentSnapshot.load(std::memory_order_acquire);
+    const int mapped = juce::jmin(numBins, getNumMappedBins());
+    if (!snapshot || mapped <= 0)
+        return;
+    
+    float column[MASK_HEIGHT + 1];
+    extractColumnRows(timeNorm, *snapshot, column);
+    
+    // Bins are interleaved re/im floats; scale both by the bin's gain. Gains
+    // are produced in stack-sized chunks so any FFT size works without scratch
+    constexpr int chunkSize = 256;
+    float gains[chunkSize];
+    float* data = reinterpret_cast<float*>(bins);
+    
+    for (int start = 0; start < mapped; start += chunkSize)
+    {
+        const int n = juce::jmin(chunkSize, mapped - start);
+        computeBinGains(column, start, n, gains);
+        
+        float* chunk = data + 2 * start;
+        for (int i = 0; i < n; ++i)
+        {
+            chunk[2 * i] *= gains[i];
+            chunk[2 * i + 1] *= gains[i];
+        }
+    }
 }
 
 float MaskSnapshot::sampleMask(float timeNorm, float frequencyHz, double sampleRate) const noexcept
@@ -78,41 +218,57 @@ float MaskSnapshot::sampleMask(float timeNorm, float frequencyHz, double sampleR
     return juce::jlimit(0.0f, 1.0f, (1.0f - blend) + blend * maskValue);
 }
 
+void MaskSnapshot::beginAudioBlock() noexcept
+{
+    // RT-SAFE: one load when nothing new was published, one exchange otherwise
+    if ((sharedSlot.load(std::memory_order_relaxed) & SLOT_FRESH) == 0)
+        return;
+    
+    // Hand back the buffer we were reading (the GUI may recycle it from now
+    // on) and take the latest publish
+    const int previous = sharedSlot.exchange(readIndex, std::memory_order_acq_rel);
+    readIndex = previous & SLOT_INDEX_MASK;
+    currentSnapshot.store(publishBuffers[(size_t) readIndex].get(), std::memory_order_release);
+}
+
 void MaskSnapshot::commitWorkBuffer() noexcept
 {
     // NON-RT: This runs on GUI thread
     
-    // Copy work buffer to pending buffer
-    if (workBuffer && pendingBuffer)
-    {
-        std::memcpy(pendingBuffer->maskValues, workBuffer->maskValues, sizeof(workBuffer->maskValues));
-        pendingBuffer->timeScale = workBuffer->timeScale;
-        pendingBuffer->freqScale = workBuffer->freqScale;
-        pendingBuffer->minFreq = workBuffer->minFreq;
-        pendingBuffer->maxFreq = workBuffer->maxFreq;
-        pendingBuffer->featherTime = featherTime.load(std::memory_order_acquire);
-        pendingBuffer->featherFreq = featherFreq.load(std::memory_order_acquire);
-        pendingBuffer->threshold = threshold.load(std::memory_order_acquire);
-        pendingBuffer->protectHarmonics = protectHarmonics.load(std::memory_order_acquire);
-        pendingBuffer->timestamp = juce::Time::getMillisecondCounterHiRes();
-    }
+    // The write buffer is not visible to the audio thread: it is either the
+    // initial spare or one it handed back in beginAudioBlock (or an unread
+    // publish we superseded), so it can be overwritten in place
+    MaskData* nextBuffer = publishBuffers[(size_t) writeIndex].get();
     
-    // Atomic pointer swap: determine which audio buffer is not current
-    const MaskData* current = currentSnapshot.load(std::memory_order_acquire);
-    MaskData* nextBuffer = (current == audioBuffer1.get()) ? audioBuffer2.get() : audioBuffer1.get();
-    
-    // Copy pending to next audio buffer
-    if (pendingBuffer && nextBuffer)
+    if (workBuffer && nextBuffer)
     {
-        std::memcpy(nextBuffer, pendingBuffer.get(), sizeof(MaskData));
+        // Share tiles instead of copying 512 KB: untouched tiles are the same
+        // objects as in earlier snapshots, painted ones become immutable now.
+        // Tiles dropped here are freed on this thread, never the audio thread.
+        nextBuffer->tiles = workBuffer->tiles;
+        nextBuffer->activePixels = workBuffer->activePixels;
+        writableTiles.fill(nullptr);
+        
+        nextBuffer->timeScale = workBuffer->timeScale;
+        nextBuffer->freqScale = workBuffer->freqScale;
+        nextBuffer->minFreq = workBuffer->minFreq;
+        nextBuffer->maxFreq = workBuffer->maxFreq;
+        nextBuffer->featherTime = featherTime.load(std::memory_order_acquire);
+        nextBuffer->featherFreq = featherFreq.load(std::memory_order_acquire);
+        nextBuffer->threshold = threshold.load(std::memory_order_acquire);
+        nextBuffer->protectHarmonics = protectHarmonics.load(std::memory_order_acquire);
+        nextBuffer->timestamp = juce::Time::getMillisecondCounterHiRes();
     }
     
-    // Atomic swap: audio thread will see new snapshot
-    currentSnapshot.store(nextBuffer, std::memory_order_release);
+    // Wait-free publish: audio thread will see new snapshot from its next block
+    const int previous = sharedSlot.exchange(writeIndex | SLOT_FRESH, std::memory_order_acq_rel);
+    writeIndex = previous & SLOT_INDEX_MASK;
     
     // Update statistics
     statistics.swapCount++;
     statistics.lastSwapTime = juce::Time::getMillisecondCounterHiRes();
+    if (nextBuffer)
+        statistics.activeMaskPixels = nextBuffer->activePixels;
     
     // RT-SAFE: Debug logging removed
 }
@@ -121,11 +277,40 @@ void MaskSnapshot::clearWorkBuffer() noexcept
 {
     if (workBuffer)
     {
-        std::fill(std::begin(workBuffer->maskValues), std::end(workBuffer->maskValues), 1.0f);
+        workBuffer->tiles.fill(blankTile());
+        workBuffer->activePixels = 0;
+        writableTiles.fill(nullptr);
         workBuffer->timestamp = juce::Time::getMillisecondCounterHiRes();
     }
 }
 
+MaskSnapshot::MaskTile& MaskSnapshot::getWritableTile(int tileIndex)
+{
+    auto& tile = writableTiles[(size_t) tileIndex];
+    if (tile == nullptr)
+    {
+        // First write since the last commit: the current tile may be shared
+        // with published snapshots, so paint into a private copy
+        tile = std::make_shared<MaskTile>(*workBuffer->tiles[(size_t) tileIndex]);
+        workBuffer->tiles[(size_t) tileIndex] = tile;
+    }
+    return *tile;
+}
+
+void MaskSnapshot::setWorkValue(int x, int y, float value)
+{
+    if (x < 0 || x >= MASK_WIDTH || y < 0 || y >= MASK_HEIGHT)
+        return;
+    
+    auto& tile = getWritableTile(MaskData::tileIndex(x, y));
+    float& cell = tile.values[MaskData::cellIndex(x, y)];
+    
+    const int delta = int(isActiveValue(value)) - int(isActiveValue(cell));
+    tile.activePixels += delta;
+    workBuffer->activePixels += delta;
+    cell = value;
+}
+
 void MaskSnapshot::paintCircle(float centerX, float centerY, float radius, float value)
 {
     if (!workBuffer)
@@ -165,7 +350,7 @@ void MaskSnapshot::paintCircle(float centerX, float centerY, float radius, float
                 
                 float currentValue = workBuffer->getMaskValue(x, y);
                 float newValue = currentValue + alpha * (value - currentValue);
-                workBuffer->setMaskValue(x, y, newValue);
+                setWorkValue(x, y, newValue);
             }
         }
     }
@@ -191,7 +376,7 @@ void MaskSnapshot::paintRectangle(float x, float y, float width, float height, f
     {
         for (int px = minX; px <= maxX; ++px)
         {
-            workBuffer->setMaskValue(px, py, value);
+            setWorkValue(px, py, value);
         }
     }
 }
@@ -232,7 +417,7 @@ void MaskSnapshot::paintLine(float x1, float y1, float x2, float y2, float lineW
                     int paintY = y + dy;
                     if (paintX >= 0 && paintX < MASK_WIDTH && paintY >= 0 && paintY < MASK_HEIGHT)
                     {
-                        workBuffer->setMaskValue(paintX, paintY, value);
+                        setWorkValue(paintX, paintY, value);
                     }
                 }
             }
@@ -278,19 +463,3 @@ inline float MaskSnapshot::timeToX(float timeNorm) const noexcept
 {
     return juce::jlimit(0.0f, float(MASK_WIDTH - 1), timeNorm * float(MASK_WIDTH - 1));
 }
-
-void MaskSnapshot::updateStatistics() const noexcept
-{
-    // Count active mask pixels (non-1.0 values)
-    const MaskData* snapshot = currentSnapshot.load(std::memory_order_acquire);
-    if (snapshot)
-    {
-        int activePixels = 0;
-        for (int i = 0; i < MASK_SIZE; ++i)
-        {
-            if (std::abs(snapshot->maskValues[i] - 1.0f) > 0.001f)
-                activePixels++;
-        }
-        statistics.activeMaskPixels = activePixels;
-    }
-}
\ No newline at end of file
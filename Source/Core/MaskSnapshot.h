@@ -1,20 +1,28 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include <array>
 #include <atomic>
+#include <complex>
 #include <memory>
+#include <vector>
 
 /**
  * MaskSnapshot - RT-safe mask data transfer system
  *
  * Implements atomic pointer swapping for lock-free communication between
  * GUI thread (painting) and audio thread (synthesis). The GUI paints to 
- * a work buffer, then atomically swaps it with the audio thread's snapshot.
+ * a work buffer, then publishes it through a triple buffer: the audio thread
+ * pins the latest published snapshot once per block (beginAudioBlock), and
+ * the GUI only ever rewrites the one buffer neither side is holding.
  *
  * Key Features:
+ * - Tiled storage: commits publish only painted tiles, the rest are shared
  * - Zero allocations in audio thread
  * - Atomic pointer swap at block boundary only
+ * - Wait-free publish and acquire; commits can run at any rate
  * - Bilinear sampling for smooth interpolation
+ * - Whole-column extraction through a precomputed FFT bin -> row table
  * - Immutable snapshots prevent data races
  * - Sub-5ms performance impact
  */
@@ -28,13 +36,30 @@ public:
     static constexpr int MASK_HEIGHT = 256;   // Frequency resolution  
     static constexpr int MASK_SIZE = MASK_WIDTH * MASK_HEIGHT;
     
+    static constexpr int TILE_SIZE = 32;      // Tile edge in mask cells (4 KB per tile)
+    static constexpr int TILES_X = MASK_WIDTH / TILE_SIZE;
+    static constexpr int TILES_Y = MASK_HEIGHT / TILE_SIZE;
+    static constexpr int NUM_TILES = TILES_X * TILES_Y;
+    
     //==============================================================================
     // Mask Data Structure
     
+    // A TILE_SIZE x TILE_SIZE block of mask values (row-major). Published tiles
+    // are immutable and shared by every snapshot until painted over again.
+    struct MaskTile
+    {
+        alignas(32) float values[TILE_SIZE * TILE_SIZE];
+        int activePixels = 0;        // Values != 1.0, maintained while painting
+        
+        MaskTile() { std::fill(std::begin(values), std::end(values), 1.0f); }
+    };
+    
     struct MaskData
     {
-        // Mask values: 0.0 = fully attenuated, 1.0 = unaffected
-        alignas(32) float maskValues[MASK_SIZE];     // 32-byte aligned for SIMD
+        // Mask values: 0.0 = fully attenuated, 1.0 = unaffected, stored as tiles
+        // so a commit only has to publish the tiles that were painted
+        std::array<std::shared_ptr<const MaskTile>, NUM_TILES> tiles;
+        int activePixels = 0;        // Sum over all tiles
         
         // Metadata for bilinear sampling
         float timeScale = 1.0f;      // Time axis scaling factor
@@ -54,23 +79,19 @@ public:
         MaskData()
         {
             // Initialize with no masking (all 1.0)
-            std::fill(std::begin(maskValues), std::end(maskValues), 1.0f);
+            tiles.fill(blankTile());
             timestamp = juce::Time::getMillisecondCounterHiRes();
         }
         
+        static constexpr int tileIndex(int x, int y) noexcept { return (y / TILE_SIZE) * TILES_X + x / TILE_SIZE; }
+        static constexpr int cellIndex(int x, int y) noexcept { return (y % TILE_SIZE) * TILE_SIZE + x % TILE_SIZE; }
+        
         // Get mask value with bounds checking
         inline float getMaskValue(int x, int y) const noexcept
         {
             if (x < 0 || x >= MASK_WIDTH || y < 0 || y >= MASK_HEIGHT)
                 return 1.0f;
-            return maskValues[y * MASK_WIDTH + x];
-        }
-        
-        // Set mask value with bounds checking
-        inline void setMaskValue(int x, int y, float value) noexcept
-        {
-            if (x >= 0 && x < MASK_WIDTH && y >= 0 && y < MASK_HEIGHT)
-                maskValues[y * MASK_WIDTH + x] = juce::jlimit(0.0f, 1.0f, value);
+            return tiles[tileIndex(x, y)]->values[cellIndex(x, y)];
         }
         
         // Bilinear sampling for smooth interpolation
@@ -100,6 +121,9 @@ public:
         }
     };
     
+    // The all-1.0 tile every unpainted region shares
+    static const std::shared_ptr<const MaskTile>& blankTile();
+    
     //==============================================================================
     // Main Interface
     
@@ -109,7 +133,14 @@ public:
     // Audio thread interface (RT-safe)
     void prepareToPlay(double sampleRate, int samplesPerBlock);
     
-    // Get current snapshot for audio processing (RT-safe, returns immutable pointer)
+    // Call once at the start of every audio block, from the audio thread only.
+    // Picks up the most recent commit (if any) and pins it until the next call,
+    // so everything sampled during the block sees one consistent snapshot that
+    // the GUI cannot recycle (RT-safe, wait-free)
+    void beginAudioBlock() noexcept;
+    
+    // Get the snapshot pinned by beginAudioBlock (RT-safe, returns immutable
+    // pointer, valid until the next beginAudioBlock)
     const MaskData* getCurrentSnapshot() const noexcept
     {
         return currentSnapshot.load(std::memory_order_acquire);
@@ -118,6 +149,20 @@ public:
     // Sample mask at given time and frequency (RT-safe bilinear interpolation)
     float sampleMask(float timeNorm, float frequencyHz, double sampleRate) const noexcept;
     
+    // Builds the FFT bin -> mask row table for fftSize / sampleRate (not RT-safe,
+    // allocates; call at prepare time, never while extractColumn/applyMask run).
+    // prepareToPlay rebuilds an existing table for the new frequency range.
+    void prepareBinMapping(int fftSize, double sampleRate);
+    int getNumMappedBins() const noexcept { return (int) binRowMap.rows.size(); }
+    
+    // Per-bin gains for the mask column at timeNorm, shaped like sampleMask().
+    // Bins beyond the mapped range get 1.0 (RT-safe)
+    void extractColumn(float timeNorm, float* gains, int numBins) const noexcept;
+    
+    // Multiplies the mask column at timeNorm into numBins complex bins, e.g.
+    // from an STFTEngine frame callback (RT-safe, no scratch allocation)
+    void applyMask(float timeNorm, std::complex<float>* bins, int numBins) const noexcept;
+    
     // RT-SAFE: Fast math approximations
     static inline float fastLog2(float x) noexcept {
         union { float f; uint32_t i; } vx = { x };
@@ -127,10 +172,14 @@ public:
     
     // GUI thread interface (not RT-safe, but lock-free)
     
-    // Get work buffer for GUI painting
-    MaskData* getWorkBuffer() noexcept { return workBuffer.get(); }
+    // Get work buffer for GUI painting (read-only: paint through the methods
+    // below so tiles are copied on write and statistics stay current)
+    const MaskData* getWorkBuffer() const noexcept { return workBuffer.get(); }
     
-    // Commit work buffer to audio thread (atomic swap)
+    // Commit work buffer to audio thread (wait-free publish, visible from the
+    // next beginAudioBlock). Only tiles painted since the last commit are new;
+    // the rest are shared with earlier snapshots. Commits that the audio thread
+    // never picks up are simply superseded.
     void commitWorkBuffer() noexcept;
     
     // Clear work buffer
@@ -171,13 +220,26 @@ private:
     //==============================================================================
     // Internal Implementation
     
-    // Triple buffer system for lock-free operation
     std::unique_ptr<MaskData> workBuffer;      // GUI paints here
-    std::unique_ptr<MaskData> pendingBuffer;   // Ready to swap
-    std::unique_ptr<MaskData> audioBuffer1;    // Audio thread snapshot 1  
-    std::unique_ptr<MaskData> audioBuffer2;    // Audio thread snapshot 2
     
-    // Atomic pointer to current snapshot (audio thread reads this)
+    // Triple buffer for publication. At any time one buffer is pinned by the
+    // audio thread (readIndex), one is being filled by the GUI (writeIndex) and
+    // the third is the latest publish or a spare, held in sharedSlot. Both
+    // sides only ever exchange their own buffer with the shared slot, so the
+    // GUI never writes to a buffer the audio thread is reading.
+    static constexpr int NUM_PUBLISH_BUFFERS = 3;
+    static constexpr int SLOT_INDEX_MASK = 0x3;
+    static constexpr int SLOT_FRESH = 0x4;     // set: slot holds an unread publish
+    std::array<std::unique_ptr<MaskData>, NUM_PUBLISH_BUFFERS> publishBuffers;
+    std::atomic<int> sharedSlot{2};
+    int writeIndex = 1;                        // GUI thread only
+    int readIndex = 0;                         // Audio thread only
+    
+    // Work tiles painted since the last commit (owned by the work buffer
+    // alone, so they can be written in place); null = shared, copy on write
+    std::array<std::shared_ptr<MaskTile>, NUM_TILES> writableTiles;
+    
+    // Snapshot pinned by the audio thread (publishBuffers[readIndex])
     std::atomic<const MaskData*> currentSnapshot{nullptr};
     
     // Parameters (thread-safe atomics)
@@ -188,6 +250,17 @@ private:
     std::atomic<float> threshold{-30.0f};      // Threshold in dB
     std::atomic<bool> protectHarmonics{true};  // Protect harmonic content
     
+    // FFT bin -> mask row mapping: bin b samples rows[b] and rows[b] + 1,
+    // blended by fractions[b]. Rebuilt only by prepareBinMapping()
+    struct BinRowMap
+    {
+        int fftSize = 0;
+        double sampleRate = 0.0;
+        std::vector<int> rows;
+        std::vector<float> fractions;
+    };
+    BinRowMap binRowMap;
+    
     // Audio processing state
     double currentSampleRate = 44100.0;
     int samplesPerBlock = 512;
@@ -197,9 +270,12 @@ private:
     mutable juce::uint64 lastCpuMeasureTime = 0;
     
     // Helper methods
+    MaskTile& getWritableTile(int tileIndex);
+    void setWorkValue(int x, int y, float value);
+    void extractColumnRows(float timeNorm, const MaskData& snapshot, float* column) const noexcept;
+    void computeBinGains(const float* column, int firstBin, int numBins, float* gains) const noexcept;
     inline float frequencyToY(float frequencyHz, const MaskData* snapshot) const noexcept;
     inline float timeToX(float timeNorm) const noexcept;
-    void updateStatistics() const noexcept;
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MaskSnapshot)
 };
\ No newline at end of file
@@ -30,6 +30,8 @@ struct PaintEvent
     float pressure;  // 0..1
     uint32_t flags;  // kStrokeStart/Move/End (exactly one)
     uint32_t color;  // optional: packed RGBA or brush ID
+    int64_t  ticks = 0; // juce::Time::getHighResolutionTicks() when created, 0 = unstamped
+    int64_t  sampleTime = -1; // absolute engine sample position (offline rendering), -1 = use ticks
     
     PaintEvent() = default;
     PaintEvent(float x, float y, float p, uint32_t f = 0, uint32_t c = 0) 
@@ -89,13 +89,16 @@ ARTEFACTAudioProcessor::~ARTEFACTAudioProcessor()
 void ARTEFACTAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
     currentSampleRate = sampleRate;
-    
+    sampleLoader.setSessionSampleRate(sampleRate);
     
     // Prepare all processors
     forgeProcessor.prepareToPlay(sampleRate, samplesPerBlock);
     paintEngine.prepareToPlay(sampleRate, samplesPerBlock);
     sampleMaskingEngine.prepareToPlay(sampleRate, samplesPerBlock, 2); // Stereo
-    SpectralSynthEngine::instance().prepare(sampleRate, samplesPerBlock);
+    // The load governor reacts to wall-clock time; offline renders must not
+    // trade quality for speed, and must come out the same on every run
+    spectralSynthEngine.setLoadGovernorEnabled(! isNonRealtime());
+    spectralSynthEngine.prepare(sampleRate, samplesPerBlock);
     spectralSynthEngineStub.prepareToPlay(sampleRate, samplesPerBlock, 2); // Y2K theme audio
     audioRecorder.prepareToPlay(sampleRate, samplesPerBlock);
     
@@ -125,7 +128,8 @@ void ARTEFACTAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBloc
     preallocPaint.setSize(preallocChannels, preallocBlockSize, false, false, true);
 
     // 🚨 STARTUP PING: 250ms tone to prove audio device is working
-    warmupSamples = static_cast<int>(0.25 * sampleRate);
+    // Skipped for offline (non-realtime) rendering so renders start on the content
+    warmupSamples = isNonRealtime() ? 0 : static_cast<int>(0.25 * sampleRate);
     startupPhase = 0.0;
 }
 
@@ -133,7 +137,7 @@ void ARTEFACTAudioProcessor::releaseResources()
 {
     paintEngine.releaseResources();
     sampleMaskingEngine.releaseResources();
-    SpectralSynthEngine::instance().releaseResources();
+    spectralSynthEngine.releaseResources();
     spectralSynthEngineStub.releaseResources();
     audioRecorder.releaseResources();
     // Note: ForgeProcessor doesn't have releaseResources() method yet
@@ -444,7 +448,7 @@ void ARTEFACTAudioProcessor::parameterChanged(const juce::String& parameterID, f
     else if (parameterID == "topNBands")
     {
         int bandCount = static_cast<int>(newValue);
-        SpectralSynthEngine::instance().setTopNBands(bandCount);
+        spectralSynthEngine.setTopNBands(bandCount);
 <<<<<<< HEAD
         DBG("Top-N bands changed to: " << bandCount);
 =======
@@ -521,7 +525,7 @@ void ARTEFACTAudioProcessor::parameterChanged(const juce::String& parameterID, f
     
     else if (parameterID == "maskBlend")
     {
-        SpectralSynthEngine::instance().getMaskSnapshot().setMaskBlend(newValue);
+        spectralSynthEngine.getMaskSnapshot().setMaskBlend(newValue);
 <<<<<<< HEAD
         DBG("Mask blend changed to: " << (newValue * 100.0f) << "%");
 =======
@@ -530,7 +534,7 @@ void ARTEFACTAudioProcessor::parameterChanged(const juce::String& parameterID, f
     }
     else if (parameterID == "maskStrength")
     {
-        SpectralSynthEngine::instance().getMaskSnapshot().setMaskStrength(newValue);
+        spectralSynthEngine.getMaskSnapshot().setMaskStrength(newValue);
 <<<<<<< HEAD
         DBG("Mask strength changed to: " << newValue);
 =======
@@ -539,7 +543,7 @@ void ARTEFACTAudioProcessor::parameterChanged(const juce::String& parameterID, f
     }
     else if (parameterID == "featherTime")
     {
-        SpectralSynthEngine::instance().getMaskSnapshot().setFeatherTime(newValue);
+        spectralSynthEngine.getMaskSnapshot().setFeatherTime(newValue);
 <<<<<<< HEAD
         DBG("Feather time changed to: " << (newValue * 1000.0f) << "ms");
 =======
@@ -548,7 +552,7 @@ void ARTEFACTAudioProcessor::parameterChanged(const juce::String& parameterID, f
     }
     else if (parameterID == "featherFreq")
     {
-        SpectralSynthEngine::instance().getMaskSnapshot().setFeatherFreq(newValue);
+        spectralSynthEngine.getMaskSnapshot().setFeatherFreq(newValue);
 <<<<<<< HEAD
         DBG("Feather frequency changed to: " << newValue << "Hz");
 =======
@@ -557,7 +561,7 @@ void ARTEFACTAudioProcessor::parameterChanged(const juce::String& parameterID, f
     }
     else if (parameterID == "threshold")
     {
-        SpectralSynthEngine::instance().getMaskSnapshot().setThreshold(newValue);
+        spectralSynthEngine.getMaskSnapshot().setThreshold(newValue);
 <<<<<<< HEAD
         DBG("Mask threshold changed to: " << newValue << "dB");
 =======
@@ -566,7 +570,7 @@ void ARTEFACTAudioProcessor::parameterChanged(const juce::String& parameterID, f
     }
     else if (parameterID == "protectHarmonics")
     {
-        SpectralSynthEngine::instance().getMaskSnapshot().setProtectHarmonics(newValue > 0.5f);
+        spectralSynthEngine.getMaskSnapshot().setProtectHarmonics(newValue > 0.5f);
 <<<<<<< HEAD
         DBG("Protect harmonics changed to: " << (newValue > 0.5f ? "ON" : "OFF"));
 =======
@@ -636,6 +640,23 @@ void ARTEFACTAudioProcessor::setStateInformation(const void* data, int sizeInByt
 
 bool ARTEFACTAudioProcessor::pushCommandToQueue(const Command& newCommand)
 {
+    // Sample loads never reach the audio thread as commands: they are decoded
+    // by the loader threads and installed by installLoadedSamples()
+    const bool forgeLoad = newCommand.isForgeCommand() && newCommand.getForgeCommandID() == ForgeCommandID::LoadSample;
+    const bool maskingLoad = newCommand.isSampleMaskingCommand()
+                          && newCommand.getSampleMaskingCommandID() == SampleMaskingCommandID::LoadSample;
+    
+    if (forgeLoad || maskingLoad)
+    {
+        // The path is copied out, so its arena slot can go straight back
+        const juce::File file(newCommand.getStringParam());
+        Command consumed = newCommand;
+        consumed.releaseStringParam();
+        
+        return forgeLoad ? sampleLoader.requestLoad(SampleLoader::Target::ForgeSlot, newCommand.intParam, file)
+                         : sampleLoader.requestLoad(SampleLoader::Target::SampleMasking, 0, file);
+    }
+    
     return commandQueue.push(newCommand);
 }
 
@@ -645,11 +666,53 @@ void ARTEFACTAudioProcessor::processCommands()
     // We allow up to 0.5ms for command processing (conservative limit)
     const double maxProcessingTimeMs = 0.5;
     
+    installLoadedSamples();
+    
     commandQueue.processWithTimeLimit([this](const Command& cmd) {
         processCommand(cmd);
     }, maxProcessingTimeMs);
 }
 
+void ARTEFACTAudioProcessor::installLoadedSamples()
+{
+    // RT-safe: every install is a buffer swap; the previous sample goes back
+    // to the loader to be freed off the audio thread
+    while (auto* loaded = sampleLoader.popFinished())
+    {
+        if (loaded->success)
+        {
+            switch (loaded->target)
+            {
+            case SampleLoader::Target::ForgeSlot:
+                forgeProcessor.adoptSampleIntoSlot(loaded->slot, *loaded->buffer, loaded->name, loaded->maskFrames);
+                
+                // AUDIO FIX: Switch to Forge mode for sample playback
+                currentMode = ProcessingMode::Forge;
+                break;
+                
+            case SampleLoader::Target::SampleMasking:
+                sampleMaskingEngine.adoptSample(loaded->buffer, loaded->sampleRate, loaded->name, loaded->tempo);
+                
+                // NEW: Auto-detect tempo and enable sync for beatmakers
+                if (loaded->tempo.confidence > 0.5f)
+                    sampleMaskingEngine.enableTempoSync(true);
+                
+                // NEW: Auto-start playback for immediate feedback (beatmaker friendly!)
+                sampleMaskingEngine.startPlayback();
+                break;
+            }
+        }
+        else
+        {
+            // Nothing to install. Counted for the HUD; the loader keeps the
+            // message for takeFailedSampleLoads() once it is recycled
+            failedSampleLoads.fetch_add(1, std::memory_order_relaxed);
+        }
+        
+        sampleLoader.recycle(loaded);
+    }
+}
+
 void ARTEFACTAudioProcessor::processCommand(const Command& cmd)
 {
     // Route command based on type
@@ -682,15 +745,7 @@ void ARTEFACTAudioProcessor::processForgeCommand(const Command& cmd)
         forgeProcessor.getVoice(cmd.intParam).stop();
         break;
     case ForgeCommandID::LoadSample:
-        {
-            juce::File sampleFile(cmd.getStringParam());
-            // RT-safe: No logging from parameter listeners
-            forgeProcessor.loadSampleIntoSlot(cmd.intParam, sampleFile);
-            
-            // AUDIO FIX: Switch to Forge mode for sample playback
-            currentMode = ProcessingMode::Forge;
-            // RT-safe: No logging from parameter listeners
-        }
+        // Decoded off-thread, see pushCommandToQueue() and installLoadedSamples()
         break;
     case ForgeCommandID::SetPitch:
         forgeProcessor.getVoice(cmd.intParam).setPitch(cmd.floatParam);
@@ -720,30 +775,7 @@ void ARTEFACTAudioProcessor::processSampleMaskingCommand(const Command& cmd)
     switch (cmd.getSampleMaskingCommandID())
     {
     case SampleMaskingCommandID::LoadSample:
-        {
-            juce::File sampleFile(cmd.stringParam);
-            auto result = sampleMaskingEngine.loadSample(sampleFile);
-            if (result.success)
-            {
-                // RT-safe: No logging from parameter listeners
-                
-                // NEW: Auto-detect tempo and enable sync for beatmakers
-                auto tempoInfo = sampleMaskingEngine.detectSampleTempo();
-                if (tempoInfo.confidence > 0.5f)
-                {
-                    // RT-safe: No logging from parameter listeners
-                    sampleMaskingEngine.enableTempoSync(true);
-                }
-                
-                // NEW: Auto-start playback for immediate feedback (beatmaker friendly!)
-                sampleMaskingEngine.startPlayback();
-                // RT-safe: No logging from parameter listeners
-            }
-            else
-            {
-                // RT-safe: No logging from parameter listeners
-            }
-        }
+        // Decoded off-thread, see pushCommandToQueue() and installLoadedSamples()
         break;
     case SampleMaskingCommandID::ClearSample:
         sampleMaskingEngine.clearSample();
@@ -769,7 +801,7 @@ void ARTEFACTAudioProcessor::processSampleMaskingCommand(const Command& cmd)
     case SampleMaskingCommandID::CreatePaintMask:
         {
             auto mode = static_cast<SampleMaskingEngine::MaskingMode>(static_cast<int>(cmd.floatParam));
-            juce::uint32 maskId = sampleMaskingEngine.createPaintMask(mode, cmd.color);
+            juce::uint32 maskId = sampleMaskingEngine.createPaintMask(mode, cmd.getColour());
             // Note: maskId could be stored for later reference if needed
         }
         break;
@@ -812,10 +844,10 @@ void ARTEFACTAudioProcessor::processSampleMaskingCommand(const Command& cmd)
         sampleMaskingEngine.endPaintStroke();
         break;
     case SampleMaskingCommandID::SetCanvasSize:
-        sampleMaskingEngine.setCanvasSize(cmd.floatParam, static_cast<float>(cmd.doubleParam));
+        sampleMaskingEngine.setCanvasSize(cmd.floatParam, cmd.floatParam2);
         break;
     case SampleMaskingCommandID::SetTimeRange:
-        sampleMaskingEngine.setTimeRange(cmd.floatParam, static_cast<float>(cmd.doubleParam));
+        sampleMaskingEngine.setTimeRange(cmd.floatParam, cmd.floatParam2);
         break;
     default:
         break;
@@ -828,7 +860,7 @@ void ARTEFACTAudioProcessor::processPaintCommand(const Command& cmd)
     {
     case PaintCommandID::BeginStroke:
         // Send to both PaintEngine and SpectralSynthEngine for MetaSynth functionality
-        paintEngine.beginStroke(PaintEngine::Point(cmd.x, cmd.y), cmd.pressure, cmd.color);
+        paintEngine.beginStroke(PaintEngine::Point(cmd.x, cmd.y), cmd.pressure, cmd.getColour());
         
         // Create PaintData for SpectralSynthEngine with MetaSynth mapping
         {
@@ -837,7 +869,7 @@ void ARTEFACTAudioProcessor::processPaintCommand(const Command& cmd)
             paintData.freqNorm = juce::jlimit(0.0f, 1.0f, cmd.y / 100.0f); // Normalize assuming 100-unit frequency range
             paintData.pressure = cmd.pressure;
             paintData.velocity = 0.5f;  // Default velocity
-            paintData.color = cmd.color;
+            paintData.color = cmd.getColour();
             paintData.timestamp = juce::Time::getMillisecondCounter();
             
             // Calculate derived parameters (this will be done by the engine)
@@ -846,7 +878,7 @@ void ARTEFACTAudioProcessor::processPaintCommand(const Command& cmd)
             paintData.panPosition = 0.0f;  // Will be calculated from color
             paintData.synthMode = 0;
             
-            SpectralSynthEngine::instance().processPaintStroke(paintData);
+            spectralSynthEngine.processPaintStroke(paintData);
         }
         break;
     case PaintCommandID::UpdateStroke:
@@ -859,7 +891,7 @@ void ARTEFACTAudioProcessor::processPaintCommand(const Command& cmd)
             paintData.freqNorm = juce::jlimit(0.0f, 1.0f, cmd.y / 100.0f);
             paintData.pressure = cmd.pressure;
             paintData.velocity = 0.7f;  // Higher velocity for updates
-            paintData.color = cmd.color;
+            paintData.color = cmd.getColour();
             paintData.timestamp = juce::Time::getMillisecondCounter();
             
             paintData.frequencyHz = 80.0f + paintData.freqNorm * (8000.0f - 80.0f);
@@ -867,7 +899,7 @@ void ARTEFACTAudioProcessor::processPaintCommand(const Command& cmd)
             paintData.panPosition = 0.0f;
             paintData.synthMode = 0;
             
-            SpectralSynthEngine::instance().processPaintStroke(paintData);
+            spectralSynthEngine.processPaintStroke(paintData);
         }
         break;
     case PaintCommandID::EndStroke:
@@ -888,10 +920,10 @@ void ARTEFACTAudioProcessor::processPaintCommand(const Command& cmd)
         paintEngine.setMasterGain(cmd.floatParam);
         break;
     case PaintCommandID::SetFrequencyRange:
-        paintEngine.setFrequencyRange(cmd.floatParam, static_cast<float>(cmd.doubleParam));
+        paintEngine.setFrequencyRange(cmd.floatParam, cmd.floatParam2);
         break;
     case PaintCommandID::SetCanvasRegion:
-        paintEngine.setCanvasRegion(cmd.x, cmd.y, cmd.floatParam, static_cast<float>(cmd.doubleParam));
+        paintEngine.setCanvasRegion(cmd.x, cmd.y, cmd.floatParam, cmd.floatParam2);
         break;
     default:
         break;
@@ -911,7 +943,7 @@ void ARTEFACTAudioProcessor::processRecordingCommand(const Command& cmd)
         // RT-safe: No logging from parameter listeners
         break;
     case RecordingCommandID::ExportToFile:
-        if (cmd.stringParam[0] != '\0')
+        if (cmd.hasStringParam())
         {
             juce::File exportFile(cmd.getStringParam());
             auto format = static_cast<AudioRecorder::ExportFormat>(cmd.intParam);
@@ -923,7 +955,7 @@ void ARTEFACTAudioProcessor::processRecordingCommand(const Command& cmd)
         // TODO: Implement format setting if needed
         break;
     case RecordingCommandID::SetRecordingDirectory:
-        if (cmd.stringParam[0] != '\0')
+        if (cmd.hasStringParam())
         {
             juce::File directory(cmd.getStringParam());
             audioRecorder.setRecordingDirectory(directory);
@@ -951,12 +983,10 @@ void ARTEFACTAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce
         #endif
     }
 
-    // Audio routing: Use SpectralSynthEngine when initialized, fallback to debug tone
-    if (SpectralSynthEngine::instance().isInitialized())
-    {
-        SpectralSynthEngine::instance().processAudioBlock(buffer, getSampleRate());
-    }
-    else
+    // Audio routing: SpectralSynthEngine renders once per block in the mode switch
+    // below (its sample clock must advance exactly once per host block); until it
+    // is prepared, fall back to the debug tone
+    if (! spectralSynthEngine.isInitialized())
     {
         // Fallback debug tone when engine not yet ready
         #if defined(ENABLE_SANDBOX_TONE)
@@ -1128,7 +1158,11 @@ void ARTEFACTAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce
         }
 
         // Forward the same event to the RT-safe synth engine
-        SpectralSynthEngine::instance().pushGestureRT(paintEvent);
+        if (paintEvent.sampleTime >= 0)
+            spectralSynthEngine.pushGestureRT(paintEvent, paintEvent.sampleTime);
+        else
+            spectralSynthEngine.pushGestureRT(paintEvent);
+        ++hudEventsPopped;
     }
     
     // Process audio based on current mode
@@ -1143,7 +1177,7 @@ void ARTEFACTAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce
         
         // Step 2: Paint-driven spectral synthesis (with harmonic quantization)
         paintEngine.processBlock(buffer);
-        SpectralSynthEngine::instance().processAudioBlock(buffer, getSampleRate());
+        spectralSynthEngine.processAudioBlock(buffer, getSampleRate());
         
         // Step 3: Tube stage final glue (vintage compression, 2nd/3rd harmonics align)  
         tubeStage.process(buffer);
@@ -1165,7 +1199,7 @@ void ARTEFACTAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce
             // Process paint engine with character chain into separate buffer
             emuFilter.processBlock(paintView);
             paintEngine.processBlock(paintView);
-            SpectralSynthEngine::instance().processAudioBlock(paintView, getSampleRate());
+            spectralSynthEngine.processAudioBlock(paintView, getSampleRate());
             tubeStage.process(paintView);
             
             // Process forge engine into main buffer (no character processing for pure forge)
@@ -1193,6 +1227,34 @@ void ARTEFACTAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce
     
     // Send processed audio to recorder for real-time capture
     audioRecorder.processBlock(buffer);
+    
+    publishHudMetrics(buffer);
+}
+
+void ARTEFACTAudioProcessor::publishHudMetrics(const juce::AudioBuffer<float>& buffer) noexcept
+{
+    const int n = buffer.getNumSamples();
+    hudSamplesUntilPublish -= n;
+    if (hudSamplesUntilPublish > 0 || n <= 0 || buffer.getNumChannels() == 0)
+        return;
+    hudSamplesUntilPublish = static_cast<int>(getSampleRate() / 30.0);
+    
+    const int right = buffer.getNumChannels() > 1 ? 1 : 0;
+    SpectralCanvas::HudMetrics m;
+    m.peakL = buffer.getMagnitude(0, 0, n);
+    m.peakR = buffer.getMagnitude(right, 0, n);
+    m.rmsL = buffer.getRMSLevel(0, 0, n);
+    m.rmsR = buffer.getRMSLevel(right, 0, n);
+    m.lastBlockRMS = juce::jmax(m.rmsL, m.rmsR);
+    m.block = n;
+    m.sr = getSampleRate();
+    m.serial = ++hudSerial;
+    m.evPushed = hudEventsPushed.load(std::memory_order_relaxed);
+    m.evPopped = hudEventsPopped;
+    m.loadFailures = failedSampleLoads.load(std::memory_order_relaxed);
+    spectralSynthEngine.fillHudMetrics(m);
+    
+    hudQueue.push(m); // dropped while the HUD is hidden and the queue is full
 }
 
 //==============================================================================
@@ -7,6 +7,7 @@
 #include "Core/ForgeProcessor.h"
 #include "Core/PaintEngine.h"
 #include "Core/SampleMaskingEngine.h"
+#include "Core/SampleLoader.h"
 #include "Core/ParameterBridge.h"
 #include "Core/AudioRecorder.h"
 #include "Core/SpectralSynthEngine.h"
@@ -14,6 +15,7 @@
 #include "Core/PaintQueue.h"
 #include "Core/EMUFilter.h"
 #include "Core/TubeStage.h"
+#include "Telemetry/HudMetrics.h"
 
 class ARTEFACTAudioProcessor : public juce::AudioProcessor,
     public juce::AudioProcessorValueTreeState::Listener
@@ -64,6 +66,14 @@ public:
     // Paint queue interface for Y2K theme
     SpectralPaintQueue* getPaintQueue() { return &paintQueue; }
     
+    // HUD telemetry, published from processBlock about 30 times a second
+    SpectralCanvas::HudQueue& getHudQueue() { return hudQueue; }
+
+    // Sample loads that failed to decode, and (message thread) their error
+    // messages since the last call
+    uint32_t getNumFailedSampleLoads() const noexcept { return failedSampleLoads.load(std::memory_order_relaxed); }
+    juce::StringArray takeFailedSampleLoads() { return sampleLoader.takeFailedLoads(); }
+    
     // Paint Brush System
     void setActivePaintBrush(int slotIndex);
     int getActivePaintBrush() const { return activePaintBrushSlot; }
@@ -96,9 +106,21 @@ public:
     }
     
     // Paint queue interface for real-time paint-to-audio
-    bool pushPaintEvent(const PaintEvent& event) { return paintQueue.push(event); }
+    // Events are stamped here (UI thread) so the synth can place them sample-accurately
+    bool pushPaintEvent(PaintEvent event) {
+        if (event.ticks == 0) event.ticks = juce::Time::getHighResolutionTicks();
+        const bool pushed = paintQueue.push(event);
+        if (pushed) hudEventsPushed.fetch_add(1, std::memory_order_relaxed);
+        return pushed;
+    }
     bool pushPaintEvent(float x, float y, float pressure, uint32_t flags = kStrokeMove) {
-        return paintQueue.push(PaintEvent(x, y, pressure, flags));
+        return pushPaintEvent(PaintEvent(x, y, pressure, flags));
+    }
+    // Offline rendering: schedules the event at an absolute sample position
+    // (counted from prepareToPlay) instead of stamping it with the wall clock
+    bool pushPaintEventAt(PaintEvent event, int64_t samplePosition) {
+        event.sampleTime = samplePosition;
+        return paintQueue.push(event);
     }
     
     // State flags
@@ -125,13 +147,26 @@ private:
     ProcessingMode currentMode = ProcessingMode::Canvas;
 
     // Thread-safe command queue
-    CommandQueue<512> commandQueue;  // Increased size for better performance
+    CommandQueue<4096> commandQueue;  // 32-byte commands: 128KB, deep enough for dense painting
+    
+    // Decodes LoadSample requests off the audio thread
+    SampleLoader sampleLoader;
     
     // Paint event queue for real-time paint-to-audio
     SpectralPaintQueue paintQueue;
     
+    // HUD telemetry (audio thread produces, HudOverlay's timer consumes)
+    SpectralCanvas::HudQueue hudQueue;
+    std::atomic<uint32_t> hudEventsPushed{0};
+    uint32_t hudEventsPopped = 0;
+    uint32_t hudSerial = 0;
+    int hudSamplesUntilPublish = 0;
+    std::atomic<uint32_t> failedSampleLoads{0};
+    void publishHudMetrics(const juce::AudioBuffer<float>& buffer) noexcept;
+    
     // Command processing methods
     void processCommands();
+    void installLoadedSamples();
     void processCommand(const Command& cmd);
     void processForgeCommand(const Command& cmd);
     void processSampleMaskingCommand(const Command& cmd);
@@ -0,0 +1,282 @@
+/******************************************************************************
+ * File: SampleLoader.cpp
+ * Description: Background sample decoding with RT-safe handoff to the engines
+ *
+ * Copyright (c) 2025 Spectral Audio Systems
+ ******************************************************************************/
+
+#include "SampleLoader.h"
+
+namespace
+{
+    constexpr int sleepTimeoutMs = 200;             // only bounds how long shutdown can take
+    constexpr juce::int64 maxFileBytes = 500LL * 1024 * 1024;
+    constexpr int maskBlockSize = 512;              // what ForgeVoice prepares its mask with
+}
+
+//==============================================================================
+class SampleLoader::Worker : public juce::Thread
+{
+public:
+    Worker(SampleLoader& owner, int index)
+        : juce::Thread("Sample loader " + juce::String(index)), loader(owner)
+    {
+    }
+
+    void run() override
+    {
+        while (! threadShouldExit())
+        {
+            loader.collectGarbage();
+
+            Request request;
+            if (loader.takeRequest(request))
+            {
+                loader.publish(loader.decode(request.target, request.slot, request.file));
+                continue;
+            }
+
+            wakeEvent.wait(sleepTimeoutMs);
+        }
+    }
+
+    void wake() noexcept { wakeEvent.signal(); }
+
+    void stop()
+    {
+        signalThreadShouldExit();
+        wakeEvent.signal();
+        stopThread(2000);
+    }
+
+private:
+    SampleLoader& loader;
+    juce::WaitableEvent wakeEvent;
+};
+
+//==============================================================================
+bool SampleLoader::PointerFifo::push(LoadedSample* sample) noexcept
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite(1, start1, size1, start2, size2);
+    if (size1 + size2 != 1)
+        return false;
+
+    slots[(size_t) (size1 == 1 ? start1 : start2)] = sample;
+    fifo.finishedWrite(1);
+    return true;
+}
+
+SampleLoader::LoadedSample* SampleLoader::PointerFifo::pop() noexcept
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(1, start1, size1, start2, size2);
+    if (size1 + size2 != 1)
+        return nullptr;
+
+    auto* sample = slots[(size_t) (size1 == 1 ? start1 : start2)];
+    fifo.finishedRead(1);
+    return sample;
+}
+
+//==============================================================================
+SampleLoader::SampleLoader(int numThreads)
+{
+    formatManager.registerBasicFormats();
+
+    for (int i = 0; i < juce::jmax(1, numThreads); ++i)
+    {
+        auto worker = std::make_unique<Worker>(*this, i);
+        worker->startThread(juce::Thread::Priority::background);
+        workers.push_back(std::move(worker));
+    }
+}
+
+SampleLoader::~SampleLoader()
+{
+    for (auto& worker : workers)
+        worker->stop();
+
+    // Nothing can touch the FIFOs any more; free what is still in flight
+    while (auto* sample = finished.pop())
+        delete sample;
+    while (auto* sample = garbage.pop())
+        delete sample;
+}
+
+void SampleLoader::setPeakNormalisation(bool enabled, float targetDb) noexcept
+{
+    normaliseTargetDb.store(targetDb);
+    normalise.store(enabled);
+}
+
+bool SampleLoader::requestLoad(Target target, int slot, const juce::File& file)
+{
+    if (! file.existsAsFile())
+        return false;
+
+    // Bounding the number of live LoadedSamples bounds both FIFOs, so neither
+    // the loader threads nor the audio thread can ever find one full
+    if (outstanding.fetch_add(1) >= kMaxInFlight)
+    {
+        outstanding.fetch_sub(1);
+        return false;
+    }
+
+    {
+        const juce::ScopedLock lock(requestLock);
+        requests.push_back({ target, slot, file });
+    }
+
+    for (auto& worker : workers)
+        worker->wake();
+    return true;
+}
+
+SampleLoader::LoadedSample* SampleLoader::popFinished() noexcept
+{
+    return finished.pop();
+}
+
+void SampleLoader::recycle(LoadedSample* sample) noexcept
+{
+    if (sample == nullptr)
+        return;
+
+    // Cannot fail: at most kMaxInFlight samples exist
+    garbage.push(sample);
+    workers.front()->wake();
+}
+
+bool SampleLoader::takeRequest(Request& request)
+{
+    const juce::ScopedLock lock(requestLock);
+    if (requests.empty())
+        return false;
+
+    request = requests.front();
+    requests.pop_front();
+    return true;
+}
+
+void SampleLoader::publish(std::unique_ptr<LoadedSample> sample)
+{
+    const juce::ScopedLock lock(publishLock);
+    if (finished.push(sample.get()))
+        sample.release();
+    else
+        outstanding.fetch_sub(1);                   // unreachable while the in-flight cap holds
+}
+
+juce::StringArray SampleLoader::takeFailedLoads()
+{
+    juce::StringArray taken;
+    const juce::ScopedLock lock(failureLock);
+    taken.swapWith(failedLoads);
+    return taken;
+}
+
+void SampleLoader::collectGarbage()
+{
+    const juce::ScopedLock lock(garbageLock);
+    while (auto* sample = garbage.pop())
+    {
+        if (! sample->success)
+        {
+            DBG("SampleLoader: " << sample->errorMessage);
+            const juce::ScopedLock failureScope(failureLock);
+            failedLoads.add(sample->errorMessage);
+            if (failedLoads.size() > kMaxFailuresKept)
+                failedLoads.remove(0);
+        }
+
+        delete sample;
+        outstanding.fetch_sub(1);
+    }
+}
+
+//==============================================================================
+std::unique_ptr<SampleLoader::LoadedSample> SampleLoader::decode(Target target, int slot, const juce::File& file)
+{
+    auto sample = std::make_unique<LoadedSample>();
+    sample->target = target;
+    sample->slot = slot;
+    sample->name = file.getFileNameWithoutExtension();
+
+    if (! file.existsAsFile() || file.getSize() == 0)
+    {
+        sample->errorMessage = "Cannot read file: " + file.getFileName();
+        return sample;
+    }
+
+    if (file.getSize() > maxFileBytes)
+    {
+        sample->errorMessage = "File too large: " + file.getFileName() + " (max 500MB)";
+        return sample;
+    }
+
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+    if (reader == nullptr)
+    {
+        sample->errorMessage = "Unsupported audio format: " + file.getFileExtension().toLowerCase();
+        return sample;
+    }
+
+    if (reader->lengthInSamples <= 0 || reader->lengthInSamples > std::numeric_limits<int>::max()
+        || reader->numChannels < 1 || reader->numChannels > 8 || reader->sampleRate <= 0.0)
+    {
+        sample->errorMessage = "Unsupported audio file: " + file.getFileName();
+        return sample;
+    }
+
+    const int numChannels = (int) reader->numChannels;
+    const int length = (int) reader->lengthInSamples;
+    auto decoded = std::make_unique<juce::AudioBuffer<float>>(numChannels, length);
+    if (! reader->read(decoded.get(), 0, length, 0, true, true))
+    {
+        sample->errorMessage = "Failed to read audio data from: " + file.getFileName();
+        return sample;
+    }
+
+    sample->sourceSampleRate = reader->sampleRate;
+    sample->sampleRate = reader->sampleRate;
+
+    // Resample to the session rate so engines can play samples frame for frame
+    const double targetRate = sessionSampleRate.load();
+    if (targetRate > 0.0 && std::abs(targetRate - reader->sampleRate) > 1.0e-6)
+    {
+        const double increment = reader->sampleRate / targetRate;
+        const int resampledLength = juce::jmax(1, (int) std::ceil(length / increment));
+        auto resampled = std::make_unique<juce::AudioBuffer<float>>(numChannels, resampledLength);
+
+        SampleResampler resampler(SampleResampler::Quality::Sinc32);
+        resampler.process(*decoded, *resampled, 0, resampledLength, 0.0, increment, false);
+
+        decoded = std::move(resampled);
+        sample->sampleRate = targetRate;
+    }
+
+    if (normalise.load())
+    {
+        const float peak = decoded->getMagnitude(0, decoded->getNumSamples());
+        if (peak > 1.0e-6f)
+            decoded->applyGain(juce::Decibels::decibelsToGain(normaliseTargetDb.load()) / peak);
+    }
+
+    if (target == Target::SampleMasking)
+        sample->tempo = SampleMaskingEngine::analyseTempo(*decoded, sample->sampleRate);
+
+    // Forge voices mask with this analysis; running it here keeps the
+    // install on the audio thread down to a swap
+    if (target == Target::ForgeSlot)
+    {
+        SpectralMask analyser;
+        analyser.prepareToPlay(sample->sampleRate, maskBlockSize);
+        analyser.analyzeSample(*decoded, 0);
+        analyser.swapAnalysis(sample->maskFrames);
+    }
+
+    sample->buffer = std::move(decoded);
+    sample->success = true;
+    return sample;
+}
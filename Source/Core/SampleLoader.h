@@ -0,0 +1,140 @@
+/******************************************************************************
+ * File: SampleLoader.h
+ * Description: Background sample decoding with RT-safe handoff to the engines
+ *
+ * Loads requested from the GUI are decoded, resampled to the session rate and
+ * optionally peak-normalised on a small pool of loader threads. Finished
+ * samples reach the audio thread through a lock-free FIFO of pointers; the
+ * audio thread swaps the new buffer into the engine (no allocation, no copy)
+ * and hands the LoadedSample, now holding the engine's previous buffer, back
+ * through a second FIFO so the old audio is freed on a loader thread. Loads
+ * that fail come back the same way and their messages are kept for the GUI.
+ *
+ * Copyright (c) 2025 Spectral Audio Systems
+ ******************************************************************************/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "SampleMaskingEngine.h"
+#include "SpectralMask.h"
+#include "../dsp/SampleResampler.h"
+#include <array>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <vector>
+
+class SampleLoader
+{
+public:
+    // Where a finished sample goes; the audio thread dispatches on this
+    enum class Target { ForgeSlot, SampleMasking };
+
+    struct LoadedSample
+    {
+        Target target = Target::ForgeSlot;
+        int slot = 0;
+
+        bool success = false;
+        juce::String errorMessage;
+        juce::String name;                          // file name without extension
+
+        // Decoded audio at sampleRate (the session rate unless the request
+        // was made before prepareToPlay); after installation, the engine's
+        // previous buffer, waiting to be freed off the audio thread
+        std::unique_ptr<juce::AudioBuffer<float>> buffer;
+        double sampleRate = 0.0;
+        double sourceSampleRate = 0.0;
+
+        // Tempo analysis, filled in for SampleMasking targets
+        SampleMaskingEngine::TempoInfo tempo;
+
+        // Spectral-mask analysis of the first channel, filled in for ForgeSlot
+        // targets; after installation, the slot's previous analysis
+        std::vector<SpectralMask::SpectralFrame> maskFrames;
+    };
+
+    static constexpr int kMaxInFlight = 16;         // requested but not yet freed
+    static constexpr int kMaxFailuresKept = 8;      // newest load errors kept for the GUI
+
+    explicit SampleLoader(int numThreads = 2);
+    ~SampleLoader();
+
+    // Any thread but the audio thread. Rate the loader resamples to.
+    void setSessionSampleRate(double sampleRate) noexcept { sessionSampleRate.store(sampleRate); }
+
+    // Scale each sample so its peak sits at targetDb (off by default, files
+    // keep their recorded level)
+    void setPeakNormalisation(bool enabled, float targetDb = -1.0f) noexcept;
+
+    // GUI / message thread. Queues a decode; false when kMaxInFlight loads
+    // are already outstanding or the file does not exist.
+    bool requestLoad(Target target, int slot, const juce::File& file);
+
+    // Audio thread: the next finished load, or nullptr (wait-free). Every
+    // sample returned must be given back through recycle().
+    LoadedSample* popFinished() noexcept;
+
+    // Audio thread: returns a sample taken from popFinished(). Whatever it
+    // still owns (normally the engine's previous buffer) is freed on a
+    // loader thread (wait-free apart from waking that thread).
+    void recycle(LoadedSample* sample) noexcept;
+
+    // Decodes, resamples and normalises one file on the calling thread
+    // (what the loader threads run; usable directly for offline work)
+    std::unique_ptr<LoadedSample> decode(Target target, int slot, const juce::File& file);
+
+    int getNumOutstanding() const noexcept { return outstanding.load(); }
+
+    // Message thread: error messages of failed loads the audio thread has
+    // recycled since the last call, oldest first
+    juce::StringArray takeFailedLoads();
+
+private:
+    class Worker;
+
+    struct Request
+    {
+        Target target;
+        int slot;
+        juce::File file;
+    };
+
+    // Fixed-capacity pointer FIFO (one producer and one consumer at a time)
+    struct PointerFifo
+    {
+        PointerFifo() : fifo(kMaxInFlight + 1) {}   // AbstractFifo keeps one slot free
+
+        bool push(LoadedSample* sample) noexcept;
+        LoadedSample* pop() noexcept;
+
+        juce::AbstractFifo fifo;
+        std::array<LoadedSample*, kMaxInFlight + 1> slots{};
+    };
+
+    bool takeRequest(Request& request);
+    void publish(std::unique_ptr<LoadedSample> sample);
+    void collectGarbage();
+
+    juce::CriticalSection requestLock;
+    std::deque<Request> requests;
+
+    PointerFifo finished;                           // loader threads -> audio thread
+    juce::CriticalSection publishLock;              // serialises loader-side pushes
+    PointerFifo garbage;                            // audio thread -> loader threads
+    juce::CriticalSection garbageLock;              // serialises loader-side pops
+
+    juce::CriticalSection failureLock;
+    juce::StringArray failedLoads;                  // newest kMaxFailuresKept errors
+
+    std::atomic<int> outstanding{0};
+    std::atomic<double> sessionSampleRate{0.0};
+    std::atomic<bool> normalise{false};
+    std::atomic<float> normaliseTargetDb{-1.0f};
+
+    juce::AudioFormatManager formatManager;
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SampleLoader)
+};
@@ -1,4 +1,5 @@
 #include "SampleMaskingEngine.h"
+#include <algorithm>
 #include <cmath>
 #include <limits>
 #include <memory>
@@ -26,7 +27,7 @@ SampleMaskingEngine::SampleMaskingEngine()
     setQuantizationStrength(0.5f); // 50% snap strength
 
     // Initialize lock-free snapshot for audio thread consumption (C++17 portable)
-    std::atomic_store_explicit(&activeMasksSnapshot, std::make_shared<const std::vector<PaintMask>>(), std::memory_order_release);
+    std::atomic_store_explicit(&activeMasksSnapshot, std::make_shared<const std::vector<CompiledMask>>(), std::memory_order_release);
 }
 
 SampleMaskingEngine::~SampleMaskingEngine()
@@ -42,7 +43,8 @@ void SampleMaskingEngine::prepareToPlay(double sampleRate, int samplesPerBlock,
     currentSampleRate = sampleRate;
     
     // Initialize effects processors
-    maskFilter.setParams(1000.0f, 0.0f, sampleRate);
+    numFilterChannels = juce::jmax(2, numChannels);
+    maskFilters.assign(static_cast<size_t>(MAX_FILTER_MASKS * numFilterChannels), MaskFilter{});
     delayLine.setMaxDelay(2.0, sampleRate);
     
     // SAFETY: Mark engine as properly initialized
@@ -69,76 +71,43 @@ void SampleMaskingEngine::processBlock(juce::AudioBuffer<float>& buffer)
     double currentPos = playbackPosition.load();
     const double sampleLength = static_cast<double>(sampleBuffer->getNumSamples());
     
+    // Masks only change between blocks: take one snapshot, then evaluate each
+    // mask over short sub-blocks against its precompiled envelope
+    const auto masks = std::atomic_load_explicit(&activeMasksSnapshot, std::memory_order_acquire);
+    
+    const double timeStep = speed / currentSampleRate;
+    const double timeSpan = juce::jmax(1.0e-9, static_cast<double>(timeRangeEnd - timeRangeStart));
+    const double canvasXPerSecond = canvasWidth / timeSpan;
+    const float deltaX = static_cast<float>(timeStep * canvasXPerSecond);
+    float influence[MASK_CHUNK_SIZE];
+    
+    // Read the source for every channel in one pass
+    const bool looping = isLooping.load();
+    resampler.setQuality(resamplerQuality.load());
+    resampler.process(*sampleBuffer, buffer, 0, numSamples, currentPos, speed, looping);
+    
     for (int channel = 0; channel < numChannels; ++channel)
     {
         auto* channelData = buffer.getWritePointer(channel);
-        auto* sourceData = sampleBuffer->getReadPointer(juce::jmin(channel, sampleBuffer->getNumChannels() - 1));
         
-        for (int sample = 0; sample < numSamples; ++sample)
+        for (int chunkStart = 0; chunkStart < numSamples; chunkStart += MASK_CHUNK_SIZE)
         {
-            // Calculate current time in seconds
-            const double timeSeconds = (currentPos + sample * speed) / currentSampleRate;
+            const int chunkSize = juce::jmin(MASK_CHUNK_SIZE, numSamples - chunkStart);
+            const double chunkPos = currentPos + chunkStart * speed;
+            float* chunk = channelData + chunkStart;
             
-            // Get base sample value with interpolation
-            float outputSample = 0.0f;
-            const double sampleIndex = currentPos + sample * speed;
-            
-            if (sampleIndex >= 0.0 && sampleIndex < sampleLength - 1)
-            {
-                const int index = static_cast<int>(sampleIndex);
-                const float fraction = static_cast<float>(sampleIndex - index);
-                
-                // Linear interpolation
-                outputSample = sourceData[index] * (1.0f - fraction) + 
-                              sourceData[index + 1] * fraction;
-            }
+            if (masks == nullptr)
+                continue;
             
             // Apply all active masks
+            const double chunkTime = chunkPos / currentSampleRate;
+            const float chunkX = static_cast<float>((chunkTime - timeRangeStart) * canvasXPerSecond);
+            
+            for (const auto& mask : *masks)
             {
-                // Lock-free read of snapshot built on the UI thread
-                auto snapshot = std::atomic_load_explicit(&activeMasksSnapshot, std::memory_order_acquire);
-                if (snapshot)
-                for (const auto& mask : *snapshot)
-                {
-                    if (!mask.isActive) continue;
-                    
-                    switch (mask.mode)
-                    {
-                        case MaskingMode::Volume:
-                            outputSample = applyVolumeMask(mask, outputSample, timeSeconds);
-                            break;
-                        case MaskingMode::Filter:
-                            outputSample = applyFilterMask(mask, outputSample, timeSeconds);
-                            break;
-                        case MaskingMode::Pitch:
-                            outputSample = applyPitchMask(mask, outputSample, timeSeconds);
-                            break;
-                        case MaskingMode::Granular:
-                            outputSample = applyGranularMask(mask, outputSample, timeSeconds);
-                            break;
-                        case MaskingMode::Reverse:
-                            // TODO: Implement reverse playback
-                            break;
-                        case MaskingMode::Chop:
-                            outputSample = applyChopMask(mask, outputSample, timeSeconds);
-                            break;
-                        case MaskingMode::Stutter:
-                            outputSample = applyStutterMask(mask, outputSample, timeSeconds);
-                            break;
-                        case MaskingMode::Ring:
-                            outputSample = applyRingMask(mask, outputSample, timeSeconds);
-                            break;
-                        case MaskingMode::Distortion:
-                            outputSample = applyDistortionMask(mask, outputSample, timeSeconds);
-                            break;
-                        case MaskingMode::Delay:
-                            outputSample = applyDelayMask(mask, outputSample, timeSeconds);
-                            break;
-                    }
-                }
+                if (evaluateMaskEnvelope(mask, chunkX, deltaX, influence, chunkSize))
+                    applyMask(mask, channel, chunk, influence, chunkSize, chunkTime, timeStep);
             }
-            
-            channelData[sample] = outputSample;
         }
     }
     
@@ -146,7 +115,7 @@ void SampleMaskingEngine::processBlock(juce::AudioBuffer<float>& buffer)
     currentPos += numSamples * speed;
     
     // Handle looping
-    if (isLooping.load() && currentPos >= sampleLength)
+    if (looping && currentPos >= sampleLength)
     {
         currentPos = std::fmod(currentPos, sampleLength);
     }
@@ -293,6 +262,22 @@ void SampleMaskingEngine::loadSample(const juce::AudioBuffer<float>& sampleBuffe
     setTimeRange(0.0f, static_cast<float>(lengthSeconds));
 }
 
+void SampleMaskingEngine::adoptSample(std::unique_ptr<juce::AudioBuffer<float>>& buffer, double sampleRate,
+                                      juce::String& name, const TempoInfo& tempo) noexcept
+{
+    sampleBuffer.swap(buffer);
+    currentSampleName.swapWith(name);
+    sourceSampleRate = sampleRate;
+    currentTempoInfo = tempo;
+    
+    // Reset playback state
+    playbackPosition.store(0.0);
+    isPlaying.store(false);
+    
+    if (sampleBuffer != nullptr)
+        setTimeRange(0.0f, static_cast<float>(sampleBuffer->getNumSamples() / sourceSampleRate));
+}
+
 void SampleMaskingEngine::clearSample()
 {
     stopPlayback();
@@ -448,7 +433,11 @@ void SampleMaskingEngine::addPointToMask(juce::uint32 maskId, float x, float y,
     {
         if (mask.maskId == maskId)
         {
-            mask.paintPath.lineTo(x, y);
+            // The first point starts the stroke (lineTo on an empty path would start it at 0,0)
+            if (mask.paintPath.isEmpty())
+                mask.paintPath.startNewSubPath(x, y);
+            else
+                mask.paintPath.lineTo(x, y);
             break;
         }
     }
@@ -607,9 +596,129 @@ void SampleMaskingEngine::setMaskParameters(juce::uint32 maskId, float param1, f
 // Snapshot rebuild (UI thread only, must be called under maskLock)
 void SampleMaskingEngine::rebuildActiveMasksSnapshotLocked()
 {
-    // Create a new snapshot copy of activeMasks and publish atomically (C++17 portable)
-    auto copy = std::make_shared<const std::vector<PaintMask>>(activeMasks.begin(), activeMasks.end());
-    std::atomic_store_explicit(&activeMasksSnapshot, copy, std::memory_order_release);
+    // Compile the active masks into envelopes and publish atomically (C++17 portable)
+    auto compiled = std::make_shared<std::vector<CompiledMask>>();
+    compiled->reserve(activeMasks.size());
+    
+    for (const auto& mask : activeMasks)
+    {
+        if (mask.isActive && !mask.paintPath.isEmpty())
+            compiled->push_back(compileMask(mask, canvasHeight));
+    }
+    
+    // Filter masks keep their state slot for as long as they live; slots of
+    // removed masks are handed to new ones
+    auto isLiveFilterMask = [&compiled](juce::uint32 maskId)
+    {
+        return std::any_of(compiled->begin(), compiled->end(), [maskId](const CompiledMask& m)
+                           { return m.mode == MaskingMode::Filter && m.maskId == maskId; });
+    };
+    
+    for (auto& owner : filterSlotOwners)
+    {
+        if (owner != 0 && !isLiveFilterMask(owner))
+            owner = 0;
+    }
+    
+    for (auto& mask : *compiled)
+    {
+        if (mask.mode != MaskingMode::Filter)
+            continue;
+        
+        auto slot = std::find(filterSlotOwners.begin(), filterSlotOwners.end(), mask.maskId);
+        if (slot == filterSlotOwners.end())
+            slot = std::find(filterSlotOwners.begin(), filterSlotOwners.end(), juce::uint32{0});
+        if (slot == filterSlotOwners.end())
+            continue; // out of filter slots, mask is bypassed
+        
+        *slot = mask.maskId;
+        mask.filterSlot = static_cast<int>(std::distance(filterSlotOwners.begin(), slot));
+    }
+    
+    std::atomic_store_explicit(&activeMasksSnapshot,
+                               std::shared_ptr<const std::vector<CompiledMask>>(std::move(compiled)),
+                               std::memory_order_release);
+}
+
+SampleMaskingEngine::CompiledMask SampleMaskingEngine::compileMask(const PaintMask& mask, float canvasHeight)
+{
+    CompiledMask compiled;
+    compiled.maskId = mask.maskId;
+    compiled.mode = mask.mode;
+    compiled.param1 = mask.param1;
+    compiled.param2 = mask.param2;
+    compiled.param3 = mask.param3;
+    
+    const auto bounds = mask.paintPath.getBounds();
+    compiled.startX = bounds.getX();
+    compiled.endX = bounds.getRight();
+    
+    // A stroke with no horizontal extent still gets two columns so the
+    // audio thread can always interpolate between neighbours
+    const int numColumns = bounds.getWidth() > 0.0f ? ENVELOPE_COLUMNS : 2;
+    compiled.columnsPerUnit = bounds.getWidth() > 0.0f ? (numColumns - 1) / bounds.getWidth() : 0.0f;
+    
+    // Stroke height per column, averaged over every segment that crosses it
+    std::vector<float> heights(static_cast<size_t>(numColumns), 0.0f);
+    std::vector<int> hits(static_cast<size_t>(numColumns), 0);
+    
+    for (juce::PathFlatteningIterator segment(mask.paintPath); segment.next();)
+    {
+        const float p1 = (segment.x1 - compiled.startX) * compiled.columnsPerUnit;
+        const float p2 = (segment.x2 - compiled.startX) * compiled.columnsPerUnit;
+        const int first = juce::jmax(0, static_cast<int>(std::ceil(juce::jmin(p1, p2))));
+        const int last = juce::jmin(numColumns - 1, static_cast<int>(std::floor(juce::jmax(p1, p2))));
+        
+        if (first > last)
+        {
+            // Short segment between two columns: credit the nearest one
+            const int column = juce::jlimit(0, numColumns - 1, juce::roundToInt((p1 + p2) * 0.5f));
+            heights[column] += (segment.y1 + segment.y2) * 0.5f;
+            ++hits[column];
+            continue;
+        }
+        
+        for (int column = first; column <= last; ++column)
+        {
+            const float t = p2 != p1 ? (column - p1) / (p2 - p1) : 0.5f;
+            heights[column] += segment.y1 + t * (segment.y2 - segment.y1);
+            ++hits[column];
+        }
+    }
+    
+    // Columns no segment reached (e.g. between subpaths) interpolate between
+    // their nearest neighbours, and hold the end values at either edge
+    int previous = -1;
+    for (int column = 0; column <= numColumns; ++column)
+    {
+        if (column < numColumns && hits[column] == 0)
+            continue;
+        
+        if (column < numColumns)
+            heights[column] /= static_cast<float>(hits[column]);
+        
+        for (int gap = previous + 1; gap < column; ++gap)
+        {
+            if (previous < 0)
+                heights[gap] = column < numColumns ? heights[column] : 0.0f;
+            else if (column == numColumns)
+                heights[gap] = heights[previous];
+            else
+                heights[gap] = heights[previous] + (heights[column] - heights[previous])
+                                 * static_cast<float>(gap - previous) / static_cast<float>(column - previous);
+        }
+        previous = column;
+    }
+    
+    // Higher on the canvas means more influence
+    compiled.envelope.resize(static_cast<size_t>(numColumns));
+    for (int column = 0; column < numColumns; ++column)
+    {
+        const float normalizedY = (canvasHeight * 0.5f - heights[column]) / canvasHeight + 0.5f;
+        compiled.envelope[column] = juce::jlimit(0.0f, 1.0f, normalizedY) * mask.intensity;
+    }
+    
+    return compiled;
 }
 
 //==============================================================================
@@ -622,6 +731,7 @@ void SampleMaskingEngine::beginPaintStroke(float x, float y, MaskingMode mode)
     currentPaintMask->maskId = maskId;
     currentPaintMask->mode = mode;
     currentPaintMask->paintPath.startNewSubPath(x, y);
+    addPointToMask(maskId, x, y, 1.0f);
 }
 
 void SampleMaskingEngine::updatePaintStroke(float x, float y, float pressure)
@@ -648,8 +758,12 @@ void SampleMaskingEngine::endPaintStroke()
 
 void SampleMaskingEngine::setCanvasSize(float width, float height)
 {
+    juce::ScopedLock lock(maskLock);
     canvasWidth = width;
     canvasHeight = height;
+    
+    // Envelopes are normalised against the canvas height
+    rebuildActiveMasksSnapshotLocked();
 }
 
 void SampleMaskingEngine::setTimeRange(float startSeconds, float endSeconds)
@@ -671,134 +785,210 @@ float SampleMaskingEngine::sampleTimeToCanvasX(float timeSeconds) const
 //==============================================================================
 // Mask Application Methods
 
-float SampleMaskingEngine::calculateMaskInfluence(const PaintMask& mask, double currentTimeSeconds) const
+bool SampleMaskingEngine::evaluateMaskEnvelope(const CompiledMask& mask, float startX, float deltaX,
+                                               float* influence, int numSamples)
 {
-    const float canvasX = sampleTimeToCanvasX(static_cast<float>(currentTimeSeconds));
+    const float lastX = startX + deltaX * static_cast<float>(numSamples - 1);
+    if (juce::jmax(startX, lastX) < mask.startX || juce::jmin(startX, lastX) > mask.endX)
+        return false;
     
-    // Check if current time intersects with mask path
-    auto bounds = mask.paintPath.getBounds();
-    if (canvasX < bounds.getX() || canvasX > bounds.getRight())
-        return 0.0f;
+    const float* envelope = mask.envelope.data();
+    const float lastColumn = static_cast<float>(mask.envelope.size() - 1);
+    const int maxIndex = static_cast<int>(mask.envelope.size()) - 2;
     
-    // Simple vertical intersection test
-    // In a real implementation, this would be more sophisticated
-    const float normalizedY = (canvasHeight * 0.5f - bounds.getCentreY()) / canvasHeight + 0.5f;
-    return juce::jlimit(0.0f, 1.0f, normalizedY) * mask.intensity;
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float x = startX + deltaX * static_cast<float>(i);
+        const float position = juce::jlimit(0.0f, lastColumn, (x - mask.startX) * mask.columnsPerUnit);
+        const int index = juce::jmin(static_cast<int>(position), maxIndex);
+        const float fraction = position - static_cast<float>(index);
+        const float value = envelope[index] + fraction * (envelope[index + 1] - envelope[index]);
+        
+        influence[i] = (x >= mask.startX && x <= mask.endX) ? value : 0.0f;
+    }
+    
+    return true;
 }
 
-float SampleMaskingEngine::applyVolumeMask(const PaintMask& mask, float input, double timeSeconds)
+void SampleMaskingEngine::applyMask(const CompiledMask& mask, int channel, float* samples, const float* influence,
+                                    int numSamples, double startTime, double timeStep)
+{
+    switch (mask.mode)
+    {
+        case MaskingMode::Volume:
+            applyVolumeMask(mask, samples, influence, numSamples, startTime, timeStep);
+            break;
+        case MaskingMode::Filter:
+            applyFilterMask(mask, channel, samples, influence, numSamples);
+            break;
+        case MaskingMode::Pitch:
+            applyPitchMask(mask, samples, influence, numSamples, startTime, timeStep);
+            break;
+        case MaskingMode::Granular:
+            applyGranularMask(mask, samples, influence, numSamples, startTime, timeStep);
+            break;
+        case MaskingMode::Reverse:
+            // TODO: Implement reverse playback
+            break;
+        case MaskingMode::Chop:
+            applyChopMask(mask, samples, influence, numSamples, startTime, timeStep);
+            break;
+        case MaskingMode::Stutter:
+            applyStutterMask(mask, samples, influence, numSamples, startTime, timeStep);
+            break;
+        case MaskingMode::Ring:
+            applyRingMask(mask, samples, influence, numSamples, startTime, timeStep);
+            break;
+        case MaskingMode::Distortion:
+            applyDistortionMask(mask, samples, influence, numSamples, startTime, timeStep);
+            break;
+        case MaskingMode::Delay:
+            applyDelayMask(mask, samples, influence, numSamples, startTime, timeStep);
+            break;
+    }
+}
+
+void SampleMaskingEngine::applyVolumeMask(const CompiledMask& mask, float* samples, const float* influence,
+                                          int numSamples, double, double)
 {
-    const float influence = calculateMaskInfluence(mask, timeSeconds);
-    if (influence <= 0.0f) return input;
-    
     const float minLevel = mask.param1;
     const float maxLevel = mask.param2;
-    const float targetVolume = minLevel + influence * (maxLevel - minLevel);
     
-    return input * targetVolume;
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float targetVolume = minLevel + influence[i] * (maxLevel - minLevel);
+        samples[i] *= influence[i] > 0.0f ? targetVolume : 1.0f;
+    }
 }
 
-float SampleMaskingEngine::applyFilterMask(const PaintMask& mask, float input, double timeSeconds)
+void SampleMaskingEngine::applyFilterMask(const CompiledMask& mask, int channel, float* samples, const float* influence,
+                                          int numSamples)
 {
-    const float influence = calculateMaskInfluence(mask, timeSeconds);
-    if (influence <= 0.0f) return input;
+    if (mask.filterSlot < 0 || channel >= numFilterChannels)
+        return;
     
-    const float minCutoff = mask.param1;
-    const float maxCutoff = mask.param2;
-    const float targetCutoff = minCutoff + influence * (maxCutoff - minCutoff);
+    // Each filter mask owns one state per channel; a slot handed over to a
+    // new mask starts from silence
+    auto& filter = maskFilters[static_cast<size_t>(mask.filterSlot * numFilterChannels + channel)];
+    if (filter.maskId != mask.maskId)
+        filter.reset(mask.maskId);
     
-    maskFilter.setParams(targetCutoff, mask.param3, currentSampleRate);
-    return maskFilter.process(input);
+    filter.process(samples, influence, numSamples, mask.param1, mask.param2, mask.param3, currentSampleRate);
 }
 
-float SampleMaskingEngine::applyPitchMask(const PaintMask& mask, float input, double timeSeconds)
+void SampleMaskingEngine::applyPitchMask(const CompiledMask& mask, float* samples, const float* influence,
+                                         int numSamples, double, double)
 {
-    const float influence = calculateMaskInfluence(mask, timeSeconds);
-    if (influence <= 0.0f) return input;
-    
     // Simple pitch shifting placeholder
     // Real implementation would use phase vocoder or granular synthesis
     const float minSemitones = mask.param1;
     const float maxSemitones = mask.param2;
-    const float pitchShift = minSemitones + influence * (maxSemitones - minSemitones);
     
-    // For now, just apply gain change (crude pitch effect)
-    const float pitchGain = std::pow(2.0f, pitchShift / 12.0f);
-    return input * pitchGain;
+    for (int i = 0; i < numSamples; ++i)
+    {
+        if (influence[i] <= 0.0f) continue;
+        
+        // For now, just apply gain change (crude pitch effect)
+        const float pitchShift = minSemitones + influence[i] * (maxSemitones - minSemitones);
+        samples[i] *= std::pow(2.0f, pitchShift / 12.0f);
+    }
 }
 
-float SampleMaskingEngine::applyGranularMask(const PaintMask& mask, float input, double timeSeconds)
+void SampleMaskingEngine::applyGranularMask(const CompiledMask&, float* samples, const float* influence,
+                                            int numSamples, double startTime, double timeStep)
 {
-    const float influence = calculateMaskInfluence(mask, timeSeconds);
-    if (influence <= 0.0f) return input;
-    
     // Granular processing with mask influence
-    const double samplePos = timeSeconds * currentSampleRate;
-    return granularProcessor.processGrains(*sampleBuffer, samplePos) * influence + input * (1.0f - influence);
+    for (int i = 0; i < numSamples; ++i)
+    {
+        if (influence[i] <= 0.0f) continue;
+        
+        const double samplePos = (startTime + i * timeStep) * currentSampleRate;
+        samples[i] = granularProcessor.processGrains(*sampleBuffer, samplePos) * influence[i]
+                   + samples[i] * (1.0f - influence[i]);
+    }
 }
 
-float SampleMaskingEngine::applyChopMask(const PaintMask& mask, float input, double timeSeconds)
+void SampleMaskingEngine::applyChopMask(const CompiledMask& mask, float* samples, const float* influence,
+                                        int numSamples, double startTime, double timeStep)
 {
-    const float influence = calculateMaskInfluence(mask, timeSeconds);
-    if (influence <= 0.0f) return input;
-    
     const float chopRate = mask.param1;
-    const float chopPhase = std::fmod(static_cast<float>(timeSeconds * chopRate), 1.0f);
-    const bool isChopped = chopPhase < 0.5f;
     
-    return isChopped ? input * mask.param2 * influence : input;
+    for (int i = 0; i < numSamples; ++i)
+    {
+        if (influence[i] <= 0.0f) continue;
+        
+        const double timeSeconds = startTime + i * timeStep;
+        const float chopPhase = std::fmod(static_cast<float>(timeSeconds * chopRate), 1.0f);
+        if (chopPhase < 0.5f)
+            samples[i] *= mask.param2 * influence[i];
+    }
 }
 
-float SampleMaskingEngine::applyStutterMask(const PaintMask& mask, float input, double timeSeconds)
+void SampleMaskingEngine::applyStutterMask(const CompiledMask& mask, float* samples, const float* influence,
+                                           int numSamples, double startTime, double timeStep)
 {
-    const float influence = calculateMaskInfluence(mask, timeSeconds);
-    if (influence <= 0.0f) return input;
-    
     const float stutterRate = mask.param1;
     const float stutterLength = mask.param2;
-    const float phase = std::fmod(static_cast<float>(timeSeconds * stutterRate), 1.0f);
     
-    return (phase < stutterLength) ? input * influence : input * (1.0f - influence);
+    for (int i = 0; i < numSamples; ++i)
+    {
+        if (influence[i] <= 0.0f) continue;
+        
+        const double timeSeconds = startTime + i * timeStep;
+        const float phase = std::fmod(static_cast<float>(timeSeconds * stutterRate), 1.0f);
+        samples[i] *= (phase < stutterLength) ? influence[i] : (1.0f - influence[i]);
+    }
 }
 
-float SampleMaskingEngine::applyRingMask(const PaintMask& mask, float input, double timeSeconds)
+void SampleMaskingEngine::applyRingMask(const CompiledMask& mask, float* samples, const float* influence,
+                                        int numSamples, double startTime, double timeStep)
 {
-    const float influence = calculateMaskInfluence(mask, timeSeconds);
-    if (influence <= 0.0f) return input;
-    
     const float frequency = mask.param1;
     const float depth = mask.param2;
-    const float ringMod = std::sin(static_cast<float>(timeSeconds * frequency * 2.0 * juce::MathConstants<float>::pi));
     
-    return input * (1.0f + ringMod * depth * influence);
+    for (int i = 0; i < numSamples; ++i)
+    {
+        if (influence[i] <= 0.0f) continue;
+        
+        const double timeSeconds = startTime + i * timeStep;
+        const float ringMod = std::sin(static_cast<float>(timeSeconds * frequency * 2.0 * juce::MathConstants<float>::pi));
+        samples[i] *= 1.0f + ringMod * depth * influence[i];
+    }
 }
 
-float SampleMaskingEngine::applyDistortionMask(const PaintMask& mask, float input, double timeSeconds)
+void SampleMaskingEngine::applyDistortionMask(const CompiledMask& mask, float* samples, const float* influence,
+                                              int numSamples, double, double)
 {
-    const float influence = calculateMaskInfluence(mask, timeSeconds);
-    if (influence <= 0.0f) return input;
-    
     const float drive = mask.param1;
     const float mix = mask.param2;
     
-    const float driven = std::tanh(input * drive * influence);
-    return input * (1.0f - mix * influence) + driven * mix * influence;
+    for (int i = 0; i < numSamples; ++i)
+    {
+        if (influence[i] <= 0.0f) continue;
+        
+        const float driven = std::tanh(samples[i] * drive * influence[i]);
+        samples[i] = samples[i] * (1.0f - mix * influence[i]) + driven * mix * influence[i];
+    }
 }
 
-float SampleMaskingEngine::applyDelayMask(const PaintMask& mask, float input, double timeSeconds)
+void SampleMaskingEngine::applyDelayMask(const CompiledMask& mask, float* samples, const float* influence,
+                                         int numSamples, double, double)
 {
-    const float influence = calculateMaskInfluence(mask, timeSeconds);
-    if (influence <= 0.0f) return input;
-    
-    const float delayTime = mask.param1;
+    const float delayInSamples = mask.param1 * static_cast<float>(currentSampleRate);
     const float feedback = mask.param2;
     const float mix = mask.param3;
     
-    delayLine.write(input);
-    const float delayed = delayLine.readInterpolated(delayTime * static_cast<float>(currentSampleRate));
-    delayLine.write(input + delayed * feedback * influence);
-    
-    return input * (1.0f - mix * influence) + delayed * mix * influence;
+    for (int i = 0; i < numSamples; ++i)
+    {
+        if (influence[i] <= 0.0f) continue;
+        
+        const float input = samples[i];
+        delayLine.write(input);
+        const float delayed = delayLine.readInterpolated(delayInSamples);
+        delayLine.write(input + delayed * feedback * influence[i]);
+        
+        samples[i] = input * (1.0f - mix * influence[i]) + delayed * mix * influence[i];
+    }
 }
 
 //==============================================================================
@@ -845,22 +1035,59 @@ juce::StringArray SampleMaskingEngine::getLayerNames() const
 //==============================================================================
 // Helper Classes Implementation
 
-void SampleMaskingEngine::MaskFilter::setParams(float newCutoff, float newResonance, double sampleRate)
+void SampleMaskingEngine::MaskFilter::reset(juce::uint32 newMaskId)
 {
-    cutoff = newCutoff;
-    resonance = newResonance;
-    
-    f = 2.0f * std::sin(static_cast<float>(juce::MathConstants<float>::pi) * cutoff / static_cast<float>(sampleRate));
-    fb = resonance + resonance / (1.0f - f);
+    maskId = newMaskId;
+    ic1eq = ic2eq = 0.0f;
+    hasCoefficients = false;
 }
 
-float SampleMaskingEngine::MaskFilter::process(float input)
+void SampleMaskingEngine::MaskFilter::process(float* samples, const float* influence, int numSamples,
+                                              float minCutoff, float maxCutoff, float resonance, double sampleRate)
 {
-    low += f * band;
-    high = input - low - fb * band;
-    band += f * high;
+    const float nyquistLimit = static_cast<float>(sampleRate) * 0.49f;
+    const float k = 2.0f - 2.0f * juce::jlimit(0.0f, 0.98f, resonance); // damping
     
-    return low; // Low-pass output
+    for (int start = 0; start < numSamples; start += FILTER_CONTROL_INTERVAL)
+    {
+        const int count = juce::jmin(FILTER_CONTROL_INTERVAL, numSamples - start);
+        
+        // Cutoff target for the end of this control step
+        const float cutoff = juce::jlimit(20.0f, nyquistLimit,
+                                          minCutoff + influence[start + count - 1] * (maxCutoff - minCutoff));
+        const float g = std::tan(juce::MathConstants<float>::pi * cutoff / static_cast<float>(sampleRate));
+        const float targetA1 = 1.0f / (1.0f + g * (g + k));
+        const float targetA2 = g * targetA1;
+        const float targetA3 = g * targetA2;
+        
+        if (!hasCoefficients)
+        {
+            a1 = targetA1; a2 = targetA2; a3 = targetA3;
+            hasCoefficients = true;
+        }
+        
+        const float step = 1.0f / static_cast<float>(count);
+        const float d1 = (targetA1 - a1) * step;
+        const float d2 = (targetA2 - a2) * step;
+        const float d3 = (targetA3 - a3) * step;
+        
+        // The filter runs through the whole run so its state is continuous;
+        // only samples inside the mask take the filtered output
+        for (int i = start; i < start + count; ++i)
+        {
+            a1 += d1; a2 += d2; a3 += d3;
+            
+            const float v3 = samples[i] - ic2eq;
+            const float v1 = a1 * ic1eq + a2 * v3;
+            const float v2 = ic2eq + a2 * ic1eq + a3 * v3;
+            ic1eq = 2.0f * v1 - ic1eq;
+            ic2eq = 2.0f * v2 - ic2eq;
+            
+            samples[i] = influence[i] > 0.0f ? v2 : samples[i];
+        }
+        
+        a1 = targetA1; a2 = targetA2; a3 = targetA3;
+    }
 }
 
 void SampleMaskingEngine::DelayLine::setMaxDelay(double maxDelaySeconds, double sampleRate)
@@ -953,6 +1180,13 @@ SampleMaskingEngine::TempoInfo SampleMaskingEngine::detectSampleTempo()
     return currentTempoInfo;
 }
 
+SampleMaskingEngine::TempoInfo SampleMaskingEngine::analyseTempo(const juce::AudioBuffer<float>& buffer, double sampleRate)
+{
+    SpectralAnalyzer analyzer;
+    analyzer.analyzeBuffer(buffer, sampleRate);
+    return analyzer.getTempoInfo();
+}
+
 void SampleMaskingEngine::setSampleTempo(double bpm)
 {
     sampleTempo.store(juce::jlimit(30.0, 300.0, bpm)); // Wider range for varied samples
@@ -1,5 +1,6 @@
 #pragma once
 #include <JuceHeader.h>
+#include "../dsp/SampleResampler.h"
 #include <memory>
 #include <atomic>
 #include <vector>
@@ -76,6 +77,16 @@ public:
     };
     
     TempoInfo detectSampleTempo();
+    
+    // Tempo analysis of any buffer with a private analyser, so it can run on
+    // a loader thread (SampleLoader) instead of the audio thread
+    static TempoInfo analyseTempo(const juce::AudioBuffer<float>& buffer, double sampleRate);
+    
+    // Audio thread: installs a sample decoded off-thread by swapping it in.
+    // buffer and name come back holding the previous sample (if any) so the
+    // caller can free it elsewhere. No allocation, no copy.
+    void adoptSample(std::unique_ptr<juce::AudioBuffer<float>>& buffer, double sampleRate,
+                     juce::String& name, const TempoInfo& tempo) noexcept;
     void setSampleTempo(double bpm);
     void enableTempoSync(bool enabled) { tempoSyncEnabled.store(enabled); }
     bool isTempoSyncEnabled() const { return tempoSyncEnabled.load(); }
@@ -100,6 +111,10 @@ public:
     void setPlaybackSpeed(float speed) { playbackSpeed.store(juce::jlimit(0.1f, 4.0f, speed)); }
     void setPlaybackPosition(float normalizedPosition); // 0.0-1.0
     
+    // Source interpolation: Linear is cheapest, the sinc tiers stay clean when sped up
+    void setResamplerQuality(SampleResampler::Quality quality) { resamplerQuality.store(quality); }
+    SampleResampler::Quality getResamplerQuality() const { return resamplerQuality.load(); }
+    
     //==============================================================================
     // Paint Masking System - The Revolutionary Part!
     
@@ -234,6 +249,9 @@ private:
     std::atomic<bool> isPlaying{false};
     std::atomic<bool> isLooping{true};
     
+    SampleResampler resampler;
+    std::atomic<SampleResampler::Quality> resamplerQuality{SampleResampler::Quality::Sinc16};
+    
     //==============================================================================
     // Masking System Implementation
     
@@ -241,10 +259,35 @@ private:
     juce::uint32 nextMaskId = 1;
     std::unique_ptr<PaintMask> currentPaintMask;
 
-    // Lock-free snapshot of active masks for the audio thread
+    // Audio-thread form of a PaintMask. The stroke is rasterised once into an
+    // influence-vs-canvas-X envelope, so processBlock never touches the Path.
+    struct CompiledMask
+    {
+        juce::uint32 maskId = 0;
+        MaskingMode mode = MaskingMode::Volume;
+        float param1 = 0.0f;
+        float param2 = 1.0f;
+        float param3 = 0.0f;
+        float startX = 0.0f;             // cached stroke bounds on the canvas X axis
+        float endX = 0.0f;
+        float columnsPerUnit = 0.0f;     // envelope columns per canvas X unit
+        std::vector<float> envelope;     // influence per column, intensity applied
+        int filterSlot = -1;             // filter masks: index of their state in maskFilters
+    };
+
+    static constexpr int ENVELOPE_COLUMNS = 256;
+    static constexpr int MASK_CHUNK_SIZE = 32;   // samples evaluated per mask pass
+    static constexpr int MAX_FILTER_MASKS = 32;  // filter masks beyond this are bypassed
+    static constexpr int FILTER_CONTROL_INTERVAL = 16; // samples per cutoff update
+
+    // Filter slots owned by each live filter mask (0 = free), kept under maskLock
+    std::array<juce::uint32, MAX_FILTER_MASKS> filterSlotOwners{};
+
+    // Lock-free snapshot of compiled masks for the audio thread
     // UI thread rebuilds a shared_ptr snapshot after any mutation under maskLock
-    std::shared_ptr<const std::vector<PaintMask>> activeMasksSnapshot; // C++17 with free function atomics
+    std::shared_ptr<const std::vector<CompiledMask>> activeMasksSnapshot; // C++17 with free function atomics
     void rebuildActiveMasksSnapshotLocked();
+    static CompiledMask compileMask(const PaintMask& mask, float canvasHeight);
     
     // Canvas coordinate system
     float canvasWidth = 1000.0f;
@@ -255,16 +298,19 @@ private:
     //==============================================================================
     // Real-Time Processing Effects
     
-    // Filter for filter-mode masks
+    // Filter for filter-mode masks: a TPT state-variable low-pass, which stays
+    // well behaved while its cutoff is swept. Coefficients are computed once per
+    // control interval and ramped linearly in between.
     struct MaskFilter
     {
-        float cutoff = 1000.0f;
-        float resonance = 0.0f;
-        float low = 0.0f, band = 0.0f, high = 0.0f;
-        float f = 0.0f, fb = 0.0f;
+        juce::uint32 maskId = 0;          // mask this state currently belongs to
+        float ic1eq = 0.0f, ic2eq = 0.0f;
+        float a1 = 0.0f, a2 = 0.0f, a3 = 0.0f;
+        bool hasCoefficients = false;
         
-        void setParams(float newCutoff, float newResonance, double sampleRate);
-        float process(float input);
+        void reset(juce::uint32 newMaskId);
+        void process(float* samples, const float* influence, int numSamples,
+                     float minCutoff, float maxCutoff, float resonance, double sampleRate);
     };
     
     // Granular engine for granular-mode masks
@@ -300,23 +346,31 @@ private:
         float readInterpolated(float delayInSamples);
     };
     
-    MaskFilter maskFilter;
+    std::vector<MaskFilter> maskFilters;   // MAX_FILTER_MASKS slots x numFilterChannels
+    int numFilterChannels = 0;
     GranularProcessor granularProcessor;
     DelayLine delayLine;
     
     //==============================================================================
     // Mask Application Engine
     
-    float calculateMaskInfluence(const PaintMask& mask, double currentTimeSeconds) const;
-    float applyVolumeMask(const PaintMask& mask, float input, double timeSeconds);
-    float applyFilterMask(const PaintMask& mask, float input, double timeSeconds);
-    float applyPitchMask(const PaintMask& mask, float input, double timeSeconds);
-    float applyGranularMask(const PaintMask& mask, float input, double timeSeconds);
-    float applyChopMask(const PaintMask& mask, float input, double timeSeconds);
-    float applyStutterMask(const PaintMask& mask, float input, double timeSeconds);
-    float applyRingMask(const PaintMask& mask, float input, double timeSeconds);
-    float applyDistortionMask(const PaintMask& mask, float input, double timeSeconds);
-    float applyDelayMask(const PaintMask& mask, float input, double timeSeconds);
+    // Fills influence[] for samples at canvas X = startX + i * deltaX. Returns
+    // false (leaving influence[] untouched) when the run misses the mask.
+    static bool evaluateMaskEnvelope(const CompiledMask& mask, float startX, float deltaX,
+                                     float* influence, int numSamples);
+
+    // Each mask pass processes one sub-block in place; sample i is at time
+    // startTime + i * timeStep and is left alone where influence[i] is zero.
+    void applyMask(const CompiledMask& mask, int channel, float* samples, const float* influence, int numSamples, double startTime, double timeStep);
+    void applyVolumeMask(const CompiledMask& mask, float* samples, const float* influence, int numSamples, double startTime, double timeStep);
+    void applyFilterMask(const CompiledMask& mask, int channel, float* samples, const float* influence, int numSamples);
+    void applyPitchMask(const CompiledMask& mask, float* samples, const float* influence, int numSamples, double startTime, double timeStep);
+    void applyGranularMask(const CompiledMask& mask, float* samples, const float* influence, int numSamples, double startTime, double timeStep);
+    void applyChopMask(const CompiledMask& mask, float* samples, const float* influence, int numSamples, double startTime, double timeStep);
+    void applyStutterMask(const CompiledMask& mask, float* samples, const float* influence, int numSamples, double startTime, double timeStep);
+    void applyRingMask(const CompiledMask& mask, float* samples, const float* influence, int numSamples, double startTime, double timeStep);
+    void applyDistortionMask(const CompiledMask& mask, float* samples, const float* influence, int numSamples, double startTime, double timeStep);
+    void applyDelayMask(const CompiledMask& mask, float* samples, const float* influence, int numSamples, double startTime, double timeStep);
     
     //==============================================================================
     // Polyrhythmic Layer System
@@ -0,0 +1,329 @@
+/******************************************************************************
+ * File: SampleStreamer.cpp
+ * Description: Disk streaming with preloaded heads for large sample libraries
+ *
+ * Copyright (c) 2025 Spectral Audio Systems
+ ******************************************************************************/
+
+#include "SampleStreamer.h"
+
+namespace
+{
+    constexpr int sleepTimeoutMs = 20;              // only bounds how long shutdown can take
+    constexpr int minFillFrames = 1024;             // smaller top-ups wait unless they finish the file
+    constexpr int maxFillFrames = 8192;             // one read, so a busy stream cannot starve the others
+
+    void copyFrames(const juce::AudioBuffer<float>& source, int sourceChannels, int sourceStart,
+                    float* const* dest, int numChannels, int destStart, int numFrames) noexcept
+    {
+        for (int channel = 0; channel < numChannels; ++channel)
+            juce::FloatVectorOperations::copy(dest[channel] + destStart,
+                                              source.getReadPointer(juce::jmin(channel, sourceChannels - 1), sourceStart),
+                                              numFrames);
+    }
+}
+
+//==============================================================================
+class SampleStreamer::IOThread : public juce::Thread
+{
+public:
+    explicit IOThread(SampleStreamer& owner)
+        : juce::Thread("Sample streamer"), streamer(owner)
+    {
+    }
+
+    void run() override
+    {
+        while (! threadShouldExit())
+        {
+            if (! streamer.serviceStreams())
+                wakeEvent.wait(sleepTimeoutMs);
+        }
+    }
+
+    void wake() noexcept { wakeEvent.signal(); }
+
+    void stop()
+    {
+        signalThreadShouldExit();
+        wakeEvent.signal();
+        stopThread(2000);
+    }
+
+private:
+    SampleStreamer& streamer;
+    juce::WaitableEvent wakeEvent;
+};
+
+//==============================================================================
+SampleStreamer::SampleStreamer()
+{
+    formatManager.registerBasicFormats();
+    samples.resize(kMaxSamples);
+}
+
+SampleStreamer::~SampleStreamer()
+{
+    releaseResources();
+}
+
+void SampleStreamer::prepare(int maxStreams, int ringFrames)
+{
+    releaseResources();
+
+    ringCapacity = juce::jmax(maxFillFrames, ringFrames);
+    for (int i = 0; i < maxStreams; ++i)
+        streams.push_back(std::make_unique<Stream>(ringCapacity));
+
+    memoryUsage += (size_t) maxStreams * 2 * (size_t) (ringCapacity + 1) * sizeof(float);
+
+    ioThread = std::make_unique<IOThread>(*this);
+    ioThread->startThread(juce::Thread::Priority::high);
+}
+
+void SampleStreamer::releaseResources()
+{
+    if (ioThread != nullptr)
+    {
+        ioThread->stop();
+        ioThread.reset();
+    }
+
+    memoryUsage -= streams.size() * 2 * (size_t) (ringCapacity + 1) * sizeof(float);
+    streams.clear();
+}
+
+//==============================================================================
+int SampleStreamer::addSample(const juce::File& file)
+{
+    const juce::ScopedLock lock(addLock);
+
+    const int index = numSamples.load();
+    if (index >= kMaxSamples || ! file.existsAsFile())
+        return -1;
+
+    auto sample = std::make_unique<StreamedSample>();
+    sample->file = file;
+
+    // Uncompressed formats are mapped so the I/O thread reads straight from
+    // the page cache; everything else goes through a regular reader
+    if (auto* format = formatManager.findFormatForFileExtension(file.getFileExtension()))
+    {
+        std::unique_ptr<juce::MemoryMappedAudioFormatReader> mapped(format->createMemoryMappedReader(file));
+        if (mapped != nullptr && mapped->mapEntireFile())
+        {
+            sample->reader = std::move(mapped);
+            sample->memoryMapped = true;
+        }
+    }
+
+    if (sample->reader == nullptr)
+        sample->reader.reset(formatManager.createReaderFor(file));
+
+    auto* reader = sample->reader.get();
+    if (reader == nullptr || reader->lengthInSamples <= 0 || reader->numChannels < 1 || reader->sampleRate <= 0.0)
+        return -1;
+
+    sample->length = reader->lengthInSamples;
+    sample->sampleRate = reader->sampleRate;
+    sample->numChannels = juce::jmin(2, (int) reader->numChannels);
+
+    const auto headLength = (int) juce::jmin(sample->length,
+                                             (juce::int64) std::ceil(preloadMs * sample->sampleRate / 1000.0));
+    sample->head.setSize(sample->numChannels, headLength);
+    if (! reader->read(&sample->head, 0, headLength, 0, true, true))
+        return -1;
+
+    memoryUsage += (size_t) sample->numChannels * (size_t) headLength * sizeof(float);
+
+    samples[(size_t) index] = std::move(sample);
+    numSamples.store(index + 1, std::memory_order_release);
+    return index;
+}
+
+double SampleStreamer::getSampleRate(int sample) const noexcept
+{
+    return juce::isPositiveAndBelow(sample, getNumSamples()) ? samples[(size_t) sample]->sampleRate : 0.0;
+}
+
+juce::int64 SampleStreamer::getLengthInFrames(int sample) const noexcept
+{
+    return juce::isPositiveAndBelow(sample, getNumSamples()) ? samples[(size_t) sample]->length : 0;
+}
+
+int SampleStreamer::getNumChannels(int sample) const noexcept
+{
+    return juce::isPositiveAndBelow(sample, getNumSamples()) ? samples[(size_t) sample]->numChannels : 0;
+}
+
+//==============================================================================
+bool SampleStreamer::start(Cursor& cursor, int sample) noexcept
+{
+    stop(cursor);
+
+    if (! juce::isPositiveAndBelow(sample, getNumSamples()))
+        return false;
+
+    cursor.sample = sample;
+    cursor.position = 0;
+
+    const auto& source = *samples[(size_t) sample];
+    if (source.length <= source.head.getNumSamples())
+        return true;
+
+    for (int i = 0; i < (int) streams.size(); ++i)
+    {
+        auto& stream = *streams[(size_t) i];
+        if (stream.state.load(std::memory_order_acquire) != Free)
+            continue;
+
+        stream.sample = sample;
+        stream.state.store(Active, std::memory_order_release);
+        cursor.stream = i;
+        ioThread->wake();
+        break;
+    }
+
+    return true;
+}
+
+int SampleStreamer::read(Cursor& cursor, float* const* dest, int numChannels, int numFrames) noexcept
+{
+    if (cursor.sample < 0)
+    {
+        for (int channel = 0; channel < numChannels; ++channel)
+            juce::FloatVectorOperations::clear(dest[channel], numFrames);
+        return 0;
+    }
+
+    const auto& source = *samples[(size_t) cursor.sample];
+    const int headLength = source.head.getNumSamples();
+
+    // Without a stream the head is all this cursor will ever play
+    const auto length = cursor.stream < 0 ? (juce::int64) headLength : source.length;
+    const auto available = (int) juce::jlimit((juce::int64) 0, (juce::int64) numFrames, length - cursor.position);
+
+    int done = 0;
+    if (cursor.position < headLength)
+    {
+        done = juce::jmin(available, headLength - (int) cursor.position);
+        copyFrames(source.head, source.numChannels, (int) cursor.position, dest, numChannels, 0, done);
+        cursor.position += done;
+    }
+
+    if (done < available)
+    {
+        auto& stream = *streams[(size_t) cursor.stream];
+
+        const int freeBefore = stream.fifo.getFreeSpace();
+
+        int start1, size1, start2, size2;
+        stream.fifo.prepareToRead(available - done, start1, size1, start2, size2);
+        if (size1 > 0)
+            copyFrames(stream.ring, source.numChannels, start1, dest, numChannels, done, size1);
+        if (size2 > 0)
+            copyFrames(stream.ring, source.numChannels, start2, dest, numChannels, done + size1, size2);
+        stream.fifo.finishedRead(size1 + size2);
+
+        done += size1 + size2;
+        cursor.position += size1 + size2;
+
+        if (done < available)
+        {
+            underruns.fetch_add(1, std::memory_order_relaxed);
+            for (int channel = 0; channel < numChannels; ++channel)
+                juce::FloatVectorOperations::clear(dest[channel] + done, available - done);
+        }
+
+        // Voices read small blocks, so only wake the I/O thread when this
+        // read makes the ring worth topping up (or it ran dry)
+        if ((freeBefore < minFillFrames && freeBefore + size1 + size2 >= minFillFrames) || done < available)
+            ioThread->wake();
+    }
+
+    for (int channel = 0; channel < numChannels; ++channel)
+        juce::FloatVectorOperations::clear(dest[channel] + available, numFrames - available);
+
+    return available;
+}
+
+void SampleStreamer::stop(Cursor& cursor) noexcept
+{
+    if (cursor.stream >= 0)
+    {
+        streams[(size_t) cursor.stream]->state.store(Released, std::memory_order_release);
+        ioThread->wake();
+    }
+
+    cursor = {};
+}
+
+//==============================================================================
+bool SampleStreamer::serviceStreams()
+{
+    // Top up the stream closest to running dry; repeat until all are full
+    Stream* neediest = nullptr;
+    int neediestReady = 0;
+    int neediestFrames = 0;
+
+    for (auto& streamPtr : streams)
+    {
+        auto& stream = *streamPtr;
+        const int state = stream.state.load(std::memory_order_acquire);
+
+        if (state == Released)
+        {
+            // The audio thread has let go of the ring; empty it for reuse
+            stream.fifo.reset();
+            stream.primed = false;
+            stream.state.store(Free, std::memory_order_release);
+            continue;
+        }
+
+        if (state != Active)
+            continue;
+
+        const auto& source = *samples[(size_t) stream.sample];
+        if (! stream.primed)
+        {
+            stream.fillPosition = source.head.getNumSamples();
+            stream.primed = true;
+        }
+
+        const auto remaining = source.length - stream.fillPosition;
+        const int frames = (int) juce::jmin((juce::int64) stream.fifo.getFreeSpace(), remaining);
+        if (frames <= 0 || (frames < minFillFrames && frames < remaining))
+            continue;
+
+        const int ready = stream.fifo.getNumReady();
+        if (neediest == nullptr || ready < neediestReady)
+        {
+            neediest = &stream;
+            neediestReady = ready;
+            neediestFrames = frames;
+        }
+    }
+
+    if (neediest == nullptr)
+        return false;
+
+    fill(*neediest, juce::jmin(neediestFrames, maxFillFrames));
+    return true;
+}
+
+void SampleStreamer::fill(Stream& stream, int numFrames)
+{
+    auto* reader = samples[(size_t) stream.sample]->reader.get();
+
+    int start1, size1, start2, size2;
+    stream.fifo.prepareToWrite(numFrames, start1, size1, start2, size2);
+
+    // A failed read leaves silence in the ring; playback carries on regardless
+    if (size1 > 0)
+        reader->read(&stream.ring, start1, size1, stream.fillPosition, true, true);
+    if (size2 > 0)
+        reader->read(&stream.ring, start2, size2, stream.fillPosition + size1, true, true);
+
+    stream.fillPosition += size1 + size2;
+    stream.fifo.finishedWrite(size1 + size2);
+}
@@ -0,0 +1,124 @@
+/******************************************************************************
+ * File: SampleStreamer.h
+ * Description: Disk streaming with preloaded heads for large sample libraries
+ *
+ * Only the first few milliseconds of every sample live in RAM, so a note can
+ * start the moment it is triggered and switching programs loads nothing.
+ * Each playing voice is given a stream: a ring buffer that a background I/O
+ * thread keeps filled ahead of the play position, least-filled stream first.
+ * Uncompressed WAV/AIFF files are read through memory-mapped readers, other
+ * formats through ordinary ones. Memory use is the heads plus a fixed pool of
+ * rings, whatever the size of the library.
+ *
+ * Copyright (c) 2025 Spectral Audio Systems
+ ******************************************************************************/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+class SampleStreamer
+{
+public:
+    static constexpr int kMaxSamples = 4096;
+    static constexpr int kDefaultPreloadMs = 100;
+
+    // One playing voice's view of a sample. Owned by the audio thread.
+    struct Cursor
+    {
+        int sample = -1;
+        int stream = -1;                            // -1: the sample is played from RAM only
+        juce::int64 position = 0;                   // next frame to read
+    };
+
+    SampleStreamer();
+    ~SampleStreamer();
+
+    // Message thread, with no cursors open. Allocates maxStreams rings of
+    // ringFrames each; voices beyond that play the preloaded heads only.
+    void prepare(int maxStreams, int ringFrames = 16384);
+    void releaseResources();
+
+    // Length of the head kept in RAM for samples added afterwards
+    void setPreloadTime(int milliseconds) noexcept { preloadMs = juce::jmax(1, milliseconds); }
+
+    // Message thread. Opens the file and reads its head; returns the index
+    // to start cursors with, or -1 if the file cannot be read. Samples are
+    // never removed while the streamer exists, so indices stay valid.
+    int addSample(const juce::File& file);
+
+    int getNumSamples() const noexcept { return numSamples.load(std::memory_order_acquire); }
+    double getSampleRate(int sample) const noexcept;
+    juce::int64 getLengthInFrames(int sample) const noexcept;
+    int getNumChannels(int sample) const noexcept;
+
+    // Audio thread. Points the cursor at the start of a sample and claims a
+    // stream for it if the sample is longer than its head (wait-free).
+    bool start(Cursor& cursor, int sample) noexcept;
+
+    // Audio thread. Copies the next numFrames frames into dest (numChannels
+    // channels; a mono sample fills all of them) and returns how many were
+    // left before the end of the sample. Frames the I/O thread has not
+    // delivered yet come out as silence and are counted as underruns.
+    int read(Cursor& cursor, float* const* dest, int numChannels, int numFrames) noexcept;
+
+    // Audio thread. Hands the cursor's stream back to the I/O thread.
+    void stop(Cursor& cursor) noexcept;
+
+    int getUnderrunCount() const noexcept { return underruns.load(); }
+    size_t getMemoryUsageBytes() const noexcept { return memoryUsage.load(); }
+
+private:
+    class IOThread;
+
+    struct StreamedSample
+    {
+        juce::File file;
+        std::unique_ptr<juce::AudioFormatReader> reader;   // I/O thread only once published
+        juce::AudioBuffer<float> head;
+        juce::int64 length = 0;
+        double sampleRate = 0.0;
+        int numChannels = 0;
+        bool memoryMapped = false;
+    };
+
+    // Free -> Active by the audio thread, Active -> Released by the audio
+    // thread, Released -> Free by the I/O thread once the ring is emptied
+    enum StreamState { Free, Active, Released };
+
+    struct Stream
+    {
+        explicit Stream(int ringFrames) : fifo(ringFrames + 1), ring(2, ringFrames + 1) {}
+
+        std::atomic<int> state{Free};
+        int sample = -1;                            // set before publishing Active
+        juce::AbstractFifo fifo;
+        juce::AudioBuffer<float> ring;
+
+        // I/O thread only
+        bool primed = false;
+        juce::int64 fillPosition = 0;
+    };
+
+    bool serviceStreams();
+    void fill(Stream& stream, int numFrames);
+
+    std::vector<std::unique_ptr<StreamedSample>> samples;   // kMaxSamples slots, filled in order
+    std::atomic<int> numSamples{0};
+    juce::CriticalSection addLock;
+
+    std::vector<std::unique_ptr<Stream>> streams;
+    int ringCapacity = 0;
+    int preloadMs = kDefaultPreloadMs;
+
+    std::atomic<int> underruns{0};
+    std::atomic<size_t> memoryUsage{0};
+
+    juce::AudioFormatManager formatManager;
+    std::unique_ptr<IOThread> ioThread;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SampleStreamer)
+};
@@ -71,6 +71,14 @@ void SpectralMask::analyzeSample(const juce::AudioBuffer<float>& sampleBuffer, i
     DBG("SpectralMask: Analyzed " << spectralFrames.size() << " frames from sample");
 }
 
+void SpectralMask::swapAnalysis(std::vector<SpectralFrame>& frames) noexcept
+{
+    spectralFrames.swap(frames);
+    maskPosition = 0.0f;
+    currentEnergy = 0.0f;
+    frameCounter = 0;
+}
+
 void SpectralMask::clearAnalysis()
 {
     spectralFrames.clear();
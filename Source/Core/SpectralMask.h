@@ -68,6 +68,10 @@ public:
     // Sample analysis
     void analyzeSample(const juce::AudioBuffer<float>& sampleBuffer, int channel = 0);
     void clearAnalysis();
+    // Exchanges the analysed frames with frames and restarts the mask; no
+    // allocation, so an analysis made on another thread can be installed
+    // from the audio thread
+    void swapAnalysis(std::vector<SpectralFrame>& frames) noexcept;
     
     // Mask control
     void setMaskType(MaskType type) { maskType = type; }
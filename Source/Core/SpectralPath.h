@@ -12,15 +12,15 @@ public:
         out_.setSize(1, maxBlockSize, false, false, true);
     }
     void reset(){ stft_.reset(); }
+    int getLatencySamples() const { return stft_.getLatencySamples(); }
     
     bool isActive() const { return active_; }
     void setActive(bool active) { active_ = active; }
 
     void process(juce::AudioBuffer<float>& buffer){
-        const int N = buffer.getNumSamples();
+        const int N = juce::jmin(buffer.getNumSamples(), in_.getNumSamples());
         in_.copyFrom(0, 0, buffer, 0, 0, N);
-        out_.clear(0, 0, N);
-        stft_.process(in_, out_, nullptr);
+        stft_.process(in_.getArrayOfReadPointers(), out_.getArrayOfWritePointers(), 1, N);
         buffer.copyFrom(0, 0, out_, 0, 0, N);
         if (buffer.getNumChannels() > 1)
             for (int ch=1; ch<buffer.getNumChannels(); ++ch)
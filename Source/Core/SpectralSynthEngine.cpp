@@ -18,17 +18,28 @@ void SpectralSynthEngine::prepare(double sampleRate, int maxBlockSize) noexcept
     const int maxPartials = numPartials_.load();
     
     voicePool_ = std::make_unique<VoicePool>(maxVoices);
-    voicePool_->prepare(sampleRate_, blockSize_, maxPartials);
+    voicePool_->prepare(sampleRate_, blockSize_, maxPartials, sharedTables_.get());
+    governor_.prepare(sampleRate_, maxVoices);
+
+    samplePosition_ = 0;
+    hasPendingEvent_ = false;
+    clock_.publish(samplePosition_, juce::Time::getHighResolutionTicks(), sampleRate_);
     
     initialized_ = true;
 }
 
 void SpectralSynthEngine::pushGestureRT(const PaintEvent& g) noexcept
 {
-    convertAndEnqueueGesture(g);
+    const int64_t timestamp = g.ticks != 0 ? clock_.ticksToSamples(g.ticks) : kTimestampNow;
+    convertAndEnqueueGesture(g, timestamp);
+}
+
+void SpectralSynthEngine::pushGestureRT(const PaintEvent& g, int64_t timestampSamples) noexcept
+{
+    convertAndEnqueueGesture(g, timestampSamples);
 }
 
-void SpectralSynthEngine::convertAndEnqueueGesture(const PaintEvent& g) noexcept
+void SpectralSynthEngine::convertAndEnqueueGesture(const PaintEvent& g, int64_t timestamp) noexcept
 {
     // Convert old PaintEvent format to modern format with harmonic quantization
     const float minFreq = 80.0f;
@@ -46,9 +57,11 @@ void SpectralSynthEngine::convertAndEnqueueGesture(const PaintEvent& g) noexcept
         quantizedHz,                                    // baseHz - quantized to C major
         juce::jlimit(0.1f, 1.0f, g.pressure),         // amplitude based on pressure
         (g.nx - 0.5f) * 2.0f,                          // pan from X position (-1 to +1)
-        static_cast<uint16_t>(8 + g.pressure * 8)      // partials based on pressure (8-16)
+        static_cast<uint16_t>(8 + g.pressure * 8),     // partials based on pressure (8-16)
+        timestamp
     };
     
+    // A full queue drops the gesture; SpscRing counts it for the HUD
     eventQueue_.push(event);
 }
 
@@ -59,23 +72,84 @@ void SpectralSynthEngine::processAudioBlock(juce::AudioBuffer<float>& buffer, do
         
     // Clear buffer for synthesis (we're generating, not processing input)
     buffer.clear();
+
+    const int numSamples = buffer.getNumSamples();
+    const int64_t blockStart = samplePosition_;
+    const int64_t blockEnd = blockStart + numSamples;
+    const int lookahead = lookaheadSamples_.load(std::memory_order_relaxed);
+    const int64_t startTicks = juce::Time::getHighResolutionTicks();
+
+    clock_.publish(blockStart, startTicks, sampleRate_);
     
-    // Consume queued paint events and spawn voices
+    // Consume queued paint events in time order, rendering voices up to each
+    // event's offset before starting it, so onsets are sample-accurate.
+    int rendered = 0;
     InternalPaintEvent event;
-    while (eventQueue_.pop(event))
+    while (hasPendingEvent_ || eventQueue_.pop(event))
     {
-        if (auto* voice = voicePool_->allocate())
+        if (hasPendingEvent_)
+        {
+            event = pendingEvent_;
+            hasPendingEvent_ = false;
+        }
+        else if (event.timestamp != kTimestampNow)
+        {
+            // Bound the stamp once, against the position it was dequeued at, so a
+            // far-future or stale-anchor stamp is held for at most one lookahead
+            // plus a block and cannot stall the events queued behind it
+            event.timestamp = juce::jmin(event.timestamp, blockStart + lookahead + blockSize_);
+        }
+
+        int offset = rendered;
+        if (event.timestamp != kTimestampNow)
         {
-            voice->noteOn(event.baseHz, event.amplitude, event.partials, event.pan);
+            const int64_t due = event.timestamp + lookahead;
+            if (due >= blockEnd)
+            {
+                pendingEvent_ = event;
+                hasPendingEvent_ = true;
+                break;
+            }
+            offset = juce::jmax(rendered, (int) juce::jmax<int64_t>(0, due - blockStart));
         }
+
+        if (offset > rendered)
+        {
+            voicePool_->render(buffer, rendered, offset - rendered);
+            rendered = offset;
+        }
+
+        voicePool_->noteOn(event.baseHz, event.amplitude, event.partials, event.pan, masterGain_.load(std::memory_order_relaxed));
     }
     
-    // Render all active voices into buffer
-    voicePool_->render(buffer);
+    // Render the remainder of the block
+    if (rendered < numSamples)
+        voicePool_->render(buffer, rendered, numSamples - rendered);
+
+    samplePosition_ = blockEnd;
     
     // Apply master gain
     const float masterGain = masterGain_.load();
     buffer.applyGain(masterGain);
+
+    // Feed this block's cost to the governor; new limits apply from the next block
+    const double elapsed = (double) (juce::Time::getHighResolutionTicks() - startTicks) * ticksToSeconds_;
+    if (governor_.update(elapsed, numSamples))
+    {
+        voicePool_->setPartialScale(governor_.getPartialScale());
+        voicePool_->setVoiceLimit(governor_.getVoiceCap());
+    }
+}
+
+void SpectralSynthEngine::fillHudMetrics(SpectralCanvas::HudMetrics& m) const noexcept
+{
+    const auto& stats = governor_.getStats();
+    m.dspLoad = stats.load.load(std::memory_order_relaxed);
+    m.governorLevel = stats.level.load(std::memory_order_relaxed);
+    m.partialScale = stats.partialScale.load(std::memory_order_relaxed);
+    m.voiceCap = stats.voiceCap.load(std::memory_order_relaxed);
+    m.maxQDepth = (uint32_t) eventQueue_.getHighWaterMark();
+    m.evDropped = (uint32_t) eventQueue_.getDroppedCount();
 }
 
 void SpectralSynthEngine::releaseResources() noexcept
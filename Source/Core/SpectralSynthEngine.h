@@ -4,18 +4,66 @@
 #include "HarmonicQuantizer.h"
 #include "../dsp/SpscRing.h"
 #include "../dsp/VoicePool.h"
+#include "../dsp/SynthTables.h"
+#include "../dsp/LoadGovernor.h"
+#include "../Telemetry/HudMetrics.h"
+#include <limits>
 
-class SpectralSynthEngine
+// Maps juce high-resolution ticks onto the engine's running sample position.
+// The audio thread publishes (samplePosition, ticks) at the start of every block;
+// any thread can then convert a tick stamp into a sample timestamp. Seqlock, so
+// neither side ever blocks.
+class GestureClock
 {
 public:
-    static SpectralSynthEngine& instance() noexcept
+    void publish(int64_t samplePosition, int64_t ticks, double sampleRate) noexcept
+    {
+        seq_.fetch_add(1, std::memory_order_acq_rel);
+        samplePos_.store(samplePosition, std::memory_order_relaxed);
+        ticks_.store(ticks, std::memory_order_relaxed);
+        samplesPerTick_.store(sampleRate / ticksPerSecond_, std::memory_order_relaxed);
+        seq_.fetch_add(1, std::memory_order_release);
+    }
+
+    int64_t ticksToSamples(int64_t ticks) const noexcept
     {
-        static SpectralSynthEngine s;
-        return s;
+        int64_t pos, anchor;
+        double scale;
+        uint32_t before, after;
+        do
+        {
+            before = seq_.load(std::memory_order_acquire);
+            pos = samplePos_.load(std::memory_order_relaxed);
+            anchor = ticks_.load(std::memory_order_relaxed);
+            scale = samplesPerTick_.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = seq_.load(std::memory_order_relaxed);
+        } while ((before & 1u) != 0 || before != after);
+
+        return pos + (int64_t) std::llround((double) (ticks - anchor) * scale);
     }
 
+private:
+    const double ticksPerSecond_ = (double) juce::Time::getHighResolutionTicksPerSecond();
+    std::atomic<uint32_t> seq_{0};
+    std::atomic<int64_t> samplePos_{0};
+    std::atomic<int64_t> ticks_{0};
+    std::atomic<double> samplesPerTick_{0.0};
+};
+
+// One engine per plugin instance: each owns its voice pool, gesture queue and
+// clock, so the SPSC contract holds with any number of instances in a session.
+// Read-only synthesis tables are shared process-wide through SynthTables.
+class SpectralSynthEngine
+{
+public:
+    SpectralSynthEngine() noexcept;
+    ~SpectralSynthEngine() = default;
+
     void prepare(double sampleRate, int maxBlockSize) noexcept;
     void pushGestureRT(const PaintEvent& g) noexcept;
+    // Schedules a gesture at an absolute engine sample position (offline rendering).
+    void pushGestureRT(const PaintEvent& g, int64_t timestampSamples) noexcept;
     void processAudioBlock(juce::AudioBuffer<float>& buffer, double sampleRate) noexcept;
     void releaseResources() noexcept;
     
@@ -25,17 +73,32 @@ public:
     void setMasterGain(float v) noexcept { masterGain_.store(v); }
     void setNumPartials(int n) noexcept { numPartials_.store( juce::jlimit(1, kMaxPartials, n)); }
     void setMaxVoices(int v) noexcept { maxVoices_.store( juce::jlimit(1, kMaxVoices, v)); }
+
+    // Gesture timing. With 0 lookahead, stamped gestures start at their position
+    // inside the block if it is still ahead, otherwise as soon as possible. A
+    // lookahead of one host block delays every gesture by exactly that amount,
+    // which removes block-size jitter entirely.
+    void setGestureLookahead(int samples) noexcept { lookaheadSamples_.store(juce::jmax(0, samples)); }
+    int getGestureLookahead() const noexcept { return lookaheadSamples_.load(); }
+    int64_t getSamplePosition() const noexcept { return samplePosition_; }
+
+    // CPU governor: trims partials, then voices, when processAudioBlock nears
+    // the block deadline, and restores them once load settles.
+    void setLoadGovernorEnabled(bool enabled) noexcept { governor_.setEnabled(enabled); }
+    const GovernorStats& getGovernorStats() const noexcept { return governor_.getStats(); }
+    void fillHudMetrics(SpectralCanvas::HudMetrics& m) const noexcept;
     
     // Status queries
     size_t getQueueSize() const noexcept;
+    size_t getQueueHighWaterMark() const noexcept { return eventQueue_.getHighWaterMark(); }
+    uint64_t getDroppedGestureCount() const noexcept { return eventQueue_.getDroppedCount(); }
 
 private:
-    SpectralSynthEngine() noexcept;
-    ~SpectralSynthEngine() = default;
-
     SpectralSynthEngine(const SpectralSynthEngine&) = delete;
     SpectralSynthEngine& operator=(const SpectralSynthEngine&) = delete;
 
+    juce::SharedResourcePointer<SynthTables> sharedTables_;
+
     // Modern JUCE DSP-based voice management
     std::unique_ptr<VoicePool> voicePool_;
     
@@ -45,9 +108,22 @@ private:
         float amplitude;
         float pan;
         uint16_t partials;
+        int64_t timestamp;   // engine sample position, kTimestampNow if unstamped
     };
     SpscRing<InternalPaintEvent, 1024> eventQueue_;
 
+    static constexpr int64_t kTimestampNow = std::numeric_limits<int64_t>::min();
+
+    // Event popped from the queue but due in a later block
+    InternalPaintEvent pendingEvent_{};
+    bool hasPendingEvent_ = false;
+
+    GestureClock clock_;
+    LoadGovernor governor_;
+    double ticksToSeconds_ = 1.0 / (double) juce::Time::getHighResolutionTicksPerSecond();
+    int64_t samplePosition_ = 0;
+    std::atomic<int> lookaheadSamples_{0};
+
     // Engine state
     double sampleRate_ = 44100.0;
     int blockSize_ = 128;
@@ -63,5 +139,5 @@ private:
     static constexpr int kMaxVoices = 64;
     
     // Convert from old PaintEvent format to modern format
-    void convertAndEnqueueGesture(const PaintEvent& g) noexcept;
+    void convertAndEnqueueGesture(const PaintEvent& g, int64_t timestamp) noexcept;
 };
\ No newline at end of file
@@ -0,0 +1,193 @@
+/******************************************************************************
+ * File: SpectralWorkerPool.cpp
+ * Description: Fixed pool of realtime-priority workers for audio-thread fork/join
+ *
+ * Copyright (c) 2025 Spectral Audio Systems
+ ******************************************************************************/
+
+#include "SpectralWorkerPool.h"
+#include <thread>
+
+namespace
+{
+    constexpr uint64_t generationOf(uint64_t state) noexcept { return state >> 32; }
+    constexpr int numTasksOf(uint64_t state) noexcept { return (int) ((state >> 16) & 0xffff); }
+    constexpr int nextTaskOf(uint64_t state) noexcept { return (int) (state & 0xffff); }
+
+    constexpr int maxTasksPerBatch = 0xffff;
+    constexpr int sleepTimeoutMs = 100;       // only bounds how long shutdown can take
+    constexpr int probeInterval = 64;         // unresponsive pools are retried every Nth query
+}
+
+//==============================================================================
+class SpectralWorkerPool::Worker : public juce::Thread
+{
+public:
+    Worker(SpectralWorkerPool& owner, int index)
+        : juce::Thread("Spectral worker " + juce::String(index)), pool(owner)
+    {
+    }
+
+    void run() override
+    {
+        // Spin briefly after each batch (frames often arrive back to back for
+        // several channels or hops), then sleep until woken
+        const auto spinTicks = juce::Time::getHighResolutionTicksPerSecond() / 20000; // 50 us
+        auto seen = generationOf(pool.batchState.load(std::memory_order_acquire));
+
+        while (! threadShouldExit())
+        {
+            const auto spinStart = juce::Time::getHighResolutionTicks();
+            while (generationOf(pool.batchState.load(std::memory_order_acquire)) == seen
+                   && juce::Time::getHighResolutionTicks() - spinStart < spinTicks)
+                std::this_thread::yield();
+
+            if (generationOf(pool.batchState.load(std::memory_order_acquire)) == seen)
+            {
+                sleeping.store(true);
+                if (generationOf(pool.batchState.load()) == seen)
+                    wakeEvent.wait(sleepTimeoutMs);
+                sleeping.store(false);
+            }
+
+            const auto current = generationOf(pool.batchState.load(std::memory_order_acquire));
+            if (current == seen)
+                continue;
+
+            seen = current;
+            pool.workOnBatch(true);
+        }
+    }
+
+    void wake() noexcept
+    {
+        if (sleeping.load())
+            wakeEvent.signal();
+    }
+
+    void stop()
+    {
+        signalThreadShouldExit();
+        wakeEvent.signal();
+        stopThread(1000);
+    }
+
+private:
+    SpectralWorkerPool& pool;
+    std::atomic<bool> sleeping{false};
+    juce::WaitableEvent wakeEvent;
+};
+
+//==============================================================================
+SpectralWorkerPool::SpectralWorkerPool(int numWorkers, double sampleRate, int samplesPerBlock)
+{
+    const auto options = juce::Thread::RealtimeOptions{}
+                             .withPriority(9)
+                             .withApproximateAudioProcessingTime(juce::jmax(1, samplesPerBlock), sampleRate);
+
+    for (int i = 0; i < juce::jmax(0, numWorkers); ++i)
+    {
+        auto worker = std::make_unique<Worker>(*this, i);
+
+        // Realtime scheduling may be refused (e.g. no rtprio on Linux)
+        if (! worker->startRealtimeThread(options))
+            worker->startThread(juce::Thread::Priority::highest);
+
+        workers.push_back(std::move(worker));
+    }
+}
+
+SpectralWorkerPool::~SpectralWorkerPool()
+{
+    for (auto& worker : workers)
+        worker->stop();
+}
+
+void SpectralWorkerPool::run(TaskFn task, void* context, int numTasks) noexcept
+{
+    if (numTasks <= 0)
+        return;
+
+    if (workers.empty() || numTasks == 1 || numTasks > maxTasksPerBatch
+        || batchRunning.exchange(true, std::memory_order_acquire))
+    {
+        for (int i = 0; i < numTasks; ++i)
+            task(context, i);
+        return;
+    }
+
+    // No worker can be inside a task here, so the batch fields are ours to write
+    batchTask = task;
+    batchContext = context;
+    tasksCompleted.store(0, std::memory_order_relaxed);
+    firstWorkerClaimTicks.store(0, std::memory_order_relaxed);
+
+    const auto start = juce::Time::getHighResolutionTicks();
+
+    const uint64_t generation = (generationOf(batchState.load(std::memory_order_relaxed)) + 1) & 0xffffffffu;
+    batchState.store((generation << 32) | ((uint64_t) numTasks << 16));
+
+    for (auto& worker : workers)
+        worker->wake();
+
+    workOnBatch(false);
+
+    // Bounded barrier: every task has been claimed, only ones a worker already
+    // started can still be running
+    while (tasksCompleted.load(std::memory_order_acquire) < numTasks)
+        std::this_thread::yield();
+
+    // A batch no worker joined counts as its full duration, so a pool that
+    // cannot wake in time quickly reports itself unresponsive
+    const auto claimed = firstWorkerClaimTicks.load(std::memory_order_relaxed);
+    const auto latency = (claimed != 0 ? claimed : juce::Time::getHighResolutionTicks()) - start;
+    const auto smoothed = wakeLatencyTicks.load(std::memory_order_relaxed);
+    wakeLatencyTicks.store(smoothed == 0 ? latency : (smoothed * 3 + latency) / 4, std::memory_order_relaxed);
+
+    batchRunning.store(false, std::memory_order_release);
+}
+
+bool SpectralWorkerPool::isResponsive(juce::int64 budgetTicks) noexcept
+{
+    if (workers.empty())
+        return false;
+
+    if (wakeLatencyTicks.load(std::memory_order_relaxed) <= budgetTicks)
+        return true;
+
+    // Probe now and then so a pool that was slow once (e.g. woken from deep
+    // sleep) gets a chance to prove itself again
+    return (probeCounter.fetch_add(1, std::memory_order_relaxed) + 1) % probeInterval == 0;
+}
+
+bool SpectralWorkerPool::tryClaim(int& taskIndex) noexcept
+{
+    auto state = batchState.load(std::memory_order_acquire);
+    while (nextTaskOf(state) < numTasksOf(state))
+    {
+        if (batchState.compare_exchange_weak(state, state + 1, std::memory_order_acq_rel))
+        {
+            taskIndex = nextTaskOf(state);
+            return true;
+        }
+    }
+    return false;
+}
+
+void SpectralWorkerPool::workOnBatch(bool isWorker) noexcept
+{
+    int index = 0;
+    while (tryClaim(index))
+    {
+        if (isWorker)
+        {
+            juce::int64 none = 0;
+            firstWorkerClaimTicks.compare_exchange_strong(none, juce::Time::getHighResolutionTicks(),
+                                                          std::memory_order_relaxed);
+        }
+
+        // The claimed task keeps the batch unfinished, so these are stable
+        batchTask(batchContext, index);
+        tasksCompleted.fetch_add(1, std::memory_order_release);
+    }
+}
@@ -0,0 +1,73 @@
+/******************************************************************************
+ * File: SpectralWorkerPool.h
+ * Description: Fixed pool of realtime-priority workers for audio-thread fork/join
+ *
+ * The audio thread publishes a batch of N independent tasks, claims tasks
+ * itself alongside the workers, and then waits only for tasks already in
+ * flight. So a batch never takes longer than running it serially plus one
+ * task, even if no worker wakes in time. Nothing allocates or locks on the
+ * publishing side; sleeping workers are woken through per-worker events.
+ *
+ * Copyright (c) 2025 Spectral Audio Systems
+ ******************************************************************************/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+class SpectralWorkerPool
+{
+public:
+    using TaskFn = void (*)(void* context, int taskIndex);
+
+    // Starts numWorkers threads at realtime priority, sized for the given
+    // audio callback so the OS can schedule them like the audio thread.
+    SpectralWorkerPool(int numWorkers, double sampleRate, int samplesPerBlock);
+    ~SpectralWorkerPool();
+
+    // Runs task(context, i) once for every i in [0, numTasks) and returns when
+    // all have finished. The caller works on the batch too. A call made while
+    // another batch is running (e.g. from inside a task) runs serially.
+    void run(TaskFn task, void* context, int numTasks) noexcept;
+
+    // Convenience wrapper for lambdas; fn is invoked as fn(int) and must
+    // outlive the call (it always does, run() is synchronous).
+    template <typename Fn>
+    void runEach(int numTasks, Fn& fn) noexcept
+    {
+        run([](void* c, int i) { (*static_cast<Fn*>(c))(i); }, &fn, numTasks);
+    }
+
+    // True when recent batches were picked up by a worker within budgetTicks
+    // (juce::Time high-resolution ticks) of being published. When workers
+    // are slow to wake, callers should run the work serially instead; every
+    // so often this still says yes so the pool can recover.
+    bool isResponsive(juce::int64 budgetTicks) noexcept;
+
+    int getNumWorkers() const noexcept { return (int) workers.size(); }
+
+private:
+    class Worker;
+
+    bool tryClaim(int& taskIndex) noexcept;
+    void workOnBatch(bool isWorker) noexcept;
+
+    // Batch state: generation (32 bits) | numTasks (16 bits) | next task (16 bits)
+    // in one word, so a claim can never mix tasks of two batches.
+    std::atomic<uint64_t> batchState{0};
+    TaskFn batchTask = nullptr;                  // stable while the batch has unfinished tasks
+    void* batchContext = nullptr;
+    std::atomic<int> tasksCompleted{0};
+    std::atomic<juce::int64> firstWorkerClaimTicks{0};
+    std::atomic<bool> batchRunning{false};
+
+    std::atomic<juce::int64> wakeLatencyTicks{0};  // smoothed publish -> first worker claim
+    std::atomic<int> probeCounter{0};
+
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectralWorkerPool)
+};
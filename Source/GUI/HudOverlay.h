@@ -82,6 +82,10 @@ private:
         int eventsProcessed = 0;
         int queueDepth = 0;
         int maxQueueDepth = 0;
+        int droppedEvents = 0;
+        int loadFailures = 0;
+        float dspLoad = 0.0f;
+        int governorLevel = 0;
         bool hasData = false;
     } cachedMetrics;
     
@@ -195,6 +199,10 @@ inline void HudOverlay::updateMetrics()
         cachedMetrics.eventsProcessed = static_cast<int>(latestMetrics.evPushed);
         cachedMetrics.queueDepth = static_cast<int>(latestMetrics.evPopped);
         cachedMetrics.maxQueueDepth = static_cast<int>(latestMetrics.maxQDepth);
+        cachedMetrics.droppedEvents = static_cast<int>(latestMetrics.evDropped);
+        cachedMetrics.loadFailures = static_cast<int>(latestMetrics.loadFailures);
+        cachedMetrics.dspLoad = latestMetrics.dspLoad;
+        cachedMetrics.governorLevel = latestMetrics.governorLevel;
         cachedMetrics.hasData = true;
     }
 }
@@ -214,6 +222,9 @@ inline juce::String HudOverlay::formatMetrics() const
     result << juce::String::formatted("Pushed: %7d\n", cachedMetrics.eventsProcessed);
     result << juce::String::formatted("Popped: %7d\n", cachedMetrics.queueDepth);
     result << juce::String::formatted("Q Max:  %7d\n", cachedMetrics.maxQueueDepth);
+    result << juce::String::formatted("Drops:  %7d\n", cachedMetrics.droppedEvents);
+    result << juce::String::formatted("Fails:  %7d\n", cachedMetrics.loadFailures);
+    result << juce::String::formatted("DSP:    %6.1f%% (gov %d)\n", cachedMetrics.dspLoad * 100.0f, cachedMetrics.governorLevel);
     
     return result;
 }
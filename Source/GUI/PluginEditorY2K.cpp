@@ -27,6 +27,10 @@ PluginEditorY2K::PluginEditorY2K(ARTEFACTAudioProcessor& processor)
         }
     }
     
+    // Telemetry overlay; hidden until toggled, mouse events pass through
+    hudOverlay_ = std::make_unique<HudOverlay>(audioProcessor_.getHudQueue());
+    addChildComponent(*hudOverlay_);
+    
     // Set initial size and constraints
     setSize(kDefaultWidth, kDefaultHeight);
     setResizeLimits(kMinWidth, kMinHeight, 2000, 1400);
@@ -339,6 +343,11 @@ void PluginEditorY2K::layoutComponents()
     {
         pixelCanvas_->setBounds(bounds.reduced(4));
     }
+    
+    if (hudOverlay_)
+    {
+        hudOverlay_->setBounds(bounds.reduced(12));
+    }
 }
 
 std::unique_ptr<Slider> PluginEditorY2K::createSlider(const String& name, Slider::SliderStyle style)
@@ -379,6 +388,14 @@ bool PluginEditorY2K::keyPressed(const KeyPress& key, juce::Component* originati
         return true;
     }
     
+    // HUD toggle
+    if (hudOverlay_ && ! key.getModifiers().isAnyModifierKeyDown()
+        && (key.getTextCharacter() == 'h' || key.getTextCharacter() == 'H'))
+    {
+        hudOverlay_->toggleHud();
+        return true;
+    }
+    
     return false;
 }
 
@@ -3,6 +3,7 @@
 #include "ThemeAwareLookAndFeel.h"
 #include "PixelCanvasComponent.h"
 #include "LookAndFeelTokens.h"
+#include "HudOverlay.h"
 
 // Forward declarations
 class ARTEFACTAudioProcessor;
@@ -32,7 +33,7 @@ public:
     void paint(juce::Graphics& g) override;
     void resized() override;
 
-    // Key handling for panic hotkey and accessibility
+    // Key handling for panic hotkey, HUD toggle and accessibility
     bool keyPressed(const juce::KeyPress& key, juce::Component* originatingComponent) override;
 
     // Accessibility and safety
@@ -49,6 +50,7 @@ private:
     
     // Main UI components
     std::unique_ptr<PixelCanvasComponent> pixelCanvas_;
+    std::unique_ptr<HudOverlay> hudOverlay_;   // engine telemetry over the canvas, toggled with 'H'
     
     // Control panels (simplified for Y2K theme)
     std::unique_ptr<juce::Component> leftControlPanel_;
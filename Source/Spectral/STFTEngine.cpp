@@ -6,45 +6,161 @@ namespace SpectralCanvas {
 namespace spectral {
 
 void STFTEngine::prepare(double sampleRate, const STFTConfig& config) {
+    initialized_ = false;
     config_ = config;
     sampleRate_ = sampleRate;
-    
-    // For now, keep it simple - just validate config
+
     if (config_.fftSize <= 0 || config_.hopSize <= 0 || config_.channels <= 0) {
         return; // Invalid config
     }
-    
+
+    const int order = juce::roundToInt(std::log2((double) config_.fftSize));
+    if ((1 << order) != config_.fftSize || config_.fftSize % config_.hopSize != 0) {
+        jassertfalse; // fftSize must be a power of two and a multiple of hopSize
+        return;
+    }
+
+    const int N = config_.fftSize;
+    const int H = config_.hopSize;
+
+    // Periodic analysis window: JUCE's tables are symmetric, so build N + 1
+    // points and drop the last one
+    analysisWindow_.resize((size_t) N + 1);
+    if (config_.window == juce::dsp::WindowingFunction<float>::hann) {
+        for (int n = 0; n < N; ++n)
+            analysisWindow_[(size_t) n] = 0.5f - 0.5f * std::cos(juce::MathConstants<float>::twoPi * (float) n / (float) N);
+    } else {
+        juce::dsp::WindowingFunction<float>::fillWindowingTables(analysisWindow_.data(), (size_t) N + 1,
+                                                                 config_.window, false);
+    }
+    analysisWindow_.resize((size_t) N);
+
+    // Synthesis window w[n] / sum_k w^2[n + kH] gives exact reconstruction for any
+    // hop that divides N, including hop == N (no overlap) where the frame edges
+    // fall back to a rectangular window.
+    synthesisWindow_.resize((size_t) N);
+    for (int n = 0; n < N; ++n) {
+        float norm = 0.0f;
+        for (int m = n % H; m < N; m += H)
+            norm += analysisWindow_[(size_t) m] * analysisWindow_[(size_t) m];
+        synthesisWindow_[(size_t) n] = norm > 1.0e-6f ? analysisWindow_[(size_t) n] / norm : 0.0f;
+    }
+
+    if (H == N) {
+        std::fill(analysisWindow_.begin(), analysisWindow_.end(), 1.0f);
+        std::fill(synthesisWindow_.begin(), synthesisWindow_.end(), 1.0f);
+    }
+
+    channels_.resize((size_t) config_.channels);
+    for (auto& ch : channels_) {
+        ch.fft = std::make_unique<juce::dsp::FFT>(order);
+        ch.fftBuffer.assign((size_t) (2 * N), 0.0f);
+        ch.inputFifo.assign((size_t) N, 0.0f);
+        ch.outputAccum.assign((size_t) N, 0.0f);
+        ch.outputReady.assign((size_t) H, 0.0f);
+    }
+
+    hopFill_ = 0;
     initialized_ = true;
 }
 
 void STFTEngine::reset() {
-    // Simple reset - clear any internal state
-    initialized_ = false;
+    for (auto& ch : channels_) {
+        std::fill(ch.inputFifo.begin(), ch.inputFifo.end(), 0.0f);
+        std::fill(ch.outputAccum.begin(), ch.outputAccum.end(), 0.0f);
+        std::fill(ch.outputReady.begin(), ch.outputReady.end(), 0.0f);
+        std::fill(ch.fftBuffer.begin(), ch.fftBuffer.end(), 0.0f);
+    }
+    hopFill_ = 0;
+}
+
+void STFTEngine::process(const juce::AudioBuffer<float>& input,
+                        juce::AudioBuffer<float>& output) {
+    const int numChannels = std::min(input.getNumChannels(), output.getNumChannels());
+    const int numSamples = std::min(input.getNumSamples(), output.getNumSamples());
+
+    if (!initialized_) {
+        for (int ch = 0; ch < numChannels; ++ch)
+            output.copyFrom(ch, 0, input, ch, 0, numSamples);
+        return;
+    }
+
+    process(input.getArrayOfReadPointers(), output.getArrayOfWritePointers(), numChannels, numSamples);
 }
 
-void STFTEngine::process(const juce::AudioBuffer<float>& input, 
-                        juce::AudioBuffer<float>& output,
-                        void* userData) {
-    // Simple implementation: passthrough for now
-    // This ensures the build succeeds and audio flows
-    
+void STFTEngine::process(const float* const* input, float* const* output,
+                         int numChannels, int numSamples) noexcept {
     if (!initialized_) {
-        output.makeCopyOf(input);
+        for (int ch = 0; ch < numChannels; ++ch)
+            if (input[ch] != output[ch])
+                std::copy(input[ch], input[ch] + numSamples, output[ch]);
         return;
     }
-    
-    // Ensure output buffer matches input
-    if (output.getNumSamples() != input.getNumSamples() || 
-        output.getNumChannels() != input.getNumChannels()) {
-        output.setSize(input.getNumChannels(), input.getNumSamples(), false, false, true);
-    }
-    
-    // For initial implementation: clean passthrough
-    output.makeCopyOf(input);
-    
-    // TODO: Real STFT processing would go here
-    // For now, this ensures compilation and basic functionality
+
+    const int N = config_.fftSize;
+    const int H = config_.hopSize;
+    const int active = std::min(numChannels, config_.channels);
+
+    int pos = 0;
+    while (pos < numSamples) {
+        const int chunk = std::min(numSamples - pos, H - hopFill_);
+
+        for (int ch = 0; ch < active; ++ch) {
+            auto& state = channels_[(size_t) ch];
+            std::copy(input[ch] + pos, input[ch] + pos + chunk,
+                      state.inputFifo.data() + (N - H + hopFill_));
+            std::copy(state.outputReady.data() + hopFill_,
+                      state.outputReady.data() + hopFill_ + chunk,
+                      output[ch] + pos);
+        }
+
+        hopFill_ += chunk;
+        pos += chunk;
+
+        if (hopFill_ == H) {
+            if (frameExecutor_ && active > 1) {
+                frameExecutor_([](void* self, int ch) { static_cast<STFTEngine*>(self)->processFrame(ch); },
+                               this, active);
+            } else {
+                for (int ch = 0; ch < active; ++ch)
+                    processFrame(ch);
+            }
+            hopFill_ = 0;
+        }
+    }
+
+    // Channels beyond the configured count pass through untouched
+    for (int ch = active; ch < numChannels; ++ch)
+        if (input[ch] != output[ch])
+            std::copy(input[ch], input[ch] + numSamples, output[ch]);
+}
+
+void STFTEngine::processFrame(int channel) noexcept {
+    const int N = config_.fftSize;
+    const int H = config_.hopSize;
+    auto& state = channels_[(size_t) channel];
+    float* fftData = state.fftBuffer.data();
+
+    // Analysis
+    juce::FloatVectorOperations::multiply(fftData, state.inputFifo.data(), analysisWindow_.data(), N);
+    std::fill(fftData + N, fftData + 2 * N, 0.0f);
+    state.fft->performRealOnlyForwardTransform(fftData, true);
+
+    if (frameCallback_)
+        frameCallback_(channel, reinterpret_cast<std::complex<float>*>(fftData), N / 2 + 1);
+
+    // Resynthesis (JUCE's inverse already scales by 1/N)
+    state.fft->performRealOnlyInverseTransform(fftData);
+    juce::FloatVectorOperations::multiply(fftData, synthesisWindow_.data(), N);
+    juce::FloatVectorOperations::add(state.outputAccum.data(), fftData, N);
+
+    // The first hop of the accumulator has received all its contributions
+    std::copy(state.outputAccum.begin(), state.outputAccum.begin() + H, state.outputReady.begin());
+    std::copy(state.outputAccum.begin() + H, state.outputAccum.end(), state.outputAccum.begin());
+    std::fill(state.outputAccum.end() - H, state.outputAccum.end(), 0.0f);
+
+    std::copy(state.inputFifo.begin() + H, state.inputFifo.end(), state.inputFifo.begin());
 }
 
 } // namespace spectral
-} // namespace SpectralCanvas
\ No newline at end of file
+} // namespace SpectralCanvas
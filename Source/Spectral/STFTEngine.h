@@ -1,5 +1,10 @@
 #pragma once
 #include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+#include <complex>
+#include <functional>
+#include <memory>
+#include <vector>
 
 namespace SpectralCanvas {
 namespace spectral {
@@ -8,24 +13,84 @@ struct STFTConfig {
     int fftSize;
     int hopSize;
     int channels;
+    // Analysis window (periodic); synthesis is normalised for any choice
+    juce::dsp::WindowingFunction<float>::WindowingMethod window = juce::dsp::WindowingFunction<float>::hann;
 };
 
+// Multi-channel overlap-add STFT analysis/resynthesis.
+//
+// Each channel owns an input FIFO holding the last fftSize samples and an
+// output accumulator. Whenever a hop's worth of input has arrived a frame is
+// analysed, handed to the frame callback (positive-frequency bins only,
+// fftSize / 2 + 1 of them), resynthesised and overlap-added. Host block size
+// and hop size are independent; latency is always fftSize samples.
+//
+// All buffers, windows and the FFT plan are allocated in prepare(); process()
+// never allocates.
 class STFTEngine {
 public:
+    // Called on the audio thread once per frame per channel. Bins may be
+    // modified in place; leaving them untouched gives perfect reconstruction.
+    using FrameCallback = std::function<void (int channel, std::complex<float>* bins, int numBins)>;
+
     STFTEngine() = default;
     ~STFTEngine() = default;
-    
+
+    // fftSize must be a power of two and a multiple of hopSize.
     void prepare(double sampleRate, const STFTConfig& config);
     void reset();
-    void process(const juce::AudioBuffer<float>& input, 
-                 juce::AudioBuffer<float>& output,
-                 void* userData);
+
+    // Set before processing starts; not thread-safe against process().
+    void setFrameCallback(FrameCallback cb) { frameCallback_ = std::move(cb); }
+
+    // Optional hook that runs the frames of one hop (one task per channel),
+    // e.g. on a worker pool. It must call task(taskContext, i) exactly once
+    // for every i in [0, numTasks) and return once all have finished. With an
+    // executor set the frame callback may run concurrently for different
+    // channels. Without one, channels are processed in order on the caller.
+    using TaskFn = void (*)(void* taskContext, int index);
+    using FrameExecutor = std::function<void (TaskFn task, void* taskContext, int numTasks)>;
+    void setFrameExecutor(FrameExecutor executor) { frameExecutor_ = std::move(executor); }
+
+    // Processes input.getNumSamples() samples of min(input, output, config)
+    // channels. output must hold at least as many samples as input.
+    void process(const juce::AudioBuffer<float>& input,
+                 juce::AudioBuffer<float>& output);
+
+    // Raw-pointer variant for callers that work on sub-ranges.
+    void process(const float* const* input, float* const* output,
+                 int numChannels, int numSamples) noexcept;
+
+    bool isPrepared() const noexcept { return initialized_; }
+    int getLatencySamples() const noexcept { return initialized_ ? config_.fftSize : 0; }
+    int getNumBins() const noexcept { return config_.fftSize / 2 + 1; }
+    const STFTConfig& getConfig() const noexcept { return config_; }
+    double getSampleRate() const noexcept { return sampleRate_; }
 
 private:
+    void processFrame(int channel) noexcept;
+
+    // Channels share nothing mutable, so their frames can run on any thread
+    struct ChannelState {
+        std::unique_ptr<juce::dsp::FFT> fft; // per channel: JUCE's fallback FFT serialises callers
+        std::vector<float> inputFifo;    // last fftSize input samples, oldest first
+        std::vector<float> outputAccum;  // overlap-add accumulator, fftSize samples
+        std::vector<float> outputReady;  // one hop of finished output
+        std::vector<float> fftBuffer;    // 2 * fftSize, interleaved complex after forward
+    };
+
     STFTConfig config_{1024, 256, 1};
     double sampleRate_ = 44100.0;
     bool initialized_ = false;
+
+    std::vector<float> analysisWindow_;
+    std::vector<float> synthesisWindow_;   // normalised so overlap-add sums to unity
+    std::vector<ChannelState> channels_;
+    int hopFill_ = 0;                      // samples gathered towards the next frame
+
+    FrameCallback frameCallback_;
+    FrameExecutor frameExecutor_;
 };
 
-} // namespace spectral  
+} // namespace spectral
 } // namespace SpectralCanvas
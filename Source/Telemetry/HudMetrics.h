@@ -51,7 +51,15 @@ struct HudMetrics
     uint32_t evPushed = 0;     // Events pushed to paint queue
     uint32_t evPopped = 0;     // Events popped from paint queue
     uint32_t maxQDepth = 0;    // Maximum queue depth observed
+    uint32_t evDropped = 0;    // Events dropped because the queue was full
     float lastBlockRMS = 0.0f; // RMS of last processed audio block
+    uint32_t loadFailures = 0; // Sample loads that failed to decode
+    
+    // Synth CPU governor (see dsp/LoadGovernor.h)
+    float dspLoad = 0.0f;      // Smoothed DSP time / block deadline
+    int governorLevel = 0;     // 0 = full quality, higher = more degraded
+    float partialScale = 1.0f; // Fraction of partials rendered per voice
+    int voiceCap = 0;          // Sounding-voice limit in force
     
     /**
      * @brief Default constructor - zero-initialize all metrics
@@ -0,0 +1,127 @@
+/**
+ * Adaptive processing may trade overlap for CPU, but must never change the
+ * FFT size: that would change the latency reported to the host and override
+ * a size the user picked. Overlap and window changes must not interrupt the
+ * signal either.
+ */
+
+#include <JuceHeader.h>
+#include "Core/CDPSpectralEngine.h"
+
+class TestCDPAdaptiveMode : public juce::UnitTest
+{
+public:
+    TestCDPAdaptiveMode()
+        : UnitTest("CDP Adaptive Mode", "Audio")
+    {
+    }
+
+    void runTest() override
+    {
+        using Mode = CDPSpectralEngine::ProcessingMode;
+
+        beginTest("Load swings leave the FFT size and latency alone");
+        {
+            CDPSpectralEngine engine;
+            expect(engine.getProcessingMode() == Mode::Adaptive);
+            engine.prepareToPlay(kSampleRate, kBlockSize, 2);
+
+            const int fftSize = engine.getCurrentFFTSize();
+            const int latency = engine.getLatencySamples();
+            int latencyChanges = 0;
+            engine.setLatencyCallback([&](int) { ++latencyChanges; });
+
+            // Slow blocks read as high load, back-to-back ones as headroom
+            runBlocks(engine, 20, 12);
+            runBlocks(engine, 200, 0);
+            juce::Thread::sleep(20);
+
+            expectEquals(engine.getCurrentFFTSize(), fftSize);
+            expectEquals(engine.getLatencySamples(), latency);
+            expectEquals(latencyChanges, 0);
+            engine.releaseResources();
+        }
+
+        beginTest("An explicit FFT size survives adaptive mode");
+        {
+            CDPSpectralEngine engine;
+            engine.prepareToPlay(kSampleRate, kBlockSize, 2);
+            engine.setFFTSize(2048);
+
+            // The processing thread builds the new STFT; the audio thread adopts it
+            for (int i = 0; i < 200 && engine.getLatencySamples() != 2048; ++i)
+                runBlocks(engine, 1, 5);
+            expectEquals(engine.getLatencySamples(), 2048);
+
+            runBlocks(engine, 200, 0);
+            juce::Thread::sleep(20);
+
+            expectEquals(engine.getCurrentFFTSize(), 2048);
+            expectEquals(engine.getLatencySamples(), 2048);
+            engine.releaseResources();
+        }
+
+        beginTest("A sine passes without gaps while the overlap changes");
+        {
+            CDPSpectralEngine engine;
+            engine.prepareToPlay(kSampleRate, kSineBlockSize, 2);
+            const int latency = engine.getLatencySamples();
+
+            constexpr int numBlocks = 240;
+            juce::AudioBuffer<float> block(2, kSineBlockSize);
+            float maxError = 0.0f;
+            for (int b = 0; b < numBlocks; ++b)
+            {
+                if (b == 40)  engine.setOverlapFactor(0.5f);
+                if (b == 120) engine.setOverlapFactor(0.875f);
+                if (b == 200) engine.setWindowType(juce::dsp::WindowingFunction<float>::hamming);
+
+                for (int ch = 0; ch < 2; ++ch)
+                    for (int i = 0; i < kSineBlockSize; ++i)
+                        block.setSample(ch, i, sineAt(b * kSineBlockSize + i));
+
+                engine.processBlock(block);
+
+                // Unprocessed bins reconstruct the input, delayed by the latency
+                for (int i = 0; i < kSineBlockSize; ++i)
+                {
+                    const int t = b * kSineBlockSize + i;
+                    if (t >= latency)
+                        maxError = juce::jmax(maxError, std::abs(block.getSample(0, i) - sineAt(t - latency)));
+                }
+                juce::Thread::sleep(2);   // lets the processing thread build each new STFT
+            }
+
+            expect(maxError < 1.0e-3f, "max error " + juce::String(maxError));
+            engine.releaseResources();
+        }
+    }
+
+private:
+    static constexpr double kSampleRate = 48000.0;
+    static constexpr int kBlockSize = 64;
+    static constexpr int kSineBlockSize = 256;
+
+    static float sineAt(int t)
+    {
+        return 0.5f * (float) std::sin(juce::MathConstants<double>::twoPi * 440.0 * t / kSampleRate);
+    }
+
+    static void runBlocks(CDPSpectralEngine& engine, int numBlocks, int sleepMs)
+    {
+        juce::AudioBuffer<float> buffer(2, kBlockSize);
+        juce::Random random(3);
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                for (int i = 0; i < kBlockSize; ++i)
+                    buffer.setSample(ch, i, random.nextFloat() * 0.5f - 0.25f);
+
+            engine.processBlock(buffer);
+            if (sleepMs > 0)
+                juce::Thread::sleep(sleepMs);
+        }
+    }
+};
+
+static TestCDPAdaptiveMode testCDPAdaptiveMode;
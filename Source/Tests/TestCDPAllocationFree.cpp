@@ -0,0 +1,124 @@
+/**
+ * CDP spectral effects must not touch the heap on the audio thread, and must
+ * render identically when determinism is enabled.
+ */
+
+#include <JuceHeader.h>
+#include "Core/CDPSpectralEngine.h"
+#include "Util/AllocationCounter.h"
+#include "Util/Determinism.h"
+
+class TestCDPAllocationFree : public juce::UnitTest
+{
+public:
+    TestCDPAllocationFree()
+        : UnitTest("CDP Allocation-Free Kernels", "Audio")
+    {
+    }
+
+    void runTest() override
+    {
+        using Effect = CDPSpectralEngine::SpectralEffect;
+
+        beginTest("Single effects allocate nothing per block");
+        for (auto effect : { Effect::Blur, Effect::Randomize, Effect::Shuffle, Effect::Freeze,
+                             Effect::Arpeggiate, Effect::TimeExpand, Effect::Average })
+        {
+            CDPSpectralEngine engine;
+            engine.prepareToPlay(kSampleRate, kBlockSize, 2);
+            engine.setSpectralEffect(effect, 0.7f);
+            expectEquals(countAllocations(engine), (uint64_t) 0,
+                         "effect " + juce::String(static_cast<int>(effect)) + " allocated");
+            engine.releaseResources();
+        }
+
+        beginTest("Layered effects allocate nothing per block");
+        {
+            CDPSpectralEngine engine;
+            engine.prepareToPlay(kSampleRate, kBlockSize, 2);
+            engine.setSpectralEffect(Effect::Shuffle, 0.5f);
+            engine.addSpectralLayer(Effect::Blur, 0.8f, 0.5f);
+            engine.addSpectralLayer(Effect::Randomize, 0.3f, 0.7f);
+            expectEquals(countAllocations(engine), (uint64_t) 0);
+            engine.releaseResources();
+        }
+
+        beginTest("Randomising effects are reproducible under determinism");
+        {
+            namespace Det = SpectralCanvas::Determinism;
+            const bool wasEnabled = Det::IsEnabled();
+            const auto oldSeed = Det::GetSeed();
+            Det::SetEnabled(true);
+            Det::SetSeed(1234u);
+
+            auto a = render(Effect::Randomize);
+            auto b = render(Effect::Randomize);
+            expect(a.getNumSamples() == b.getNumSamples());
+            float maxDiff = 0.0f;
+            for (int ch = 0; ch < a.getNumChannels(); ++ch)
+                for (int i = 0; i < a.getNumSamples(); ++i)
+                    maxDiff = juce::jmax(maxDiff, std::abs(a.getSample(ch, i) - b.getSample(ch, i)));
+            expectEquals(maxDiff, 0.0f);
+
+            Det::SetEnabled(wasEnabled);
+            Det::SetSeed(oldSeed);
+        }
+    }
+
+private:
+    static constexpr double kSampleRate = 48000.0;
+    static constexpr int kBlockSize = 256;
+    static constexpr int kWarmupBlocks = 16;
+    static constexpr int kMeasuredBlocks = 200;
+
+    static void fillNoise(juce::AudioBuffer<float>& buffer, juce::Random& random)
+    {
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                buffer.setSample(ch, i, random.nextFloat() * 0.5f - 0.25f);
+    }
+
+    // Allocations made by processBlock on this thread after warm-up
+    static uint64_t countAllocations(CDPSpectralEngine& engine)
+    {
+        juce::AudioBuffer<float> buffer(2, kBlockSize);
+        juce::Random random(42);
+
+        for (int i = 0; i < kWarmupBlocks; ++i)
+        {
+            fillNoise(buffer, random);
+            engine.processBlock(buffer);
+        }
+
+        SpectralCanvas::AllocationCounter::ScopedThreadCount count;
+        for (int i = 0; i < kMeasuredBlocks; ++i)
+        {
+            fillNoise(buffer, random);
+            engine.processBlock(buffer);
+        }
+        return count.count();
+    }
+
+    static juce::AudioBuffer<float> render(CDPSpectralEngine::SpectralEffect effect)
+    {
+        CDPSpectralEngine engine;
+        engine.setProcessingMode(CDPSpectralEngine::ProcessingMode::Quality); // no adaptive FFT changes mid-render
+        engine.prepareToPlay(kSampleRate, kBlockSize, 2);
+        engine.setSpectralEffect(effect, 0.6f);
+
+        juce::AudioBuffer<float> out(2, kBlockSize * 32);
+        juce::AudioBuffer<float> block(2, kBlockSize);
+        juce::Random random(7);
+        for (int b = 0; b < 32; ++b)
+        {
+            fillNoise(block, random);
+            engine.processBlock(block);
+            for (int ch = 0; ch < 2; ++ch)
+                out.copyFrom(ch, b * kBlockSize, block, ch, 0, kBlockSize);
+        }
+        engine.releaseResources();
+        return out;
+    }
+};
+
+static TestCDPAllocationFree testCDPAllocationFree;
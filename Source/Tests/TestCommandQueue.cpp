@@ -0,0 +1,83 @@
+/**
+ * Commands are 32-byte records; path-carrying ones keep their text in the
+ * CommandArena. The queue must hand strings through intact, give every arena
+ * slot back once the command is processed or rejected, and process in order
+ * across batches without dropping what a time limit leaves behind.
+ */
+
+#include <JuceHeader.h>
+#include "Core/CommandQueue.h"
+
+class TestCommandQueue : public juce::UnitTest
+{
+public:
+    TestCommandQueue()
+        : UnitTest("Command Queue", "Audio")
+    {
+    }
+
+    void runTest() override
+    {
+        auto& arena = CommandArena::getInstance();
+
+        beginTest("Path commands carry their string through the arena");
+        {
+            CommandQueue<64> queue;
+            const int slotsBefore = arena.getNumSlotsInUse();
+
+            const juce::String path = "/exports/" + juce::String::repeatedString("take", 100) + ".wav";
+            expect(queue.push(Command(RecordingCommandID::ExportToFile, path)));
+            expect(queue.push(Command(PaintCommandID::BeginStroke, 1.0f, 2.0f, 0.5f, juce::Colours::red)));
+            expectEquals(arena.getNumSlotsInUse(), slotsBefore + 1);
+
+            juce::String received;
+            juce::Colour colour;
+            queue.processAll([&](const Command& cmd) {
+                if (cmd.hasStringParam())
+                    received = cmd.getStringParam();
+                else
+                    colour = cmd.getColour();
+            });
+
+            expect(received == path);
+            expect(colour == juce::Colours::red);
+            expectEquals(arena.getNumSlotsInUse(), slotsBefore);
+        }
+
+        beginTest("Rejected pushes give their string back");
+        {
+            CommandQueue<8> queue;
+            const int slotsBefore = arena.getNumSlotsInUse();
+
+            while (queue.push(Command(PaintCommandID::UpdateStroke, 0.0f, 0.0f, 1.0f)))
+            {
+            }
+            expect(! queue.push(Command(RecordingCommandID::SetRecordingDirectory, juce::String("/tmp"))));
+            expectEquals(arena.getNumSlotsInUse(), slotsBefore);
+        }
+
+        beginTest("Time-limited batches keep unprocessed commands in order");
+        {
+            CommandQueue<256> queue;
+            for (int i = 0; i < 100; ++i)
+                expect(queue.push(Command(ForgeCommandID::SetVolume, i, 0.5f)));
+
+            int next = 0;
+            bool inOrder = true;
+            auto check = [&](const Command& cmd) { inOrder = inOrder && cmd.intParam == next++; };
+
+            const int first = queue.processWithTimeLimit([&](const Command& cmd) {
+                check(cmd);
+                juce::Thread::sleep(1);
+            }, 0.5);
+            expectEquals(first, 1);
+            expectEquals(queue.getNumReady(), 99);
+
+            expectEquals(queue.processAll(check), 99);
+            expect(inOrder);
+            expect(queue.isEmpty());
+        }
+    }
+};
+
+static TestCommandQueue testCommandQueue;
@@ -0,0 +1,200 @@
+/**
+ * EMURomplerEngine voices play their (streamed) sample through the Hermite
+ * interpolation kernel with block-rate modulation. At the root key and the
+ * session rate a voice must reproduce the file; transposed notes must come
+ * out at the transposed pitch whatever the file's rate; MIDI events must
+ * take effect on their own sample within the block; and a full 64-voice
+ * load must render clean output without allocating. (Its CPU cost is
+ * tracked by bench_audio_path.)
+ */
+
+#include <JuceHeader.h>
+#include "Core/EMURomplerEngine.h"
+#include "Util/AllocationCounter.h"
+
+class TestEMUVoiceRendering : public juce::UnitTest
+{
+public:
+    TestEMUVoiceRendering()
+        : UnitTest("EMU Voice Rendering", "Audio")
+    {
+    }
+
+    void runTest() override
+    {
+        constexpr double hostRate = 48000.0;
+        constexpr int blockSize = 512;
+
+        beginTest("Root key at the session rate reproduces the sample");
+        {
+            juce::TemporaryFile wav(".wav");
+            expect(writeSine(wav.getFile(), hostRate, 1, 480.0, 24000));
+
+            EMURomplerEngine engine;
+            engine.prepareToPlay(hostRate, blockSize, 2);
+            expect(engine.addSample(makeInfo(wav.getFile())));
+            engine.setAttackTime(0.001f);
+            engine.setSustainLevel(1.0f);
+            engine.setMasterVolume(1.0f);
+            engine.noteOn(60, 1.0f);
+
+            float maxError = 0.0f;
+            juce::AudioBuffer<float> block(2, blockSize);
+            juce::MidiBuffer midi;
+            for (int b = 0; b < 50; ++b)
+            {
+                engine.processBlock(block, midi);
+                for (int i = 0; i < blockSize; ++i)
+                {
+                    const int frame = b * blockSize + i;
+                    if (frame < 100 || frame >= 24000)
+                        continue;   // attack ramp, then past the end
+
+                    const float expected = sineValue(hostRate, 480.0, frame);
+                    maxError = juce::jmax(maxError, std::abs(block.getSample(0, i) - expected),
+                                          std::abs(block.getSample(1, i) - expected));
+                }
+                juce::Thread::sleep(1);
+            }
+            expect(maxError < 1.0e-4f, "max error " + juce::String(maxError));
+            expectEquals(block.getMagnitude(0, blockSize), 0.0f);
+            engine.releaseResources();
+        }
+
+        beginTest("Transposed notes play at pitch across sample rates");
+        {
+            juce::TemporaryFile wav(".wav");
+            expect(writeSine(wav.getFile(), 44100.0, 2, 441.0, 44100));
+
+            EMURomplerEngine engine;
+            engine.prepareToPlay(hostRate, blockSize, 2);
+            expect(engine.addSample(makeInfo(wav.getFile())));
+            engine.setAttackTime(0.001f);
+            engine.setSustainLevel(1.0f);
+            engine.noteOn(72, 1.0f);
+
+            // Upward zero crossings over half a second: 882Hz -> 441
+            int crossings = 0;
+            float previous = 0.0f;
+            juce::AudioBuffer<float> block(2, blockSize);
+            juce::MidiBuffer midi;
+            for (int b = 0; b < 47; ++b)
+            {
+                engine.processBlock(block, midi);
+                for (int i = 0; i < blockSize && b * blockSize + i < 24000; ++i)
+                {
+                    const float current = block.getSample(0, i);
+                    if (previous < 0.0f && current >= 0.0f)
+                        ++crossings;
+                    previous = current;
+                }
+                juce::Thread::sleep(1);
+            }
+            expect(std::abs(crossings - 441) <= 2, "crossings " + juce::String(crossings));
+            engine.releaseResources();
+        }
+
+        beginTest("MIDI events take effect at their sample position");
+        {
+            juce::TemporaryFile wav(".wav");
+            expect(writeSine(wav.getFile(), hostRate, 1, 480.0, 24000));
+
+            EMURomplerEngine engine;
+            engine.prepareToPlay(hostRate, blockSize, 2);
+            expect(engine.addSample(makeInfo(wav.getFile())));
+            engine.setAttackTime(0.001f);
+            engine.setSustainLevel(1.0f);
+            engine.setReleaseTime(0.001f);
+            engine.setMasterVolume(1.0f);
+
+            juce::AudioBuffer<float> block(2, blockSize);
+            juce::MidiBuffer midi;
+            midi.addEvent(juce::MidiMessage::noteOn(1, 60, 1.0f), 300);
+            engine.processBlock(block, midi);
+            expectEquals(block.getMagnitude(0, 300), 0.0f);
+            expect(block.getMagnitude(400, blockSize - 400) > 0.4f);
+
+            // The release starts at the note-off, not at the next block
+            midi.clear();
+            midi.addEvent(juce::MidiMessage::noteOff(1, 60), 100);
+            engine.processBlock(block, midi);
+            expect(block.getMagnitude(0, 100) > 0.4f);
+            expectEquals(block.getMagnitude(200, blockSize - 200), 0.0f);
+            expectEquals(engine.getPerformanceInfo().activeVoices, 0);
+            engine.releaseResources();
+        }
+
+        beginTest("64 voices render finite audio without allocating");
+        {
+            juce::TemporaryFile wav(".wav");
+            expect(writeSine(wav.getFile(), 44100.0, 2, 220.0, 441000));
+
+            EMURomplerEngine engine;
+            engine.prepareToPlay(hostRate, blockSize, 2);
+            expect(engine.addSample(makeInfo(wav.getFile())));
+            engine.setFilterCutoff(0.6f);
+            engine.setFilterResonance(0.5f);
+            engine.setLFODepth(0.5f);
+            engine.setLFODestination(1);
+
+            for (int note = 36; note < 100; ++note)
+                engine.noteOn(note, 0.5f);
+
+            juce::AudioBuffer<float> block(2, blockSize);
+            juce::MidiBuffer midi;
+            bool finite = true;
+            float peak = 0.0f;
+            uint64_t allocations = 0;
+            for (int b = 0; b < 50; ++b)
+            {
+                {
+                    SpectralCanvas::AllocationCounter::ScopedThreadCount count;
+                    engine.processBlock(block, midi);
+                    allocations += count.count();
+                }
+
+                for (int ch = 0; ch < block.getNumChannels(); ++ch)
+                    for (int i = 0; i < blockSize; ++i)
+                        finite = finite && std::isfinite(block.getSample(ch, i));
+                peak = juce::jmax(peak, block.getMagnitude(0, blockSize));
+                juce::Thread::sleep(1);
+            }
+
+            expect(finite);
+            expect(peak > 0.0f);
+            expectEquals(allocations, (uint64_t) 0);
+            expectEquals(engine.getPerformanceInfo().activeVoices, 64);
+            engine.releaseResources();
+        }
+    }
+
+private:
+    static EMURomplerEngine::SampleInfo makeInfo(const juce::File& file)
+    {
+        EMURomplerEngine::SampleInfo info;
+        info.name = file.getFileNameWithoutExtension();
+        info.category = EMURomplerEngine::SampleCategory::Leads;
+        info.sampleFile = file;
+        return info;
+    }
+
+    static float sineValue(double sampleRate, double frequency, int frame)
+    {
+        return 0.5f * (float) std::sin(juce::MathConstants<double>::twoPi * frequency * frame / sampleRate);
+    }
+
+    static bool writeSine(const juce::File& file, double sampleRate, int numChannels, double frequency, int length)
+    {
+        juce::AudioBuffer<float> sine(numChannels, length);
+        for (int channel = 0; channel < numChannels; ++channel)
+            for (int i = 0; i < length; ++i)
+                sine.setSample(channel, i, sineValue(sampleRate, frequency, i));
+
+        juce::WavAudioFormat format;
+        std::unique_ptr<juce::AudioFormatWriter> writer(format.createWriterFor(new juce::FileOutputStream(file),
+                                                                                sampleRate, (unsigned int) numChannels, 32, {}, 0));
+        return writer != nullptr && writer->writeFromAudioSampleBuffer(sine, 0, length);
+    }
+};
+
+static TestEMUVoiceRendering testEMUVoiceRendering;
@@ -0,0 +1,48 @@
+/**
+ * SpectralSynthEngine holds stamped gestures until they are due. A stamp
+ * that is far in the future (or taken against a stale clock anchor) must be
+ * bounded when it is dequeued, so it cannot hold back the gestures queued
+ * behind it.
+ */
+
+#include <JuceHeader.h>
+#include "Core/SpectralSynthEngine.h"
+
+class TestGestureScheduling : public juce::UnitTest
+{
+public:
+    TestGestureScheduling()
+        : UnitTest("Gesture Scheduling", "Audio")
+    {
+    }
+
+    void runTest() override
+    {
+        constexpr double sampleRate = 48000.0;
+        constexpr int blockSize = 256;
+
+        beginTest("A far-future stamp does not stall later gestures");
+        {
+            SpectralSynthEngine engine;
+            engine.setLoadGovernorEnabled(false);
+            engine.prepare(sampleRate, blockSize);
+
+            engine.pushGestureRT(PaintEvent(0.5f, 0.3f, 0.8f, kStrokeStart), (int64_t) 1 << 40);
+            engine.pushGestureRT(PaintEvent(0.5f, 0.7f, 0.8f, kStrokeStart));   // unstamped: play now
+
+            juce::AudioBuffer<float> block(2, blockSize);
+            float peak = 0.0f;
+            for (int b = 0; b < 4; ++b)
+            {
+                engine.processAudioBlock(block, sampleRate);
+                peak = juce::jmax(peak, block.getMagnitude(0, blockSize));
+            }
+
+            expectEquals((int) engine.getQueueSize(), 0);
+            expect(peak > 0.0f);
+            engine.releaseResources();
+        }
+    }
+};
+
+static TestGestureScheduling testGestureScheduling;
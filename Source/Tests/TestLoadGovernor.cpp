@@ -0,0 +1,164 @@
+/**
+ * LoadGovernor steps quality down while the audio thread runs near its
+ * deadline and back up only after a sustained calm period. Partials it drops
+ * or restores on a sounding voice must fade rather than click.
+ */
+
+#include <JuceHeader.h>
+#include "dsp/LoadGovernor.h"
+#include "dsp/Voice.h"
+
+class TestLoadGovernor : public juce::UnitTest
+{
+public:
+    TestLoadGovernor()
+        : UnitTest("Load Governor", "Audio")
+    {
+    }
+
+    void runTest() override
+    {
+        beginTest("Sustained load steps quality down the ladder");
+        {
+            LoadGovernor governor;
+            governor.prepare(kSampleRate, kMaxVoices);
+            expectEquals(governor.getLevel(), 0);
+
+            run(governor, 0.9, 0.1);
+            expect(governor.getLevel() > 0);
+            expect(governor.getPartialScale() < 1.0f);
+            expectEquals(governor.getVoiceCap(), kMaxVoices);   // partials go first
+
+            run(governor, 0.9, 2.0);
+            expectEquals(governor.getPartialScale(), 0.25f);
+            expect(governor.getVoiceCap() < kMaxVoices);
+            expect(governor.getVoiceCap() >= 1);
+            expectEquals(governor.getStats().level.load(), governor.getLevel());
+        }
+
+        beginTest("A single overrun steps down at once");
+        {
+            LoadGovernor governor;
+            governor.prepare(kSampleRate, kMaxVoices);
+            expect(governor.update(1.5 * kBlockSize / kSampleRate, kBlockSize));
+            expectEquals(governor.getLevel(), 1);
+        }
+
+        beginTest("Load between the thresholds or a short calm does not restore");
+        {
+            LoadGovernor governor;
+            governor.prepare(kSampleRate, kMaxVoices);
+            run(governor, 0.9, 0.1);
+            const int degraded = governor.getLevel();
+            expect(degraded > 0);
+
+            run(governor, 0.55, 2.0);
+            expectEquals(governor.getLevel(), degraded);
+
+            // Calm spells shorter than kRestoreSeconds, each broken by a busier spell
+            for (int i = 0; i < 4; ++i)
+            {
+                run(governor, 0.1, LoadGovernor::kRestoreSeconds * 0.6);
+                run(governor, 0.6, 0.1);
+            }
+            expectEquals(governor.getLevel(), degraded);
+            expectEquals((int) governor.getStats().restoreCount.load(), 0);
+        }
+
+        beginTest("Sustained calm restores one step per hold period");
+        {
+            LoadGovernor governor;
+            governor.prepare(kSampleRate, kMaxVoices);
+            run(governor, 0.9, 2.0);
+            const int degraded = governor.getLevel();
+            expect(degraded > 1);
+
+            run(governor, 0.1, LoadGovernor::kRestoreSeconds + 0.1);
+            expectEquals(governor.getLevel(), degraded - 1);
+
+            run(governor, 0.1, (LoadGovernor::kRestoreSeconds + 0.1) * degraded);
+            expectEquals(governor.getLevel(), 0);
+            expectEquals(governor.getPartialScale(), 1.0f);
+            expectEquals(governor.getVoiceCap(), kMaxVoices);
+            expectEquals((int) governor.getStats().restoreCount.load(), degraded);
+        }
+
+        beginTest("A disabled governor stays at full quality");
+        {
+            LoadGovernor governor;
+            governor.prepare(kSampleRate, kMaxVoices);
+            governor.setEnabled(false);
+            run(governor, 1.5, 1.0);
+            expectEquals(governor.getLevel(), 0);
+        }
+
+        beginTest("Dropped and restored partials fade instead of clicking");
+        {
+            // `scaled` changes its partial scale; the other two keep the scale it
+            // had before, so any difference is what the change added or removed
+            Voice scaled, full, lowered;
+            for (auto* v : { &scaled, &full, &lowered })
+            {
+                v->prepare(kSampleRate, kBlockSize, 16);
+                v->noteOn(220.0f, 0.5f, 16, 0.0f);
+            }
+
+            juce::AudioBuffer<float> a(1, kBlockSize), b(1, kBlockSize), c(1, kBlockSize);
+            auto render = [&]
+            {
+                a.clear();
+                b.clear();
+                c.clear();
+                scaled.process(a, 0, kBlockSize, false);
+                full.process(b, 0, kBlockSize, false);
+                lowered.process(c, 0, kBlockSize, false);
+            };
+
+            for (int i = 0; i < 4; ++i)
+                render();
+
+            scaled.setPartialScale(0.25f);
+            lowered.setPartialScale(0.25f);
+            render();
+            expectFades(a, b);
+
+            scaled.setPartialScale(1.0f);
+            render();
+            expectFades(a, c);
+        }
+    }
+
+private:
+    static constexpr double kSampleRate = 48000.0;
+    static constexpr int kBlockSize = 480;
+    static constexpr int kMaxVoices = 64;
+
+    // Across the block `changed` must move away from `unchanged` gradually:
+    // one sample in the difference is still tiny, by the end it is not.
+    void expectFades(const juce::AudioBuffer<float>& changed, const juce::AudioBuffer<float>& unchanged)
+    {
+        const int fadeSamples = (int) (kSampleRate * 0.005);
+        float start = 0.0f, settled = 0.0f;
+        for (int i = 0; i < kBlockSize; ++i)
+        {
+            const float diff = std::abs(changed.getSample(0, i) - unchanged.getSample(0, i));
+            if (i < 8)
+                start = juce::jmax(start, diff);
+            else if (i >= fadeSamples)
+                settled = juce::jmax(settled, diff);
+        }
+
+        expect(start < 0.01f, "step of " + juce::String(start));
+        expect(settled > 10.0f * start, "change never took effect");
+    }
+
+    // Reports blocks that each take `load` of the deadline for `seconds`.
+    static void run(LoadGovernor& governor, double load, double seconds)
+    {
+        const int numBlocks = (int) (seconds * kSampleRate / kBlockSize);
+        for (int i = 0; i < numBlocks; ++i)
+            governor.update(load * kBlockSize / kSampleRate, kBlockSize);
+    }
+};
+
+static TestLoadGovernor testLoadGovernor;
@@ -0,0 +1,149 @@
+/**
+ * MaskSnapshot commits publish only the tiles painted since the previous
+ * commit; everything else is shared with the earlier snapshot, and the
+ * active-pixel statistics must match a full scan of the mask. A snapshot
+ * pinned by the audio thread must survive any number of commits, and
+ * whole-column extraction must agree with sampling the mask bin by bin.
+ */
+
+#include <JuceHeader.h>
+#include "Core/MaskSnapshot.h"
+
+class TestMaskSnapshotTiles : public juce::UnitTest
+{
+public:
+    TestMaskSnapshotTiles()
+        : UnitTest("Mask Snapshot Tiles", "Audio")
+    {
+    }
+
+    void runTest() override
+    {
+        using Mask = MaskSnapshot;
+
+        beginTest("Untouched tiles are shared between snapshots");
+        {
+            MaskSnapshot snapshot;
+            snapshot.prepareToPlay(48000.0, 512);
+            snapshot.paintCircle(0.1f, 0.1f, 0.02f, 0.25f);
+            snapshot.commitWorkBuffer();
+            snapshot.beginAudioBlock();
+            const auto first = snapshot.getCurrentSnapshot()->tiles;
+
+            // One small brush dab in the far corner only touches its own tile
+            snapshot.paintCircle(0.95f, 0.9f, 0.01f, 0.5f);
+            snapshot.commitWorkBuffer();
+            snapshot.beginAudioBlock();
+            const auto* second = snapshot.getCurrentSnapshot();
+
+            int changed = 0;
+            for (int i = 0; i < Mask::NUM_TILES; ++i)
+                changed += second->tiles[(size_t) i] != first[(size_t) i] ? 1 : 0;
+            expectEquals(changed, 1);
+            expectWithinAbsoluteError(second->getMaskValue(int(0.95f * Mask::MASK_WIDTH), int(0.9f * Mask::MASK_HEIGHT)),
+                                      0.5f, 1.0e-6f);
+            expectWithinAbsoluteError(second->getMaskValue(int(0.1f * Mask::MASK_WIDTH), int(0.1f * Mask::MASK_HEIGHT)),
+                                      0.25f, 1.0e-6f);
+        }
+
+        beginTest("Active pixel statistics match a full scan");
+        {
+            MaskSnapshot snapshot;
+            snapshot.paintLine(0.0f, 0.2f, 1.0f, 0.8f, 0.02f, 0.3f);
+            snapshot.paintRectangle(0.4f, 0.4f, 0.2f, 0.1f, 0.6f);
+            snapshot.paintCircle(0.5f, 0.45f, 0.03f, 1.0f);       // erase part of the rectangle
+            snapshot.commitWorkBuffer();
+            snapshot.beginAudioBlock();
+
+            const auto* data = snapshot.getCurrentSnapshot();
+            int expected = 0;
+            for (int y = 0; y < Mask::MASK_HEIGHT; ++y)
+                for (int x = 0; x < Mask::MASK_WIDTH; ++x)
+                    expected += std::abs(data->getMaskValue(x, y) - 1.0f) > 0.001f ? 1 : 0;
+
+            expect(expected > 0);
+            expectEquals(snapshot.getStatistics().activeMaskPixels, expected);
+
+            snapshot.clearWorkBuffer();
+            snapshot.commitWorkBuffer();
+            snapshot.beginAudioBlock();
+            expectEquals(snapshot.getStatistics().activeMaskPixels, 0);
+            expect(snapshot.getCurrentSnapshot()->tiles[0] == Mask::blankTile());
+        }
+
+        beginTest("Pinned snapshot is never recycled by later commits");
+        {
+            MaskSnapshot snapshot;
+            snapshot.paintRectangle(0.0f, 0.0f, 1.0f, 1.0f, 0.5f);
+            snapshot.commitWorkBuffer();
+            snapshot.beginAudioBlock();
+            const auto* pinned = snapshot.getCurrentSnapshot();
+
+            // Commits the audio thread never picks up just supersede each other
+            for (int i = 0; i < 10; ++i)
+            {
+                snapshot.paintRectangle(0.0f, 0.0f, 1.0f, 1.0f, 0.05f * float(i));
+                snapshot.commitWorkBuffer();
+                expect(snapshot.getCurrentSnapshot() == pinned);
+                expectEquals(pinned->getMaskValue(100, 100), 0.5f);
+            }
+
+            snapshot.beginAudioBlock();
+            expect(snapshot.getCurrentSnapshot() != pinned);
+            expectWithinAbsoluteError(snapshot.getCurrentSnapshot()->getMaskValue(100, 100), 0.45f, 1.0e-6f);
+
+            // Nothing new published: the same snapshot stays pinned
+            const auto* latest = snapshot.getCurrentSnapshot();
+            snapshot.beginAudioBlock();
+            expect(snapshot.getCurrentSnapshot() == latest);
+        }
+
+        beginTest("Column extraction matches per-bin bilinear sampling");
+        {
+            constexpr int fftSize = 2048;
+            constexpr double sampleRate = 48000.0;
+
+            MaskSnapshot snapshot;
+            snapshot.prepareToPlay(sampleRate, 512);
+            snapshot.prepareBinMapping(fftSize, sampleRate);
+            snapshot.paintRectangle(0.3f, 0.2f, 0.4f, 0.5f, 0.2f);
+            snapshot.paintCircle(0.55f, 0.6f, 0.1f, 0.7f);
+            snapshot.setMaskStrength(1.5f);
+            snapshot.setMaskBlend(0.8f);
+            snapshot.commitWorkBuffer();
+            snapshot.beginAudioBlock();
+
+            const int numBins = fftSize / 2 + 1;
+            expectEquals(snapshot.getNumMappedBins(), numBins);
+
+            const auto* data = snapshot.getCurrentSnapshot();
+            const float timeNorm = 0.513f;
+            std::vector<float> gains((size_t) numBins);
+            snapshot.extractColumn(timeNorm, gains.data(), numBins);
+
+            float maxError = 0.0f;
+            for (int bin = 0; bin < numBins; ++bin)
+            {
+                const double frequency = bin * sampleRate / fftSize;
+                const double y = frequency <= data->minFreq ? 0.0
+                               : frequency >= data->maxFreq ? Mask::MASK_HEIGHT - 1
+                               : std::log2(frequency / data->minFreq) / std::log2(data->maxFreq / data->minFreq) * (Mask::MASK_HEIGHT - 1);
+                const float value = data->sampleBilinear(timeNorm * (Mask::MASK_WIDTH - 1), (float) y);
+                const float expected = juce::jlimit(0.0f, 1.0f, 0.2f + 0.8f * juce::jlimit(0.0f, 1.0f, value * 1.5f));
+                maxError = juce::jmax(maxError, std::abs(gains[(size_t) bin] - expected));
+            }
+            expect(maxError < 1.0e-4f, "max error " + juce::String(maxError));
+
+            // applyMask scales real and imaginary parts by the same gains
+            std::vector<std::complex<float>> bins((size_t) numBins, { 1.0f, -2.0f });
+            snapshot.applyMask(timeNorm, bins.data(), numBins);
+            for (int bin = 0; bin < numBins; bin += 97)
+            {
+                expectWithinAbsoluteError(bins[(size_t) bin].real(), gains[(size_t) bin], 1.0e-6f);
+                expectWithinAbsoluteError(bins[(size_t) bin].imag(), -2.0f * gains[(size_t) bin], 1.0e-6f);
+            }
+        }
+    }
+};
+
+static TestMaskSnapshotTiles testMaskSnapshotTiles;
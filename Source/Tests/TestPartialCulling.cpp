@@ -0,0 +1,91 @@
+/**
+ * Voice renders only partials that are below Nyquist and above the
+ * audibility floor. Culled partials must come back once they fit again:
+ * when a glide lowers the pitch, or when a note is retriggered louder.
+ */
+
+#include <JuceHeader.h>
+#include "dsp/Voice.h"
+
+class TestPartialCulling : public juce::UnitTest
+{
+public:
+    TestPartialCulling()
+        : UnitTest("Partial Culling", "Audio")
+    {
+    }
+
+    void runTest() override
+    {
+        beginTest("Partials above Nyquist are culled and return when the pitch falls");
+        {
+            Voice voice;
+            voice.prepare(kSampleRate, kBlockSize, kPartials);
+
+            // 0.49 x 48 kHz = 23.52 kHz: 11 harmonics of 2 kHz fit, 3 of 6 kHz
+            voice.noteOn(2000.0f, 0.5f, kPartials, 0.0f);
+            expectEquals(voice.getNumAudiblePartials(), 11);
+
+            voice.setPitch(6000.0f);
+            expectEquals(voice.getNumAudiblePartials(), 3);
+
+            voice.setPitch(500.0f);
+            expectEquals(voice.getNumAudiblePartials(), kPartials);
+
+            // The returning partials really sound: once they have faded in the
+            // glided voice carries the same energy as a fresh note at 500 Hz
+            Voice fresh;
+            fresh.prepare(kSampleRate, kBlockSize, kPartials);
+            fresh.noteOn(500.0f, 0.5f, kPartials, 0.0f);
+
+            render(voice, 4);
+            render(fresh, 4);
+            const float glidedRms = render(voice, 10);
+            const float freshRms = render(fresh, 10);
+            expectWithinAbsoluteError(glidedRms, freshRms, 0.02f * freshRms);
+        }
+
+        beginTest("Partials under the audibility floor are culled and return at a higher level");
+        {
+            Voice voice;
+            voice.prepare(kSampleRate, kBlockSize, kPartials);
+
+            // Harmonic h has gain 1/h: at 1e-4 only h <= 10 clear the 1e-5 floor
+            voice.noteOn(100.0f, 1.0e-4f, kPartials, 0.0f);
+            expectEquals(voice.getNumAudiblePartials(), 10);
+
+            // The output gain counts too
+            voice.noteOn(100.0f, 1.0e-2f, kPartials, 0.0f, 1.0e-2f);
+            expectEquals(voice.getNumAudiblePartials(), 10);
+
+            voice.noteOn(100.0f, 0.5f, kPartials, 0.0f);
+            expectEquals(voice.getNumAudiblePartials(), kPartials);
+
+            voice.noteOn(100.0f, 1.0e-6f, kPartials, 0.0f);
+            expectEquals(voice.getNumAudiblePartials(), 0);
+            expect(! voice.isActive());
+        }
+    }
+
+private:
+    static constexpr double kSampleRate = 48000.0;
+    static constexpr int kBlockSize = 480;
+    static constexpr int kPartials = 16;
+
+    // RMS over numBlocks blocks (a whole number of 100 Hz periods)
+    static float render(Voice& voice, int numBlocks)
+    {
+        juce::AudioBuffer<float> buffer(1, kBlockSize);
+        double sum = 0.0;
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            buffer.clear();
+            voice.process(buffer, 0, kBlockSize, false);
+            for (int i = 0; i < kBlockSize; ++i)
+                sum += buffer.getSample(0, i) * buffer.getSample(0, i);
+        }
+        return (float) std::sqrt(sum / (numBlocks * kBlockSize));
+    }
+};
+
+static TestPartialCulling testPartialCulling;
@@ -1,7 +1,80 @@
-// TestSTFT_Continuity.cpp - Stub test
+// TestSTFT_Continuity.cpp - STFTEngine identity reconstruction across block sizes
+#include "../Spectral/STFTEngine.h"
 #include <iostream>
+#include <cmath>
+
+namespace {
+
+// Feeds a two-tone signal through an untouched STFT in irregular host blocks and
+// checks the output equals the input delayed by the reported latency.
+int runIdentity(int fftSize, int hopSize, int hostBlock) {
+    using namespace SpectralCanvas::spectral;
+
+    const int numChannels = 2;
+    const int totalSamples = fftSize * 8;
+
+    STFTEngine stft;
+    stft.prepare(48000.0, STFTConfig{fftSize, hopSize, numChannels});
+
+    int framesSeen = 0;
+    stft.setFrameCallback([&](int, std::complex<float>*, int numBins) {
+        if (numBins == fftSize / 2 + 1) ++framesSeen;
+    });
+
+    juce::AudioBuffer<float> input(numChannels, totalSamples);
+    juce::AudioBuffer<float> output(numChannels, totalSamples);
+    for (int ch = 0; ch < numChannels; ++ch)
+        for (int n = 0; n < totalSamples; ++n)
+            input.setSample(ch, n, 0.5f * std::sin(0.031f * n * (ch + 1)) + 0.25f * std::sin(0.4f * n));
+
+    // Alternate between hostBlock and a prime-sized block to cross hop boundaries
+    int pos = 0;
+    bool odd = false;
+    while (pos < totalSamples) {
+        const int n = std::min(odd ? 37 : hostBlock, totalSamples - pos);
+        const float* in[numChannels] = { input.getReadPointer(0, pos), input.getReadPointer(1, pos) };
+        float* out[numChannels] = { output.getWritePointer(0, pos), output.getWritePointer(1, pos) };
+        stft.process(in, out, numChannels, n);
+        pos += n;
+        odd = !odd;
+    }
+
+    const int latency = stft.getLatencySamples();
+    float maxErr = 0.0f;
+    for (int ch = 0; ch < numChannels; ++ch)
+        for (int n = latency; n < totalSamples; ++n)
+            maxErr = std::max(maxErr, std::abs(output.getSample(ch, n) - input.getSample(ch, n - latency)));
+
+    const int expectedFrames = (totalSamples / hopSize) * numChannels;
+    const bool ok = maxErr < 1.0e-4f && framesSeen == expectedFrames;
+
+    std::cout << (ok ? "✓" : "✗") << " STFT identity N=" << fftSize << " hop=" << hopSize
+              << " block=" << hostBlock << " maxErr=" << maxErr
+              << " frames=" << framesSeen << "/" << expectedFrames << std::endl;
+    return ok ? 0 : 1;
+}
+
+} // namespace
 
 int TestSTFT_Continuity() {
-    std::cout << "[STUB] TestSTFT_Continuity not yet implemented" << std::endl;
-    return 0;  // Pass for now
+    int failures = 0;
+    failures += runIdentity(1024, 256, 512);
+    failures += runIdentity(1024, 256, 64);
+    failures += runIdentity(2048, 1024, 1000);
+    failures += runIdentity(4096, 512, 256);
+    failures += runIdentity(512, 512, 128);
+    return failures;
 }
+
+// Runs the identity checks as part of SpectralCanvasTests
+class STFTContinuityTest : public juce::UnitTest {
+public:
+    STFTContinuityTest() : juce::UnitTest("STFT Continuity", "Audio") {}
+
+    void runTest() override {
+        beginTest("Identity reconstruction across host block sizes");
+        expectEquals(TestSTFT_Continuity(), 0);
+    }
+};
+
+static STFTContinuityTest stftContinuityTest;
@@ -0,0 +1,136 @@
+/**
+ * SampleLoader decodes on its own threads, resamples to the session rate and
+ * hands finished buffers over through popFinished()/recycle(), freeing
+ * whatever comes back off the calling thread.
+ */
+
+#include <JuceHeader.h>
+#include "Core/SampleLoader.h"
+
+class TestSampleLoader : public juce::UnitTest
+{
+public:
+    TestSampleLoader()
+        : UnitTest("Sample Loader", "Audio")
+    {
+    }
+
+    void runTest() override
+    {
+        juce::TemporaryFile wav(".wav");
+        const double fileRate = 22050.0;
+        const double cyclesPerSecond = 441.0;
+        const int fileLength = 11025;
+        expect(writeSine(wav.getFile(), fileRate, cyclesPerSecond, fileLength));
+
+        beginTest("Decodes and resamples to the session rate off-thread");
+        {
+            SampleLoader loader;
+            loader.setSessionSampleRate(44100.0);
+            expect(loader.requestLoad(SampleLoader::Target::ForgeSlot, 3, wav.getFile()));
+
+            auto* loaded = waitForFinished(loader);
+            expect(loaded != nullptr);
+            if (loaded == nullptr)
+                return;
+
+            expect(loaded->success, loaded->errorMessage);
+            expectEquals(loaded->slot, 3);
+            expectEquals(loaded->sourceSampleRate, fileRate);
+            expectEquals(loaded->sampleRate, 44100.0);
+            expectEquals(loaded->buffer->getNumSamples(), 2 * fileLength);
+
+            // Away from the edges the resampled sine must still be the same tone
+            float maxError = 0.0f;
+            for (int i = 1000; i < 2 * fileLength - 1000; i += 37)
+            {
+                const float expected = 0.5f * (float) std::sin(juce::MathConstants<double>::twoPi * cyclesPerSecond * i / 44100.0);
+                maxError = juce::jmax(maxError, std::abs(loaded->buffer->getSample(0, i) - expected));
+            }
+            expect(maxError < 2.0e-3f, "max error " + juce::String(maxError));
+
+            // Forge loads carry their spectral-mask analysis, made off the audio thread
+            expect(! loaded->maskFrames.empty());
+
+            loader.recycle(loaded);
+            expect(waitForOutstanding(loader, 0));
+        }
+
+        beginTest("Peak normalisation and unreadable files");
+        {
+            SampleLoader loader;
+            loader.setPeakNormalisation(true, -6.0f);
+            expect(! loader.requestLoad(SampleLoader::Target::SampleMasking, 0, wav.getFile().getSiblingFile("missing.wav")));
+            expect(loader.requestLoad(SampleLoader::Target::SampleMasking, 0, wav.getFile()));
+
+            auto* loaded = waitForFinished(loader);
+            expect(loaded != nullptr && loaded->success);
+            if (loaded == nullptr)
+                return;
+
+            expectEquals(loaded->sampleRate, fileRate);   // no session rate yet: left as recorded
+            expectWithinAbsoluteError(loaded->buffer->getMagnitude(0, loaded->buffer->getNumSamples()),
+                                      juce::Decibels::decibelsToGain(-6.0f), 1.0e-4f);
+
+            loader.recycle(loaded);
+            expect(waitForOutstanding(loader, 0));
+        }
+
+        beginTest("Failed loads come back with their error");
+        {
+            juce::TemporaryFile junk(".wav");
+            expect(junk.getFile().replaceWithText("not audio"));
+
+            SampleLoader loader;
+            expect(loader.requestLoad(SampleLoader::Target::ForgeSlot, 0, junk.getFile()));
+
+            auto* loaded = waitForFinished(loader);
+            expect(loaded != nullptr && ! loaded->success);
+            if (loaded == nullptr)
+                return;
+
+            expect(loaded->errorMessage.isNotEmpty());
+            const auto message = loaded->errorMessage;
+            loader.recycle(loaded);
+            expect(waitForOutstanding(loader, 0));
+
+            const auto failures = loader.takeFailedLoads();
+            expectEquals(failures.size(), 1);
+            expectEquals(failures[0], message);
+            expect(loader.takeFailedLoads().isEmpty());
+        }
+    }
+
+private:
+    static bool writeSine(const juce::File& file, double sampleRate, double frequency, int length)
+    {
+        juce::AudioBuffer<float> sine(1, length);
+        for (int i = 0; i < length; ++i)
+            sine.setSample(0, i, 0.5f * (float) std::sin(juce::MathConstants<double>::twoPi * frequency * i / sampleRate));
+
+        juce::WavAudioFormat format;
+        std::unique_ptr<juce::AudioFormatWriter> writer(format.createWriterFor(new juce::FileOutputStream(file),
+                                                                                sampleRate, 1, 32, {}, 0));
+        return writer != nullptr && writer->writeFromAudioSampleBuffer(sine, 0, length);
+    }
+
+    static SampleLoader::LoadedSample* waitForFinished(SampleLoader& loader)
+    {
+        for (int i = 0; i < 500; ++i)
+        {
+            if (auto* loaded = loader.popFinished())
+                return loaded;
+            juce::Thread::sleep(10);
+        }
+        return nullptr;
+    }
+
+    static bool waitForOutstanding(SampleLoader& loader, int expected)
+    {
+        for (int i = 0; i < 500 && loader.getNumOutstanding() != expected; ++i)
+            juce::Thread::sleep(10);
+        return loader.getNumOutstanding() == expected;
+    }
+};
+
+static TestSampleLoader testSampleLoader;
@@ -0,0 +1,101 @@
+/**
+ * Paint masks are compiled into influence-vs-canvas-X envelopes and applied
+ * per sub-block; the result must follow the painted stroke along the sample,
+ * and stateful masks must not leak state between channels.
+ */
+
+#include <JuceHeader.h>
+#include "Core/SampleMaskingEngine.h"
+
+class TestSampleMaskEnvelopes : public juce::UnitTest
+{
+public:
+    TestSampleMaskEnvelopes()
+        : UnitTest("Sample Mask Envelopes", "Audio")
+    {
+    }
+
+    void runTest() override
+    {
+        beginTest("Flat volume stroke only affects the painted span");
+        {
+            auto out = renderVolumeStroke(0.5f, 0.75f, 1.0f, 0.75f);
+            expectWithinAbsoluteError(valueAt(out, 0.25), 1.0f, 1.0e-4f);
+            expectWithinAbsoluteError(valueAt(out, 0.75), 0.25f, 1.0e-3f);
+        }
+
+        beginTest("Sloped volume stroke follows the stroke height");
+        {
+            auto out = renderVolumeStroke(0.5f, 1.0f, 1.0f, 0.0f);
+            expectWithinAbsoluteError(valueAt(out, 0.25), 1.0f, 1.0e-4f);
+            expectWithinAbsoluteError(valueAt(out, 0.625), 0.25f, 0.01f);
+            expectWithinAbsoluteError(valueAt(out, 0.75), 0.5f, 0.01f);
+            expectWithinAbsoluteError(valueAt(out, 0.875), 0.75f, 0.01f);
+        }
+
+        beginTest("Filter masks keep independent state per channel");
+        {
+            auto out = renderStroke(SampleMaskingEngine::MaskingMode::Filter, 2, 0.0f, 0.5f, 1.0f, 0.2f);
+            float maxDiff = 0.0f, maxLevel = 0.0f;
+            for (int i = 0; i < out.getNumSamples(); ++i)
+            {
+                maxDiff = juce::jmax(maxDiff, std::abs(out.getSample(0, i) - out.getSample(1, i)));
+                maxLevel = juce::jmax(maxLevel, std::abs(out.getSample(0, i)));
+            }
+            expect(maxDiff == 0.0f, "channels with identical input diverged by " + juce::String(maxDiff));
+            expect(std::isfinite(maxLevel) && maxLevel > 0.1f && maxLevel < 2.0f);
+        }
+    }
+
+private:
+    static constexpr double kSampleRate = 48000.0;
+    static constexpr int kBlockSize = 250;   // deliberately not a multiple of the sub-block size
+
+    static juce::AudioBuffer<float> renderVolumeStroke(float x1, float y1, float x2, float y2)
+    {
+        return renderStroke(SampleMaskingEngine::MaskingMode::Volume, 1, x1, y1, x2, y2);
+    }
+
+    // Plays a sample through a single mask painted as a straight stroke on a
+    // 1x1 canvas that spans the whole sample. The sample is a constant 1.0
+    // (mono) or the same square wave on every channel.
+    static juce::AudioBuffer<float> renderStroke(SampleMaskingEngine::MaskingMode mode, int numChannels,
+                                                 float x1, float y1, float x2, float y2)
+    {
+        SampleMaskingEngine engine;
+        engine.prepareToPlay(kSampleRate, kBlockSize, numChannels);
+
+        juce::AudioBuffer<float> sample(numChannels, (int) kSampleRate);
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int i = 0; i < sample.getNumSamples(); ++i)
+                sample.setSample(ch, i, numChannels == 1 ? 1.0f : ((i / 60) % 2 == 0 ? 0.5f : -0.5f));
+        engine.loadSample(sample, kSampleRate);
+        engine.setCanvasSize(1.0f, 1.0f);
+        engine.setTimeRange(0.0f, 1.0f);
+        engine.setLooping(false);
+
+        const auto maskId = engine.createPaintMask(mode);
+        engine.addPointToMask(maskId, x1, y1, 1.0f);
+        engine.addPointToMask(maskId, x2, y2, 1.0f);
+        engine.finalizeMask(maskId);
+        engine.startPlayback();
+
+        const int numBlocks = (int) (0.95 * kSampleRate) / kBlockSize;
+        juce::AudioBuffer<float> out(numChannels, numBlocks * kBlockSize);
+        juce::AudioBuffer<float> block(numChannels, kBlockSize);
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            engine.processBlock(block);
+            for (int ch = 0; ch < numChannels; ++ch)
+                out.copyFrom(ch, b * kBlockSize, block, ch, 0, kBlockSize);
+        }
+        return out;
+    }
+
+    static float valueAt(const juce::AudioBuffer<float>& buffer, double seconds)
+    {
+        return buffer.getSample(0, (int) (seconds * kSampleRate));
+    }
+};
+
+static TestSampleMaskEnvelopes testSampleMaskEnvelopes;
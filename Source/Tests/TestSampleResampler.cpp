@@ -0,0 +1,143 @@
+/**
+ * SampleResampler quality tiers: every tier must interpolate in-band content
+ * accurately, and the sinc tiers must reject content that would alias when
+ * the sample is played back sped up.
+ */
+
+#include <JuceHeader.h>
+#include "dsp/SampleResampler.h"
+
+class TestSampleResampler : public juce::UnitTest
+{
+public:
+    TestSampleResampler()
+        : UnitTest("Sample Resampler", "Audio")
+    {
+    }
+
+    void runTest() override
+    {
+        using Quality = SampleResampler::Quality;
+
+        beginTest("All tiers interpolate in-band content");
+        for (auto [quality, tolerance] : { std::pair<Quality, float>{ Quality::Linear, 0.015f },
+                                           { Quality::Hermite, 2.0e-3f },
+                                           { Quality::Sinc16, 2.0e-3f },
+                                           { Quality::Sinc32, 1.0e-3f } })
+        {
+            const auto source = makeSine(0.05);
+            SampleResampler resampler(quality);
+            juce::AudioBuffer<float> out(2, 1000);
+            resampler.process(source, out, 0, out.getNumSamples(), 500.0, 0.37, false);
+
+            float maxError = 0.0f;
+            for (int i = 0; i < out.getNumSamples(); ++i)
+            {
+                const float expected = (float) std::sin(juce::MathConstants<double>::twoPi * 0.05 * (500.0 + 0.37 * i));
+                maxError = juce::jmax(maxError, std::abs(out.getSample(0, i) - expected));
+                expect(out.getSample(1, i) == out.getSample(0, i), "channels must be read with the same kernel");
+            }
+            expect(maxError < tolerance, "quality " + juce::String((int) quality) + " error " + juce::String(maxError));
+        }
+
+        beginTest("Sinc tiers band-limit sped-up playback");
+        {
+            // 0.3 x source rate is far above the output Nyquist at 4x speed
+            const auto source = makeSine(0.3);
+            const float linear = renderRms(source, Quality::Linear);
+            const float sinc16 = renderRms(source, Quality::Sinc16);
+            const float sinc32 = renderRms(source, Quality::Sinc32);
+            expect(linear > 0.3f, "linear should alias, rms " + juce::String(linear));
+            expect(sinc16 < 0.05f, "sinc16 rms " + juce::String(sinc16));
+            expect(sinc32 < 0.05f, "sinc32 rms " + juce::String(sinc32));
+        }
+
+        beginTest("Looped reads wrap around the source");
+        {
+            const auto source = makeSine(1.0 / 64.0, 4096);
+            SampleResampler resampler(Quality::Sinc16);
+            float frame[1] = {};
+            resampler.readFrame(source, 4096.0 + 10.25, 1.0, true, frame, 1);
+            const float expected = (float) std::sin(juce::MathConstants<double>::twoPi * 10.25 / 64.0);
+            expectWithinAbsoluteError(frame[0], expected, 2.0e-3f);
+        }
+
+        beginTest("A loop region wraps only inside its bounds");
+        {
+            const auto source = makeLoopedSample();
+            SampleResampler resampler(Quality::Sinc16);
+            const SampleResampler::Loop loop { kLoopStart, kLoopEnd, true };
+            float frame[1] = {};
+
+            // Near the end, past it (keeping the fraction) and just after the
+            // start, the taps see only the loop, never the lead-in or the tail
+            for (double position : { kLoopEnd - 2.25, kLoopEnd + 10.25, kLoopStart + 0.5 })
+            {
+                resampler.readFrame(source, position, 1.0, loop, frame, 1);
+                const double inLoop = std::fmod(position - kLoopStart, (double) (kLoopEnd - kLoopStart));
+                const float expected = (float) std::sin(juce::MathConstants<double>::twoPi * inLoop / kLoopPeriod);
+                expectWithinAbsoluteError(frame[0], expected, 2.0e-3f, "at " + juce::String(position));
+            }
+        }
+
+        beginTest("The lead-in before a loop plays as recorded");
+        {
+            const auto source = makeLoopedSample();
+            SampleResampler resampler(Quality::Sinc16);
+            const SampleResampler::Loop loop { kLoopStart, kLoopEnd, false };
+            float looped[1] = {}, plain[1] = {};
+
+            // The note start must not pull in the tail, and the first pass
+            // into the loop reads the real lead-in
+            for (double position : { 0.25, kLoopStart - 1.5, kLoopStart + 0.5 })
+            {
+                resampler.readFrame(source, position, 1.0, loop, looped, 1);
+                resampler.readFrame(source, position, 1.0, false, plain, 1);
+                expectEquals(looped[0], plain[0], "at " + juce::String(position));
+            }
+        }
+    }
+
+private:
+    static constexpr int kLoopStart = 1000;
+    static constexpr int kLoopPeriod = 64;
+    static constexpr int kLoopEnd = kLoopStart + 40 * kLoopPeriod;
+
+    // A flat lead-in, a loop of whole sine periods, then a flat tail
+    static juce::AudioBuffer<float> makeLoopedSample()
+    {
+        juce::AudioBuffer<float> buffer(1, kLoopEnd + 500);
+        for (int i = 0; i < buffer.getNumSamples(); ++i)
+        {
+            float value = 0.5f;
+            if (i >= kLoopEnd)
+                value = -0.8f;
+            else if (i >= kLoopStart)
+                value = (float) std::sin(juce::MathConstants<double>::twoPi * (i - kLoopStart) / kLoopPeriod);
+            buffer.setSample(0, i, value);
+        }
+        return buffer;
+    }
+
+    static juce::AudioBuffer<float> makeSine(double cyclesPerSample, int length = 48000)
+    {
+        juce::AudioBuffer<float> buffer(1, length);
+        for (int i = 0; i < length; ++i)
+            buffer.setSample(0, i, (float) std::sin(juce::MathConstants<double>::twoPi * cyclesPerSample * i));
+        return buffer;
+    }
+
+    static float renderRms(const juce::AudioBuffer<float>& source, SampleResampler::Quality quality)
+    {
+        SampleResampler resampler(quality);
+        juce::AudioBuffer<float> out(1, 4096);
+        resampler.process(source, out, 0, out.getNumSamples(), 1000.0, 4.0, false);
+
+        double sum = 0.0;
+        for (int i = 0; i < out.getNumSamples(); ++i)
+            sum += out.getSample(0, i) * out.getSample(0, i);
+        return (float) std::sqrt(sum / out.getNumSamples());
+    }
+};
+
+static TestSampleResampler testSampleResampler;
@@ -0,0 +1,131 @@
+/**
+ * SampleStreamer plays the preloaded head from RAM and the rest of the file
+ * from per-voice rings filled by its I/O thread. Whatever the thread timing,
+ * every frame a cursor delivers must be the file's frame at that position,
+ * and a cursor that could not get a stream stops at the end of the head.
+ */
+
+#include <JuceHeader.h>
+#include "Core/SampleStreamer.h"
+
+class TestSampleStreamer : public juce::UnitTest
+{
+public:
+    TestSampleStreamer()
+        : UnitTest("Sample Streamer", "Audio")
+    {
+    }
+
+    void runTest() override
+    {
+        const double fileRate = 10000.0;
+        const int longLength = 40000;
+        const int shortLength = 500;
+
+        juce::TemporaryFile longWav(".wav"), shortWav(".wav");
+        expect(writeRamp(longWav.getFile(), fileRate, longLength));
+        expect(writeRamp(shortWav.getFile(), fileRate, shortLength));
+
+        SampleStreamer streamer;
+        streamer.setPreloadTime(100);                       // 1000 frame heads
+        streamer.prepare(1, 8192);
+
+        const int longSample = streamer.addSample(longWav.getFile());
+        const int shortSample = streamer.addSample(shortWav.getFile());
+        expectEquals(longSample, 0);
+        expectEquals(shortSample, 1);
+        expect(streamer.addSample(longWav.getFile().getSiblingFile("missing.wav")) < 0);
+        expectEquals(streamer.getLengthInFrames(longSample), (juce::int64) longLength);
+
+        beginTest("Streamed frames match the file beyond the preloaded head");
+        {
+            SampleStreamer::Cursor cursor;
+            expect(streamer.start(cursor, longSample));
+            expect(cursor.stream >= 0);
+
+            expectEquals(playToEnd(streamer, cursor, 2), longLength);
+            streamer.stop(cursor);
+        }
+
+        beginTest("Short samples and voices without a stream play from RAM");
+        {
+            SampleStreamer::Cursor resident;
+            expect(streamer.start(resident, shortSample));
+            expectEquals(resident.stream, -1);
+            expectEquals(playToEnd(streamer, resident, 1), shortLength);
+
+            // The only stream is taken: the second voice gets the head alone
+            SampleStreamer::Cursor first, second;
+            expect(waitForStream(streamer, first, longSample));
+            expect(streamer.start(second, longSample));
+            expectEquals(second.stream, -1);
+            expectEquals(playToEnd(streamer, second, 1), 1000);
+
+            // Once given back, the stream is recycled for the next note
+            streamer.stop(first);
+            expect(waitForStream(streamer, second, longSample));
+            streamer.stop(second);
+        }
+    }
+
+private:
+    static float rampValue(int channel, juce::int64 frame)
+    {
+        const float value = (float) (frame % 997) / 997.0f - 0.5f;
+        return channel == 0 ? value : -value;
+    }
+
+    static bool writeRamp(const juce::File& file, double sampleRate, int length)
+    {
+        juce::AudioBuffer<float> ramp(2, length);
+        for (int channel = 0; channel < 2; ++channel)
+            for (int i = 0; i < length; ++i)
+                ramp.setSample(channel, i, rampValue(channel, i));
+
+        juce::WavAudioFormat format;
+        std::unique_ptr<juce::AudioFormatWriter> writer(format.createWriterFor(new juce::FileOutputStream(file),
+                                                                                sampleRate, 2, 32, {}, 0));
+        return writer != nullptr && writer->writeFromAudioSampleBuffer(ramp, 0, length);
+    }
+
+    // Reads block by block like a voice would and checks every frame that
+    // was really delivered (underruns leave the position where it was).
+    // Returns the number of frames played.
+    int playToEnd(SampleStreamer& streamer, SampleStreamer::Cursor& cursor, int sleepMs)
+    {
+        juce::AudioBuffer<float> block(2, 256);
+        int mismatches = 0;
+
+        for (int attempts = 0; attempts < 100000; ++attempts)
+        {
+            const auto before = cursor.position;
+            const int frames = streamer.read(cursor, block.getArrayOfWritePointers(), 2, block.getNumSamples());
+            const int delivered = (int) (cursor.position - before);
+
+            for (int channel = 0; channel < 2; ++channel)
+                for (int i = 0; i < delivered; ++i)
+                    mismatches += block.getSample(channel, i) != rampValue(channel, before + i) ? 1 : 0;
+
+            if (frames < block.getNumSamples())
+                break;
+
+            juce::Thread::sleep(sleepMs);
+        }
+
+        expectEquals(mismatches, 0);
+        return (int) cursor.position;
+    }
+
+    static bool waitForStream(SampleStreamer& streamer, SampleStreamer::Cursor& cursor, int sample)
+    {
+        for (int i = 0; i < 500; ++i)
+        {
+            if (streamer.start(cursor, sample) && cursor.stream >= 0)
+                return true;
+            juce::Thread::sleep(10);
+        }
+        return false;
+    }
+};
+
+static TestSampleStreamer testSampleStreamer;
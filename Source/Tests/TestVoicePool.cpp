@@ -0,0 +1,87 @@
+/**
+ * VoicePool steals the quietest sounding voice (oldest on ties) once its
+ * limit is reached, and only for a note that will actually sound: a note
+ * culled as inaudible must leave every playing voice alone.
+ */
+
+#include <JuceHeader.h>
+#include "dsp/VoicePool.h"
+
+class TestVoicePool : public juce::UnitTest
+{
+public:
+    TestVoicePool()
+        : UnitTest("Voice Pool", "Audio")
+    {
+    }
+
+    void runTest() override
+    {
+        beginTest("The quietest voice is stolen first, the oldest on ties");
+        {
+            VoicePool pool(kNumVoices);
+            pool.prepare(kSampleRate, kBlockSize, 8);
+
+            auto* a = pool.noteOn(220.0f, 0.5f, 8, 0.0f);
+            auto* b = pool.noteOn(330.0f, 0.1f, 8, 0.0f);
+            auto* c = pool.noteOn(440.0f, 0.5f, 8, 0.0f);
+            auto* d = pool.noteOn(550.0f, 0.1f, 8, 0.0f);
+            render(pool);
+
+            auto* e = pool.noteOn(660.0f, 0.5f, 8, 0.0f);
+            expect(e != nullptr && ! e->isStealing());
+            expect(b->isStealing(), "the older of the two quiet voices goes first");
+            expect(! a->isStealing() && ! c->isStealing() && ! d->isStealing());
+
+            auto* f = pool.noteOn(770.0f, 0.5f, 8, 0.0f);
+            expect(f != nullptr);
+            expect(d->isStealing());
+            expect(! a->isStealing() && ! c->isStealing() && ! e->isStealing());
+
+            // a and c have decayed from their peak; e and f have just started
+            pool.noteOn(880.0f, 0.5f, 8, 0.0f);
+            expect(a->isStealing());
+            expect(! c->isStealing() && ! e->isStealing() && ! f->isStealing());
+        }
+
+        beginTest("A note that cannot sound does not steal");
+        {
+            VoicePool pool(kNumVoices);
+            pool.prepare(kSampleRate, kBlockSize, 8);
+
+            Voice* playing[kNumVoices] = {};
+            for (int i = 0; i < kNumVoices; ++i)
+                playing[i] = pool.noteOn(220.0f * (float) (i + 1), 0.5f, 8, 0.0f);
+            render(pool);
+
+            expect(pool.noteOn(30000.0f, 0.5f, 8, 0.0f) == nullptr, "above Nyquist");
+            expect(pool.noteOn(440.0f, 0.0f, 8, 0.0f) == nullptr, "silent");
+            expect(pool.noteOn(440.0f, 0.5f, 8, 0.0f, 0.0f) == nullptr, "muted by the output gain");
+
+            expectEquals(pool.getNumActive(), kNumVoices);
+            for (auto* v : playing)
+                expect(v->isActive() && ! v->isStealing());
+
+            // An audible note still steals
+            expect(pool.noteOn(440.0f, 0.5f, 8, 0.0f) != nullptr);
+            int stealing = 0;
+            for (auto* v : playing)
+                stealing += v->isStealing() ? 1 : 0;
+            expectEquals(stealing, 1);
+        }
+    }
+
+private:
+    static constexpr double kSampleRate = 48000.0;
+    static constexpr int kBlockSize = 256;
+    static constexpr int kNumVoices = 4;
+
+    static void render(VoicePool& pool)
+    {
+        juce::AudioBuffer<float> buffer(2, kBlockSize);
+        buffer.clear();
+        pool.render(buffer);
+    }
+};
+
+static TestVoicePool testVoicePool;
@@ -0,0 +1,289 @@
+// batch_render.cpp
+// Offline, faster-than-realtime renderer: plays gesture files through the full
+// plugin processor (non-realtime mode, large blocks) and writes one WAV per job.
+// Jobs are independent processor instances and run in parallel on all cores.
+//
+// Usage:
+//   batch_render [--sr 48000] [--block 4096] [--jobs N] [--tail 2.0]
+//                <gestures.txt> <preset|-> <output.wav> [<gestures> <preset|-> <output> ...]
+//
+// gestures.txt format (one line per gesture, '#' starts a comment):
+//   <time_seconds> <yPos_0to1> <pressure_0to1> [xPos_0to1]
+// The preset is a state file saved by the plugin (binary or plain XML);
+// "-" renders with default parameters.
+
+#include <JuceHeader.h>
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../Core/PluginProcessor.h"
+
+using namespace juce;
+
+namespace {
+
+struct GestureEvent
+{
+    double timeSec;
+    float yPos;
+    float pressure;
+    float xPos;
+};
+
+struct RenderSettings
+{
+    double sampleRate = 48000.0;
+    int blockSize = 4096;
+    double tailSeconds = 2.0;
+};
+
+struct RenderJob
+{
+    File gestures;
+    String preset; // "-" = defaults
+    File output;
+};
+
+struct RenderResult
+{
+    bool ok = false;
+    String error;
+    int64 samples = 0;
+    double seconds = 0.0;
+};
+
+bool readGesturesFile(const File& file, std::vector<GestureEvent>& out)
+{
+    std::ifstream f(file.getFullPathName().toStdString());
+    if (! f.is_open()) return false;
+
+    std::string line;
+    while (std::getline(f, line))
+    {
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream iss(line);
+        GestureEvent g { 0.0, 0.0f, 0.0f, 0.5f };
+        if (! (iss >> g.timeSec >> g.yPos >> g.pressure)) continue;
+        iss >> g.xPos; // optional column
+        out.push_back(g);
+    }
+
+    std::stable_sort(out.begin(), out.end(), [](const GestureEvent& a, const GestureEvent& b) {
+        return a.timeSec < b.timeSec;
+    });
+    return true;
+}
+
+bool loadPreset(ARTEFACTAudioProcessor& processor, const String& preset, String& error)
+{
+    if (preset == "-")
+        return true;
+
+    MemoryBlock data;
+    if (! File(preset).loadFileAsData(data))
+    {
+        error = "cannot read preset " + preset;
+        return false;
+    }
+
+    // Accept plain XML (e.g. hand-edited presets) as well as saved plugin state
+    if (auto xml = parseXML(data.toString()))
+    {
+        data.reset();
+        AudioProcessor::copyXmlToBinary(*xml, data);
+    }
+
+    processor.setStateInformation(data.getData(), (int) data.getSize());
+    return true;
+}
+
+RenderResult renderJob(const RenderJob& job, const RenderSettings& settings)
+{
+    RenderResult result;
+    const auto startTicks = Time::getHighResolutionTicks();
+
+    std::vector<GestureEvent> gestures;
+    if (! readGesturesFile(job.gestures, gestures))
+    {
+        result.error = "cannot read gestures " + job.gestures.getFullPathName();
+        return result;
+    }
+
+    const double sr = settings.sampleRate;
+    const int block = settings.blockSize;
+
+    ARTEFACTAudioProcessor processor;
+    if (! loadPreset(processor, job.preset, result.error))
+        return result;
+
+    processor.setNonRealtime(true);
+    processor.setPlayConfigDetails(0, 2, sr, block);
+    processor.prepareToPlay(sr, block);
+
+    const double lastTime = gestures.empty() ? 0.0 : gestures.back().timeSec;
+    const int64 totalSamples = (int64) std::ceil((lastTime + settings.tailSeconds) * sr);
+
+    std::unique_ptr<AudioFormatWriter> writer;
+    {
+        job.output.deleteFile();
+        auto stream = job.output.createOutputStream();
+        if (stream == nullptr)
+        {
+            result.error = "cannot write " + job.output.getFullPathName();
+            return result;
+        }
+        WavAudioFormat wav;
+        writer.reset(wav.createWriterFor(stream.get(), sr, 2, 24, {}, 0));
+        if (writer == nullptr)
+        {
+            result.error = "cannot create WAV writer for " + job.output.getFullPathName();
+            return result;
+        }
+        stream.release(); // owned by the writer now
+    }
+
+    AudioBuffer<float> buffer(2, block);
+    MidiBuffer midi;
+    size_t next = 0;
+
+    for (int64 pos = 0; pos < totalSamples; )
+    {
+        int num = (int) std::min<int64>(block, totalSamples - pos);
+
+        // Queue every gesture due in this block with its exact sample time. If
+        // the queue fills up, end the block at the first event that did not fit.
+        while (next < gestures.size())
+        {
+            const auto& g = gestures[next];
+            const int64 when = (int64) std::llround(g.timeSec * sr);
+            if (when >= pos + num)
+                break;
+
+            PaintEvent e(g.xPos, g.yPos, g.pressure, next == 0 ? kStrokeStart : kStrokeMove);
+            if (! processor.pushPaintEventAt(e, std::max(when, pos)))
+            {
+                num = (int) std::max<int64>(1, when - pos);
+                break;
+            }
+            ++next;
+        }
+
+        buffer.setSize(2, num, false, false, true);
+        buffer.clear();
+        midi.clear();
+        processor.processBlock(buffer, midi);
+        writer->writeFromAudioSampleBuffer(buffer, 0, num);
+        pos += num;
+    }
+
+    processor.releaseResources();
+    writer.reset();
+
+    result.ok = true;
+    result.samples = totalSamples;
+    result.seconds = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - startTicks);
+    return result;
+}
+
+class RenderThreadJob : public ThreadPoolJob
+{
+public:
+    RenderThreadJob(const RenderJob& j, const RenderSettings& s, RenderResult& r)
+        : ThreadPoolJob(j.output.getFileName()), job(j), settings(s), result(r) {}
+
+    JobStatus runJob() override
+    {
+        result = renderJob(job, settings);
+        return jobHasFinished;
+    }
+
+private:
+    RenderJob job;
+    RenderSettings settings;
+    RenderResult& result;
+};
+
+void printUsage()
+{
+    std::cerr << "Usage: batch_render [--sr 48000] [--block 4096] [--jobs N] [--tail 2.0]\n"
+                 "                    <gestures.txt> <preset|-> <output.wav> [...]\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    ScopedJuceInitialiser_GUI juceInit;
+
+    RenderSettings settings;
+    int numThreads = SystemStats::getNumCpus();
+    StringArray positional;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const String arg(argv[i]);
+        const bool hasValue = i + 1 < argc;
+
+        if (arg == "--sr" && hasValue)         settings.sampleRate = String(argv[++i]).getDoubleValue();
+        else if (arg == "--block" && hasValue) settings.blockSize = String(argv[++i]).getIntValue();
+        else if (arg == "--jobs" && hasValue)  numThreads = String(argv[++i]).getIntValue();
+        else if (arg == "--tail" && hasValue)  settings.tailSeconds = String(argv[++i]).getDoubleValue();
+        else if (arg.startsWith("--"))         { printUsage(); return 1; }
+        else                                   positional.add(arg);
+    }
+
+    if (positional.isEmpty() || positional.size() % 3 != 0
+        || settings.sampleRate <= 0.0 || settings.blockSize <= 0 || settings.tailSeconds < 0.0)
+    {
+        printUsage();
+        return 1;
+    }
+
+    std::vector<RenderJob> jobs;
+    for (int i = 0; i < positional.size(); i += 3)
+        jobs.push_back({ File::getCurrentWorkingDirectory().getChildFile(positional[i]),
+                         positional[i + 1] == "-" ? String("-")
+                                                  : File::getCurrentWorkingDirectory().getChildFile(positional[i + 1]).getFullPathName(),
+                         File::getCurrentWorkingDirectory().getChildFile(positional[i + 2]) });
+
+    std::vector<RenderResult> results(jobs.size());
+    const auto startTicks = Time::getHighResolutionTicks();
+    {
+        ThreadPool pool(jlimit(1, (int) jobs.size(), numThreads));
+        for (size_t i = 0; i < jobs.size(); ++i)
+            pool.addJob(new RenderThreadJob(jobs[i], settings, results[i]), true);
+
+        while (pool.getNumJobs() > 0)
+            Thread::sleep(10);
+    }
+    const double wallSeconds = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - startTicks);
+
+    int failures = 0;
+    double audioSeconds = 0.0;
+    for (size_t i = 0; i < jobs.size(); ++i)
+    {
+        const auto& r = results[i];
+        if (! r.ok)
+        {
+            std::cerr << "FAILED " << jobs[i].output.getFileName() << ": " << r.error << "\n";
+            ++failures;
+            continue;
+        }
+
+        const double length = (double) r.samples / settings.sampleRate;
+        audioSeconds += length;
+        std::cout << jobs[i].output.getFullPathName() << "  " << String(length, 2) << " s audio in "
+                  << String(r.seconds, 2) << " s (" << String(length / jmax(1.0e-9, r.seconds), 1) << "x realtime)\n";
+    }
+
+    std::cout << jobs.size() - (size_t) failures << "/" << jobs.size() << " rendered, "
+              << String(audioSeconds, 2) << " s audio in " << String(wallSeconds, 2) << " s wall ("
+              << String(audioSeconds / jmax(1.0e-9, wallSeconds), 1) << "x realtime overall)\n";
+
+    return failures == 0 ? 0 : 2;
+}
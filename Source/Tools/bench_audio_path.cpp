@@ -0,0 +1,549 @@
+// bench_audio_path.cpp
+// Deterministic per-module benchmark of the audio path. Drives each engine with
+// seeded input at several sample rates and block sizes and reports, per case,
+// ns/sample, heap allocations made on the rendering thread and an output hash.
+// Results are compared against a stored baseline JSON; a slowdown beyond the
+// tolerance, new audio-thread allocations or changed output fail the run, and
+// so does a case the baseline has no entry for, or one over its module's
+// fixed CPU budget. An entry without a recorded hash or timing is only
+// warned about until --write-baseline fills it in.
+//
+// Usage:
+//   bench_audio_path [--baseline file.json] [--write-baseline file.json]
+//                    [--time-tolerance 0.25] [--alloc-tolerance 0]
+//                    [--seconds 1.0] [--filter EMUFilter] [--ignore-hashes]
+//
+// Exit code: 0 = within tolerances, 1 = regression, 2 = usage / IO error.
+//
+// Timing baselines are machine-specific: record them with --write-baseline on
+// the machine you compare on. Hashes cover the exact float output, so they also change with
+// compiler, flags and SIMD kernel.
+
+#include <JuceHeader.h>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "../Core/SpectralSynthEngine.h"
+#include "../Core/SampleMaskingEngine.h"
+#include "../Core/CDPSpectralEngine.h"
+#include "../Core/EMUFilter.h"
+#include "../Core/TubeStage.h"
+#include "../Core/EMURomplerEngine.h"
+#include "../Util/AllocationCounter.h"
+#include "../Util/Determinism.h"
+
+using namespace juce;
+namespace Det = SpectralCanvas::Determinism;
+namespace Alloc = SpectralCanvas::AllocationCounter;
+
+namespace {
+
+constexpr double kSampleRates[] = { 44100.0, 48000.0, 96000.0 };
+constexpr int    kBlockSizes[]  = { 64, 256, 1024 };
+
+// One engine under test. process() is the timed, allocation-counted call;
+// fillInput() runs outside the measurement.
+class ModuleHarness
+{
+public:
+    virtual ~ModuleHarness() = default;
+    virtual const char* name() const = 0;
+    virtual void prepare(double sampleRate, int blockSize) = 0;
+    virtual void fillInput(AudioBuffer<float>& buffer, int64 position, Det::Lcg32& rng) = 0;
+    virtual void process(AudioBuffer<float>& buffer) = 0;
+    virtual void release() {}
+
+    // Largest share of real time process() may take on one core, checked on
+    // every run whatever the baseline says; 0 = no fixed budget
+    virtual double cpuBudget() const { return 0.0; }
+};
+
+// Seeded noise plus two sines: broadband and tonal content for every effect
+void fillTestSignal(AudioBuffer<float>& buffer, int64 position, double sampleRate, Det::Lcg32& rng)
+{
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+    {
+        auto* d = buffer.getWritePointer(ch);
+        for (int n = 0; n < buffer.getNumSamples(); ++n)
+        {
+            const double t = (double) (position + n) / sampleRate;
+            d[n] = 0.25f * (float) std::sin(MathConstants<double>::twoPi * 220.0 * t)
+                 + 0.15f * (float) std::sin(MathConstants<double>::twoPi * 3300.0 * t + ch)
+                 + 0.10f * (rng.nextFloat01() * 2.0f - 1.0f);
+        }
+    }
+}
+
+class SpectralSynthHarness : public ModuleHarness
+{
+public:
+    const char* name() const override { return "SpectralSynthEngine"; }
+
+    void prepare(double sr, int block) override
+    {
+        sampleRate = sr;
+        engine = std::make_unique<SpectralSynthEngine>();
+        engine->setLoadGovernorEnabled(false); // governor decisions depend on wall-clock time
+        engine->prepare(sr, block);
+    }
+
+    // A new gesture every 10 ms, scheduled at its exact sample position
+    void fillInput(AudioBuffer<float>& buffer, int64 position, Det::Lcg32& rng) override
+    {
+        buffer.clear();
+        const int64 interval = (int64) (0.010 * sampleRate);
+        for (int64 t = ((position + interval - 1) / interval) * interval; t < position + buffer.getNumSamples(); t += interval)
+        {
+            PaintEvent e(rng.nextFloat01(), rng.nextFloat01(), 0.3f + 0.7f * rng.nextFloat01(), kStrokeMove);
+            engine->pushGestureRT(e, t);
+        }
+    }
+
+    void process(AudioBuffer<float>& buffer) override { engine->processAudioBlock(buffer, sampleRate); }
+    void release() override { engine->releaseResources(); }
+
+private:
+    std::unique_ptr<SpectralSynthEngine> engine;
+    double sampleRate = 48000.0;
+};
+
+class SampleMaskingHarness : public ModuleHarness
+{
+public:
+    const char* name() const override { return "SampleMaskingEngine"; }
+
+    void prepare(double sr, int block) override
+    {
+        sampleRate = sr;
+        engine = std::make_unique<SampleMaskingEngine>();
+        engine->prepareToPlay(sr, block, 2);
+
+        AudioBuffer<float> sample(2, (int) (2.0 * sr));
+        Det::Lcg32 rng(Det::GetSeed());
+        fillTestSignal(sample, 0, sr, rng);
+        engine->loadSample(sample, sr);
+        engine->setCanvasSize(1.0f, 1.0f);
+        engine->setTimeRange(0.0f, 2.0f);
+        engine->setLooping(true);
+
+        engine->beginPaintStroke(0.05f, 0.5f, SampleMaskingEngine::MaskingMode::Filter);
+        for (int i = 1; i <= 16; ++i)
+            engine->updatePaintStroke(0.05f + 0.055f * i, 0.5f + 0.4f * std::sin(0.7f * i), 0.8f);
+        engine->endPaintStroke();
+
+        engine->startPlayback();
+    }
+
+    void fillInput(AudioBuffer<float>& buffer, int64, Det::Lcg32&) override { buffer.clear(); }
+    void process(AudioBuffer<float>& buffer) override { engine->processBlock(buffer); }
+    void release() override { engine->releaseResources(); }
+
+private:
+    std::unique_ptr<SampleMaskingEngine> engine;
+    double sampleRate = 48000.0;
+};
+
+class CDPSpectralHarness : public ModuleHarness
+{
+public:
+    const char* name() const override { return "CDPSpectralEngine"; }
+
+    void prepare(double sr, int block) override
+    {
+        sampleRate = sr;
+        engine = std::make_unique<CDPSpectralEngine>();
+        engine->prepareToPlay(sr, block, 2);
+        engine->setSpectralEffect(CDPSpectralEngine::SpectralEffect::Blur, 0.6f);
+    }
+
+    void fillInput(AudioBuffer<float>& buffer, int64 position, Det::Lcg32& rng) override
+    {
+        fillTestSignal(buffer, position, sampleRate, rng);
+    }
+
+    void process(AudioBuffer<float>& buffer) override { engine->processBlock(buffer); }
+    void release() override { engine->releaseResources(); }
+
+private:
+    std::unique_ptr<CDPSpectralEngine> engine;
+    double sampleRate = 48000.0;
+};
+
+class EMUFilterHarness : public ModuleHarness
+{
+public:
+    const char* name() const override { return "EMUFilter"; }
+
+    void prepare(double sr, int block) override
+    {
+        sampleRate = sr;
+        filter = std::make_unique<EMUFilter>();
+        filter->prepareToPlay(sr, block);
+        filter->setCutoff(0.45f);
+        filter->setResonance(0.6f);
+        filter->setDrive(0.8f);
+    }
+
+    void fillInput(AudioBuffer<float>& buffer, int64 position, Det::Lcg32& rng) override
+    {
+        fillTestSignal(buffer, position, sampleRate, rng);
+    }
+
+    void process(AudioBuffer<float>& buffer) override { filter->processBlock(buffer); }
+    void release() override { filter->releaseResources(); }
+
+private:
+    std::unique_ptr<EMUFilter> filter;
+    double sampleRate = 48000.0;
+};
+
+class TubeStageHarness : public ModuleHarness
+{
+public:
+    const char* name() const override { return "TubeStage"; }
+
+    void prepare(double sr, int block) override
+    {
+        sampleRate = sr;
+        tube = std::make_unique<TubeStage>();
+        tube->prepare(sr, block);
+        tube->setDrive(12.0f);
+        tube->setBias(0.2f);
+    }
+
+    void fillInput(AudioBuffer<float>& buffer, int64 position, Det::Lcg32& rng) override
+    {
+        fillTestSignal(buffer, position, sampleRate, rng);
+    }
+
+    void process(AudioBuffer<float>& buffer) override { tube->process(buffer); }
+
+private:
+    std::unique_ptr<TubeStage> tube;
+    double sampleRate = 48000.0;
+};
+
+// 64 voices spread over five octaves of one stereo sample, with filter and
+// LFO modulation: the full polyphony load of the rompler. The sample is
+// preloaded whole so the output never depends on the streaming thread.
+class EMURomplerHarness : public ModuleHarness
+{
+public:
+    EMURomplerHarness() : sampleFile(".wav")
+    {
+        constexpr double fileRate = 44100.0;
+        constexpr int length = 441000;
+
+        AudioBuffer<float> sine(2, length);
+        for (int ch = 0; ch < 2; ++ch)
+            for (int i = 0; i < length; ++i)
+                sine.setSample(ch, i, 0.5f * (float) std::sin(MathConstants<double>::twoPi * 220.0 * i / fileRate));
+
+        WavAudioFormat wav;
+        std::unique_ptr<AudioFormatWriter> writer(wav.createWriterFor(new FileOutputStream(sampleFile.getFile()),
+                                                                      fileRate, 2, 32, {}, 0));
+        if (writer != nullptr)
+            writer->writeFromAudioSampleBuffer(sine, 0, length);
+    }
+
+    const char* name() const override { return "EMURomplerEngine"; }
+
+    void prepare(double sr, int block) override
+    {
+        engine = std::make_unique<EMURomplerEngine>();
+        engine->prepareToPlay(sr, block, 2);
+        engine->setPreloadTime(11000);
+
+        EMURomplerEngine::SampleInfo info;
+        info.name = "bench";
+        info.category = EMURomplerEngine::SampleCategory::Leads;
+        info.sampleFile = sampleFile.getFile();
+        engine->addSample(info);
+
+        engine->setFilterCutoff(0.6f);
+        engine->setFilterResonance(0.5f);
+        engine->setLFODepth(0.5f);
+        engine->setLFODestination(1);
+
+        for (int note = kFirstNote; note < kFirstNote + kNumVoices; ++note)
+            engine->noteOn(note, 0.5f);
+    }
+
+    void fillInput(AudioBuffer<float>& buffer, int64, Det::Lcg32&) override { buffer.clear(); }
+    void process(AudioBuffer<float>& buffer) override { engine->processBlock(buffer, midi); }
+    void release() override { engine->releaseResources(); }
+
+    // 1% of real time per voice keeps full polyphony well inside one core
+    double cpuBudget() const override { return kNumVoices * 0.01; }
+
+private:
+    static constexpr int kFirstNote = 36, kNumVoices = 64;
+
+    TemporaryFile sampleFile;
+    std::unique_ptr<EMURomplerEngine> engine;
+    MidiBuffer midi;
+};
+
+struct CaseResult
+{
+    String key;
+    double nsPerSample = 0.0;
+    uint64 allocations = 0;
+    uint64 hash = 0;
+    bool deterministic = true;
+};
+
+// FNV-1a over the raw bits of every output sample
+struct OutputHash
+{
+    uint64 value = 14695981039346656037ull;
+
+    void add(const AudioBuffer<float>& buffer) noexcept
+    {
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        {
+            auto* bytes = reinterpret_cast<const uint8*>(buffer.getReadPointer(ch));
+            for (size_t i = 0; i < (size_t) buffer.getNumSamples() * sizeof(float); ++i)
+                value = (value ^ bytes[i]) * 1099511628211ull;
+        }
+    }
+};
+
+struct PassResult
+{
+    double seconds = 0.0;
+    uint64 allocations = 0;
+    uint64 hash = 0;
+};
+
+PassResult runPass(ModuleHarness& module, double sr, int block, double seconds)
+{
+    module.prepare(sr, block);
+
+    Det::Lcg32 rng(Det::GetSeed() ^ (uint32) block ^ (uint32) sr);
+    AudioBuffer<float> buffer(2, block);
+    OutputHash hash;
+    PassResult result;
+
+    const int64 total = (int64) (seconds * sr);
+    for (int64 pos = 0; pos < total; pos += block)
+    {
+        module.fillInput(buffer, pos, rng);
+
+        Alloc::BeginThreadScope();
+        const auto t0 = Time::getHighResolutionTicks();
+        module.process(buffer);
+        const auto t1 = Time::getHighResolutionTicks();
+        result.allocations += Alloc::EndThreadScope();
+
+        result.seconds += Time::highResolutionTicksToSeconds(t1 - t0);
+        hash.add(buffer);
+    }
+
+    module.release();
+    result.hash = hash.value;
+    return result;
+}
+
+// Two passes from a fresh prepare: the faster one is timed (less scheduler
+// noise), and equal hashes prove the module is deterministic for this input.
+CaseResult runCase(ModuleHarness& module, double sr, int block, double seconds)
+{
+    const auto a = runPass(module, sr, block, seconds);
+    const auto b = runPass(module, sr, block, seconds);
+
+    CaseResult r;
+    r.key = String(module.name()) + "@" + String((int) sr) + "/" + String(block);
+    r.nsPerSample = jmin(a.seconds, b.seconds) * 1.0e9 / (double) ((int64) (seconds * sr));
+    r.allocations = jmax(a.allocations, b.allocations);
+    r.hash = a.hash;
+    r.deterministic = a.hash == b.hash;
+    return r;
+}
+
+String hashToString(uint64 h) { return String::toHexString((int64) h).paddedLeft('0', 16); }
+
+struct Tolerances
+{
+    double time = 0.25;   // allowed fractional slowdown
+    int allocations = 0;  // allowed extra allocations per case
+};
+
+var makeBaseline(const std::vector<CaseResult>& results, const Tolerances& tol)
+{
+    auto* tolerances = new DynamicObject();
+    tolerances->setProperty("nsPerSample", tol.time);
+    tolerances->setProperty("allocations", tol.allocations);
+
+    auto* cases = new DynamicObject();
+    for (const auto& r : results)
+    {
+        auto* c = new DynamicObject();
+        c->setProperty("nsPerSample", r.nsPerSample);
+        c->setProperty("allocations", (int64) r.allocations);
+        c->setProperty("hash", hashToString(r.hash));
+        c->setProperty("deterministic", r.deterministic);
+        cases->setProperty(r.key, var(c));
+    }
+
+    auto* root = new DynamicObject();
+    root->setProperty("version", 1);
+    root->setProperty("tolerances", var(tolerances));
+    root->setProperty("cases", var(cases));
+    return var(root);
+}
+
+void printUsage()
+{
+    std::cerr << "Usage: bench_audio_path [--baseline file.json] [--write-baseline file.json]\n"
+                 "                        [--time-tolerance 0.25] [--alloc-tolerance 0]\n"
+                 "                        [--seconds 1.0] [--filter name] [--ignore-hashes]\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    ScopedJuceInitialiser_GUI juceInit;
+
+    File baselineFile, writeFile;
+    Tolerances tol;
+    bool timeTolOverride = false, allocTolOverride = false, ignoreHashes = false;
+    double seconds = 1.0;
+    String filter;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const String arg(argv[i]);
+        const bool hasValue = i + 1 < argc;
+        const auto cwd = File::getCurrentWorkingDirectory();
+
+        if (arg == "--baseline" && hasValue)              baselineFile = cwd.getChildFile(argv[++i]);
+        else if (arg == "--write-baseline" && hasValue)   writeFile = cwd.getChildFile(argv[++i]);
+        else if (arg == "--time-tolerance" && hasValue)   { tol.time = String(argv[++i]).getDoubleValue(); timeTolOverride = true; }
+        else if (arg == "--alloc-tolerance" && hasValue)  { tol.allocations = String(argv[++i]).getIntValue(); allocTolOverride = true; }
+        else if (arg == "--seconds" && hasValue)          seconds = jmax(0.05, String(argv[++i]).getDoubleValue());
+        else if (arg == "--filter" && hasValue)           filter = argv[++i];
+        else if (arg == "--ignore-hashes")                ignoreHashes = true;
+        else                                              { printUsage(); return 2; }
+    }
+
+    var baseline;
+    if (baselineFile != File())
+    {
+        baseline = JSON::parse(baselineFile);
+        if (! baseline.isObject())
+        {
+            std::cerr << "Cannot read baseline " << baselineFile.getFullPathName() << "\n";
+            return 2;
+        }
+        // Command-line tolerances override the ones stored with the baseline
+        const auto& stored = baseline["tolerances"];
+        if (! timeTolOverride && stored.hasProperty("nsPerSample")) tol.time = stored["nsPerSample"];
+        if (! allocTolOverride && stored.hasProperty("allocations")) tol.allocations = stored["allocations"];
+    }
+
+    Det::SetEnabled(true);
+
+    std::vector<std::unique_ptr<ModuleHarness>> modules;
+    modules.push_back(std::make_unique<SpectralSynthHarness>());
+    modules.push_back(std::make_unique<SampleMaskingHarness>());
+    modules.push_back(std::make_unique<CDPSpectralHarness>());
+    modules.push_back(std::make_unique<EMUFilterHarness>());
+    modules.push_back(std::make_unique<TubeStageHarness>());
+    modules.push_back(std::make_unique<EMURomplerHarness>());
+
+    std::vector<CaseResult> results;
+    int failures = 0, unrecorded = 0;
+
+    std::cout << std::left << std::setw(32) << "case" << std::right << std::setw(12) << "ns/sample"
+              << std::setw(10) << "allocs" << std::setw(19) << "hash" << "  vs baseline" << std::endl;
+
+    for (auto& module : modules)
+    {
+        if (filter.isNotEmpty() && ! String(module->name()).containsIgnoreCase(filter))
+            continue;
+
+        for (double sr : kSampleRates)
+            for (int block : kBlockSizes)
+            {
+                const auto r = runCase(*module, sr, block, seconds);
+                results.push_back(r);
+
+                StringArray problems, missing;
+                String verdict = "new";
+
+                const double load = r.nsPerSample * sr * 1.0e-9;
+                if (module->cpuBudget() > 0.0 && load > module->cpuBudget())
+                    problems.add("over CPU budget " + String(load * 100.0, 1) + "% > "
+                                 + String(module->cpuBudget() * 100.0, 1) + "%");
+
+                const auto& base = baseline["cases"][Identifier(r.key)];
+                if (baselineFile != File() && ! base.isObject())
+                {
+                    problems.add("no baseline entry");
+                }
+                else if (base.isObject())
+                {
+                    const double baseNs = base["nsPerSample"];
+                    const int64 baseAllocs = base["allocations"];
+                    const bool timed = baseNs > 0.0;
+
+                    if (! timed)
+                        missing.add("timing");
+                    else if (r.nsPerSample > baseNs * (1.0 + tol.time))
+                        problems.add("slower " + String((r.nsPerSample / baseNs - 1.0) * 100.0, 1) + "%");
+                    if ((int64) r.allocations > baseAllocs + tol.allocations)
+                        problems.add("allocations " + String(baseAllocs) + " -> " + String((int64) r.allocations));
+
+                    const bool baseDeterministic = ! base.hasProperty("deterministic") || (bool) base["deterministic"];
+                    if (! ignoreHashes && r.deterministic && baseDeterministic)
+                    {
+                        if (! base.hasProperty("hash"))
+                            missing.add("hash");
+                        else if (base["hash"].toString() != hashToString(r.hash))
+                            problems.add("output changed");
+                    }
+
+                    if (problems.isEmpty())
+                        verdict = timed ? "ok (" + String((r.nsPerSample / baseNs - 1.0) * 100.0, 1) + "%)" : String("ok");
+                    if (! missing.isEmpty())
+                        verdict << ", no recorded " << missing.joinIntoString(" or ");
+                }
+                if (! problems.isEmpty())
+                    verdict = "FAIL: " + problems.joinIntoString(", ");
+                failures += problems.isEmpty() ? 0 : 1;
+                unrecorded += missing.isEmpty() ? 0 : 1;
+
+                std::cout << std::left << std::setw(32) << r.key.toStdString()
+                          << std::right << std::fixed << std::setprecision(2) << std::setw(12) << r.nsPerSample
+                          << std::setw(10) << r.allocations
+                          << std::setw(19) << (hashToString(r.hash) + (r.deterministic ? " " : "*")).toStdString()
+                          << "  " << verdict << std::endl;
+            }
+    }
+
+    std::cout << "* = output differs between two identical runs (hash not compared)" << std::endl;
+    if (unrecorded > 0)
+        std::cout << "warning: " << unrecorded << " case(s) have no recorded hash or timing and were checked for "
+                     "allocations only; record them with --write-baseline on the reference machine" << std::endl;
+
+    if (writeFile != File())
+    {
+        if (! writeFile.replaceWithText(JSON::toString(makeBaseline(results, tol))))
+        {
+            std::cerr << "Cannot write baseline " << writeFile.getFullPathName() << "\n";
+            return 2;
+        }
+        std::cout << "Baseline written to " << writeFile.getFullPathName() << std::endl;
+    }
+
+    if (failures > 0)
+    {
+        std::cout << failures << " case(s) regressed against " << baselineFile.getFullPathName() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,135 @@
+// bench_partial_bank.cpp
+// Measures additive voice throughput at 48 kHz / 128 samples: the block-rendered
+// PartialBank Voice against the previous per-sample juce::dsp::Oscillator loop.
+// Reports how many voices x partials one core sustains in realtime per kernel.
+//
+#include <JuceHeader.h>
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+#include "../dsp/Voice.h"
+
+namespace {
+
+constexpr double kSampleRate = 48000.0;
+constexpr int    kBlockSize  = 128;
+constexpr int    kBlocks     = 2000;
+
+// The per-sample oscillator voice this benchmark is the baseline for.
+class OscillatorVoice
+{
+public:
+    void prepare(double sr)
+    {
+        env.setSampleRate(sr);
+        env.setParameters({ 0.002f, 0.01f, 0.8f, 0.05f });
+        for (auto& o : osc)
+        {
+            o.initialise([](float x) { return std::sin(x); }, 2048);
+            o.prepare({ sr, (juce::uint32) kBlockSize, 1 });
+        }
+    }
+
+    void noteOn(float baseHz, int partials)
+    {
+        count = partials;
+        for (int i = 0; i < count; ++i)
+            osc[(size_t) i].setFrequency(baseHz * (i + 1), true);
+        env.noteOn();
+    }
+
+    void process(juce::AudioBuffer<float>& buffer)
+    {
+        auto* left = buffer.getWritePointer(0);
+        auto* right = buffer.getWritePointer(1);
+        for (int n = 0; n < buffer.getNumSamples(); ++n)
+        {
+            float s = 0.0f;
+            for (int i = 0; i < count; ++i)
+                s += osc[(size_t) i].processSample(0.0f) * (1.0f / (i + 1));
+            const float out = s * 0.5f * env.getNextSample();
+            left[n] += out * 0.5f;
+            right[n] += out * 0.5f;
+        }
+    }
+
+private:
+    std::array<juce::dsp::Oscillator<float>, 64> osc;
+    juce::ADSR env;
+    int count = 1;
+};
+
+template <typename RenderFn>
+double secondsPerBlock(RenderFn&& render)
+{
+    juce::AudioBuffer<float> buffer(2, kBlockSize);
+    for (int i = 0; i < 50; ++i) { buffer.clear(); render(buffer); } // warm-up
+
+    const auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < kBlocks; ++i) { buffer.clear(); render(buffer); }
+    const auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(t1 - t0).count() / kBlocks;
+}
+
+void report(const char* name, int voices, int partials, double seconds)
+{
+    const double blockSeconds = kBlockSize / kSampleRate;
+    const double load = seconds / blockSeconds;
+    const double partialsPerCore = (voices * partials) / load;
+    std::cout << std::left << std::setw(22) << name
+              << std::right << std::setw(4) << voices << " x " << std::setw(2) << partials
+              << "  " << std::fixed << std::setprecision(2) << std::setw(8) << seconds * 1.0e6 << " us/block"
+              << "  load " << std::setw(6) << load * 100.0 << "%"
+              << "  ~" << std::setprecision(0) << partialsPerCore << " voice-partials/core" << std::endl;
+}
+
+} // namespace
+
+int main()
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+
+    std::cout << "PartialBank benchmark @ " << kSampleRate << " Hz, " << kBlockSize << " samples" << std::endl;
+
+    for (int partials : { 16, 32, 64 })
+    {
+        const int voices = 64;
+
+        std::vector<OscillatorVoice> legacy((size_t) voices);
+        for (int v = 0; v < voices; ++v)
+        {
+            legacy[(size_t) v].prepare(kSampleRate);
+            legacy[(size_t) v].noteOn(80.0f + 7.0f * v, partials);
+        }
+        report("dsp::Oscillator", voices, partials, secondsPerBlock([&](auto& buf) {
+            for (auto& v : legacy) v.process(buf);
+        }));
+
+        for (auto isa : { PartialBank::Isa::Scalar, PartialBank::Isa::SSE,
+                          PartialBank::Isa::AVX, PartialBank::Isa::NEON })
+        {
+            std::vector<Voice> bank((size_t) voices);
+            bool available = true;
+            for (int v = 0; v < voices; ++v)
+            {
+                auto& voice = bank[(size_t) v];
+                voice.prepare(kSampleRate, kBlockSize, partials);
+                voice.forceIsa(isa);
+                available = available && voice.getIsa() == isa;
+                voice.noteOn(80.0f + 7.0f * v, 0.5f, (uint16_t) partials, 0.0f);
+            }
+            if (! available)
+                continue;
+
+            const juce::String name = juce::String("PartialBank/") + PartialBank::isaName(isa);
+            report(name.toRawUTF8(), voices, partials, secondsPerBlock([&](auto& buf) {
+                for (auto& v : bank) v.process(buf, 0, kBlockSize, false);
+            }));
+        }
+    }
+
+    return 0;
+}
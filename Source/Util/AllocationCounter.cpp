@@ -0,0 +1,91 @@
+#include "AllocationCounter.h"
+
+#include <cstdlib>
+#include <new>
+
+#if defined(_MSC_VER)
+ #include <malloc.h>
+#endif
+
+namespace SpectralCanvas {
+namespace AllocationCounter {
+
+// Trivially initialised, so reading them from operator new never allocates
+static thread_local bool t_counting = false;
+static thread_local uint64_t t_count = 0;
+
+void BeginThreadScope() noexcept { t_count = 0; t_counting = true; }
+uint64_t EndThreadScope() noexcept { t_counting = false; return t_count; }
+uint64_t GetThreadCount() noexcept { return t_count; }
+
+} // namespace AllocationCounter
+} // namespace SpectralCanvas
+
+namespace {
+
+void* countedAlloc(std::size_t size) noexcept
+{
+    using namespace SpectralCanvas::AllocationCounter;
+    if (t_counting) ++t_count;
+    return std::malloc(size != 0 ? size : 1);
+}
+
+void* countedAlignedAlloc(std::size_t size, std::size_t alignment) noexcept
+{
+    using namespace SpectralCanvas::AllocationCounter;
+    if (t_counting) ++t_count;
+    if (size == 0) size = 1;
+   #if defined(_MSC_VER)
+    return _aligned_malloc(size, alignment);
+   #else
+    void* p = nullptr;
+    return posix_memalign(&p, alignment < sizeof(void*) ? sizeof(void*) : alignment, size) == 0 ? p : nullptr;
+   #endif
+}
+
+void alignedFree(void* p) noexcept
+{
+   #if defined(_MSC_VER)
+    _aligned_free(p);
+   #else
+    std::free(p);
+   #endif
+}
+
+void* throwingAlloc(std::size_t size)
+{
+    if (void* p = countedAlloc(size)) return p;
+    throw std::bad_alloc();
+}
+
+void* throwingAlignedAlloc(std::size_t size, std::align_val_t alignment)
+{
+    if (void* p = countedAlignedAlloc(size, static_cast<std::size_t>(alignment))) return p;
+    throw std::bad_alloc();
+}
+
+} // namespace
+
+void* operator new(std::size_t size)                                  { return throwingAlloc(size); }
+void* operator new[](std::size_t size)                                { return throwingAlloc(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept   { return countedAlloc(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return countedAlloc(size); }
+
+void operator delete(void* p) noexcept                                 { std::free(p); }
+void operator delete[](void* p) noexcept                               { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept                    { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept                  { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept          { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept        { std::free(p); }
+
+void* operator new(std::size_t size, std::align_val_t a)               { return throwingAlignedAlloc(size, a); }
+void* operator new[](std::size_t size, std::align_val_t a)             { return throwingAlignedAlloc(size, a); }
+void* operator new(std::size_t size, std::align_val_t a, const std::nothrow_t&) noexcept   { return countedAlignedAlloc(size, static_cast<std::size_t>(a)); }
+void* operator new[](std::size_t size, std::align_val_t a, const std::nothrow_t&) noexcept { return countedAlignedAlloc(size, static_cast<std::size_t>(a)); }
+
+void operator delete(void* p, std::align_val_t) noexcept               { alignedFree(p); }
+void operator delete[](void* p, std::align_val_t) noexcept             { alignedFree(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept  { alignedFree(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { alignedFree(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept   { alignedFree(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { alignedFree(p); }
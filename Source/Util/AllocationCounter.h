@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+
+namespace SpectralCanvas {
+namespace AllocationCounter {
+
+// Counts heap allocations (global operator new) made by the calling thread.
+// The counting operator new lives in AllocationCounter.cpp; only targets that
+// compile it (benchmarks, tests) are instrumented, the plugin never is.
+void BeginThreadScope() noexcept;       // reset this thread's count and start counting
+uint64_t EndThreadScope() noexcept;     // stop counting, return the count
+uint64_t GetThreadCount() noexcept;
+
+// RAII helper: counts allocations made on this thread while alive.
+struct ScopedThreadCount
+{
+    ScopedThreadCount() noexcept { BeginThreadScope(); }
+    ~ScopedThreadCount() noexcept { EndThreadScope(); }
+    uint64_t count() const noexcept { return GetThreadCount(); }
+};
+
+} // namespace AllocationCounter
+} // namespace SpectralCanvas
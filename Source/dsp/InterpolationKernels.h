@@ -0,0 +1,99 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+ #include <emmintrin.h>
+ #define SC_INTERP_SSE2 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+ #include <arm_neon.h>
+ #define SC_INTERP_NEON 1
+#endif
+
+// Varispeed interpolation for voices that read a contiguous run of source
+// frames (EMURomplerEngine's streamed voices). Four output frames are done
+// per vector: read positions and taps are gathered with scalar loads (SSE2
+// has no gather), the cubic itself runs in SIMD. Positions are worked out
+// from the start position rather than accumulated, so long blocks do not
+// drift. Same 4-point, 3rd-order Hermite as SampleResampler::Quality::Hermite.
+namespace InterpolationKernels
+{
+    // dest[c][i] = src[c] read at position + i * increment, for every channel
+    // c < numChannels. src must be readable from floor(position) - 1 up to
+    // floor(position + (numFrames - 1) * increment) + 2, and position must
+    // not be negative. Returns the position of the next frame.
+    inline double hermite(const float* const* src, float* const* dest, int numChannels,
+                          int numFrames, double position, double increment) noexcept
+    {
+        int i = 0;
+       #if SC_INTERP_SSE2 || SC_INTERP_NEON
+        for (; i + 4 <= numFrames; i += 4)
+        {
+            int base[4];
+            alignas(16) float frac[4];
+            for (int j = 0; j < 4; ++j)
+            {
+                const double p = position + (double) (i + j) * increment;
+                base[j] = (int) p;
+                frac[j] = (float) (p - (double) base[j]);
+            }
+
+            for (int c = 0; c < numChannels; ++c)
+            {
+                const float* s = src[c];
+                alignas(16) float y[4][4];
+                for (int j = 0; j < 4; ++j)
+                {
+                    const float* tap = s + base[j] - 1;
+                    y[0][j] = tap[0];
+                    y[1][j] = tap[1];
+                    y[2][j] = tap[2];
+                    y[3][j] = tap[3];
+                }
+
+               #if SC_INTERP_SSE2
+                const __m128 f = _mm_load_ps(frac);
+                const __m128 y0 = _mm_load_ps(y[0]), y1 = _mm_load_ps(y[1]);
+                const __m128 y2 = _mm_load_ps(y[2]), y3 = _mm_load_ps(y[3]);
+                const __m128 half = _mm_set1_ps(0.5f);
+                const __m128 c1 = _mm_mul_ps(half, _mm_sub_ps(y2, y0));
+                const __m128 c2 = _mm_sub_ps(_mm_add_ps(y0, _mm_add_ps(y2, y2)),
+                                             _mm_add_ps(_mm_mul_ps(_mm_set1_ps(2.5f), y1), _mm_mul_ps(half, y3)));
+                const __m128 c3 = _mm_add_ps(_mm_mul_ps(half, _mm_sub_ps(y3, y0)),
+                                             _mm_mul_ps(_mm_set1_ps(1.5f), _mm_sub_ps(y1, y2)));
+                const __m128 r = _mm_add_ps(_mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_add_ps(_mm_mul_ps(c3, f), c2), f), c1), f), y1);
+                _mm_storeu_ps(dest[c] + i, r);
+               #else
+                const float32x4_t f = vld1q_f32(frac);
+                const float32x4_t y0 = vld1q_f32(y[0]), y1 = vld1q_f32(y[1]);
+                const float32x4_t y2 = vld1q_f32(y[2]), y3 = vld1q_f32(y[3]);
+                const float32x4_t c1 = vmulq_n_f32(vsubq_f32(y2, y0), 0.5f);
+                const float32x4_t c2 = vsubq_f32(vaddq_f32(y0, vaddq_f32(y2, y2)),
+                                                 vaddq_f32(vmulq_n_f32(y1, 2.5f), vmulq_n_f32(y3, 0.5f)));
+                const float32x4_t c3 = vaddq_f32(vmulq_n_f32(vsubq_f32(y3, y0), 0.5f),
+                                                 vmulq_n_f32(vsubq_f32(y1, y2), 1.5f));
+                vst1q_f32(dest[c] + i, vmlaq_f32(y1, vmlaq_f32(c1, vmlaq_f32(c2, c3, f), f), f));
+               #endif
+            }
+        }
+       #endif
+
+        for (; i < numFrames; ++i)
+        {
+            const double p = position + (double) i * increment;
+            const int base = (int) p;
+            const float f = (float) (p - (double) base);
+
+            for (int c = 0; c < numChannels; ++c)
+            {
+                const float* tap = src[c] + base - 1;
+                const float c1 = 0.5f * (tap[2] - tap[0]);
+                const float c2 = tap[0] - 2.5f * tap[1] + 2.0f * tap[2] - 0.5f * tap[3];
+                const float c3 = 0.5f * (tap[3] - tap[0]) + 1.5f * (tap[1] - tap[2]);
+                dest[c][i] = ((c3 * f + c2) * f + c1) * f + tap[1];
+            }
+        }
+
+        return position + (double) numFrames * increment;
+    }
+}
@@ -0,0 +1,145 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// What the governor is currently doing, published for the HUD. Written only by
+// the audio thread; every field is an independent relaxed atomic, so readers
+// never block (a snapshot may mix values from adjacent blocks).
+struct GovernorStats
+{
+    std::atomic<float>    load { 0.0f };          // smoothed DSP time / block deadline
+    std::atomic<float>    peakLoad { 0.0f };      // worst single block since reset
+    std::atomic<int>      level { 0 };            // 0 = full quality
+    std::atomic<float>    partialScale { 1.0f };  // fraction of each voice's partials kept
+    std::atomic<int>      voiceCap { 0 };         // sounding-voice limit in force
+    std::atomic<uint32_t> degradeCount { 0 };     // times quality was lowered
+    std::atomic<uint32_t> restoreCount { 0 };     // times quality was raised again
+};
+
+// Degrades synthesis gracefully as the audio thread nears its deadline.
+//
+// Each block the caller reports how long processing took; the governor keeps
+// an exponential average of time/deadline. Above kHighLoad it steps down a
+// fixed ladder (first dropping the highest partials of every voice, then
+// capping voice count); it steps back up only after the load has stayed below
+// kLowLoad for kRestoreSeconds. The gap between the two thresholds plus the
+// hold time is the hysteresis that stops it oscillating.
+class LoadGovernor
+{
+public:
+    struct Step { float partialScale; float voiceScale; };
+
+    static constexpr float  kHighLoad = 0.70f;
+    static constexpr float  kLowLoad  = 0.45f;
+    static constexpr double kRestoreSeconds = 0.5;
+
+    void prepare(double sampleRate, int maxVoices) noexcept
+    {
+        sr = sampleRate > 0.0 ? sampleRate : 44100.0;
+        voiceMax = juce::jmax(1, maxVoices);
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        smoothed = 0.0f;
+        level = 0;
+        calmSamples = 0;
+        stats.load.store(0.0f, std::memory_order_relaxed);
+        stats.peakLoad.store(0.0f, std::memory_order_relaxed);
+        publish();
+    }
+
+    void setEnabled(bool shouldBeEnabled) noexcept { enabled.store(shouldBeEnabled, std::memory_order_relaxed); }
+    bool isEnabled() const noexcept { return enabled.load(std::memory_order_relaxed); }
+
+    // Audio thread, once per block. Returns true if the limits changed.
+    bool update(double elapsedSeconds, int numSamples) noexcept
+    {
+        if (numSamples <= 0)
+            return false;
+
+        const float blockLoad = (float) (elapsedSeconds * sr / numSamples);
+        smoothed += kSmoothing * (blockLoad - smoothed);
+
+        stats.load.store(smoothed, std::memory_order_relaxed);
+        if (blockLoad > stats.peakLoad.load(std::memory_order_relaxed))
+            stats.peakLoad.store(blockLoad, std::memory_order_relaxed);
+
+        const int previous = level;
+
+        if (! isEnabled())
+        {
+            level = 0;
+            calmSamples = 0;
+        }
+        else if (smoothed > kHighLoad || blockLoad > 1.0f)
+        {
+            calmSamples = 0;
+            if (level < kNumSteps - 1)
+            {
+                ++level;
+                stats.degradeCount.fetch_add(1, std::memory_order_relaxed);
+                smoothed = kLowLoad; // give the reduced load time to show up before stepping again
+            }
+        }
+        else if (smoothed < kLowLoad && level > 0)
+        {
+            calmSamples += numSamples;
+            if (calmSamples >= (int64_t) (kRestoreSeconds * sr))
+            {
+                --level;
+                calmSamples = 0;
+                stats.restoreCount.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        else
+        {
+            calmSamples = 0;
+        }
+
+        if (level == previous)
+            return false;
+
+        publish();
+        return true;
+    }
+
+    float getPartialScale() const noexcept { return kLadder[(size_t) level].partialScale; }
+    int getVoiceCap() const noexcept { return juce::jmax(1, juce::roundToInt(voiceMax * kLadder[(size_t) level].voiceScale)); }
+    int getLevel() const noexcept { return level; }
+
+    const GovernorStats& getStats() const noexcept { return stats; }
+
+private:
+    static constexpr int kNumSteps = 7;
+    static constexpr float kSmoothing = 0.2f;
+
+    // Partials go first: the highest harmonics carry the least energy (1/h)
+    static constexpr std::array<Step, kNumSteps> kLadder {{
+        { 1.00f, 1.00f },
+        { 0.75f, 1.00f },
+        { 0.50f, 1.00f },
+        { 0.25f, 1.00f },
+        { 0.25f, 0.75f },
+        { 0.25f, 0.50f },
+        { 0.25f, 0.25f },
+    }};
+
+    void publish() noexcept
+    {
+        stats.level.store(level, std::memory_order_relaxed);
+        stats.partialScale.store(getPartialScale(), std::memory_order_relaxed);
+        stats.voiceCap.store(getVoiceCap(), std::memory_order_relaxed);
+    }
+
+    double sr = 44100.0;
+    int voiceMax = 64;
+    float smoothed = 0.0f;
+    int level = 0;
+    int64_t calmSamples = 0;
+    std::atomic<bool> enabled { true };
+    GovernorStats stats;
+};
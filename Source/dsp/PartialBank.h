@@ -0,0 +1,383 @@
+#pragma once
+#include <JuceHeader.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+ #include <immintrin.h>
+ #define SC_PARTIALBANK_X86 1
+ #if defined(__GNUC__) || defined(__clang__)
+  #define SC_TARGET_AVX __attribute__((target("avx")))
+ #else
+  #define SC_TARGET_AVX
+ #endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+ #include <arm_neon.h>
+ #define SC_PARTIALBANK_NEON 1
+#endif
+
+// Struct-of-arrays additive oscillator bank rendered a block at a time.
+//
+// Each partial is a phasor (cos φ, sin φ). Within a block, lane k of a SIMD
+// register produces sin(φ + kω) = sin φ·cos kω + cos φ·sin kω from per-partial
+// step tables, then the phasor is rotated by Lω for the next L samples. This
+// vectorises over time, so there is no horizontal reduction and no table lookup;
+// the phasor is renormalised once per block to stop drift.
+//
+// The kernel (scalar / SSE / AVX / NEON) is picked once at construction from
+// the running CPU, not from compile flags.
+//
+// fadeToNumPartials() changes the partial count without clicking: partials
+// leaving or joining the bank ramp their gain linearly over the fade length.
+// Only those few fading partials take a scalar per-sample path; the fully
+// sounding range [0, numSteady) stays on the SIMD kernel.
+class PartialBank
+{
+public:
+    static constexpr int kMaxPartials = 64;
+    static constexpr int kMaxLanes = 8;
+
+    enum class Isa { Scalar, SSE, AVX, NEON };
+
+    PartialBank() noexcept { selectKernel(); reset(); }
+
+    void reset() noexcept
+    {
+        std::fill(std::begin(re), std::end(re), 1.0f);
+        std::fill(std::begin(im), std::end(im), 0.0f);
+        std::fill(std::begin(amp), std::end(amp), 0.0f);
+        std::fill(std::begin(fade), std::end(fade), 0.0f);
+        numPartials = numSteady = targetPartials = 0;
+    }
+
+    // Length of the gain ramp used by fadeToNumPartials().
+    void setFadeLength(int samples) noexcept { fadeStep = 1.0f / (float) juce::jmax(1, samples); }
+
+    // Control rate: computes the step tables for one partial and resets its phase.
+    void setPartial(int index, double freqHz, float amplitude, double sampleRate) noexcept
+    {
+        jassert(index >= 0 && index < kMaxPartials);
+        const double w = juce::MathConstants<double>::twoPi * freqHz / sampleRate;
+
+        for (int k = 0; k < kMaxLanes; ++k)
+        {
+            stepCos[index][k] = (float) std::cos(w * k);
+            stepSin[index][k] = (float) std::sin(w * k);
+        }
+        advCos4[index] = (float) std::cos(w * 4.0);
+        advSin4[index] = (float) std::sin(w * 4.0);
+        advCos8[index] = (float) std::cos(w * 8.0);
+        advSin8[index] = (float) std::sin(w * 8.0);
+
+        re[index] = 1.0f;
+        im[index] = 0.0f;
+        amp[index] = amplitude;
+    }
+
+    // Control rate: retunes one partial, keeping its current phase (glides).
+    void setFrequency(int index, double freqHz, double sampleRate) noexcept
+    {
+        const float c = re[index], s = im[index], a = amp[index];
+        setPartial(index, freqHz, a, sampleRate);
+        re[index] = c;
+        im[index] = s;
+    }
+
+    void setAmplitude(int index, float amplitude) noexcept { amp[index] = amplitude; }
+
+    // Switches to n partials immediately (note start, where the envelope hides it).
+    void setNumPartials(int n) noexcept
+    {
+        numPartials = numSteady = targetPartials = juce::jlimit(0, kMaxPartials, n);
+        std::fill(fade, fade + numPartials, 1.0f);
+        std::fill(fade + numPartials, fade + kMaxPartials, 0.0f);
+    }
+
+    // Switches to n partials over the fade length: partials from n up fade out,
+    // partials below n that were silent fade in.
+    void fadeToNumPartials(int n) noexcept
+    {
+        targetPartials = juce::jlimit(0, kMaxPartials, n);
+        numSteady = juce::jmin(numSteady, targetPartials);
+        numPartials = juce::jmax(numPartials, targetPartials);
+    }
+
+    // Partials still producing sound, including any that are fading out.
+    int getNumPartials() const noexcept { return numPartials; }
+    int getTargetNumPartials() const noexcept { return targetPartials; }
+
+    // Adds the sum of all partials into out[0..num).
+    void render(float* out, int num) noexcept
+    {
+        if (num <= 0)
+            return;
+
+        if (numSteady > 0)
+            kernel(*this, out, num);
+
+        if (numPartials > numSteady)
+            renderFading(out, num);
+    }
+
+    Isa getIsa() const noexcept { return isa; }
+
+    static const char* isaName(Isa i) noexcept
+    {
+        switch (i)
+        {
+            case Isa::SSE:  return "SSE";
+            case Isa::AVX:  return "AVX";
+            case Isa::NEON: return "NEON";
+            default:        return "Scalar";
+        }
+    }
+
+    // Forces a specific kernel (benchmarks and tests). Falls back to scalar if the
+    // requested ISA is not available on this CPU.
+    void forceIsa(Isa requested) noexcept
+    {
+        isa = Isa::Scalar;
+        kernel = &renderScalar;
+        if (! isSupported(requested))
+            return;
+
+       #if SC_PARTIALBANK_X86
+        if (requested == Isa::AVX)      { isa = Isa::AVX; kernel = &renderAVX; }
+        else if (requested == Isa::SSE) { isa = Isa::SSE; kernel = &renderSSE; }
+       #elif SC_PARTIALBANK_NEON
+        if (requested == Isa::NEON)     { isa = Isa::NEON; kernel = &renderNEON; }
+       #endif
+    }
+
+private:
+    using Kernel = void (*)(PartialBank&, float*, int) noexcept;
+
+    static bool isSupported(Isa i) noexcept
+    {
+       #if SC_PARTIALBANK_X86
+        if (i == Isa::SSE) return juce::SystemStats::hasSSE2();
+        if (i == Isa::AVX) return juce::SystemStats::hasAVX();
+       #elif SC_PARTIALBANK_NEON
+        if (i == Isa::NEON) return true;
+       #endif
+        return i == Isa::Scalar;
+    }
+
+    void selectKernel() noexcept
+    {
+        for (auto candidate : { Isa::AVX, Isa::SSE, Isa::NEON })
+        {
+            if (isSupported(candidate))
+            {
+                forceIsa(candidate);
+                return;
+            }
+        }
+        forceIsa(Isa::Scalar);
+    }
+
+    // Writes the remaining (< lane count) samples and rotates the phasor by r·ω.
+    static inline void renderTail(const PartialBank& b, int p, float* out, int r,
+                                  float& c, float& s) noexcept
+    {
+        const float a = b.amp[p];
+        for (int k = 0; k < r; ++k)
+            out[k] += a * (s * b.stepCos[p][k] + c * b.stepSin[p][k]);
+
+        const float rc = b.stepCos[p][r], rs = b.stepSin[p][r];
+        const float nc = c * rc - s * rs;
+        s = c * rs + s * rc;
+        c = nc;
+    }
+
+    // Partials in [numSteady, numPartials) with a per-sample gain ramp towards
+    // 1 (below the target count) or 0 (above it). Once a ramp completes the
+    // partial rejoins the SIMD range or leaves the bank.
+    void renderFading(float* out, int num) noexcept
+    {
+        for (int p = numSteady; p < numPartials; ++p)
+        {
+            const float target = p < targetPartials ? 1.0f : 0.0f;
+            const float step = target > fade[p] ? fadeStep : -fadeStep;
+            const float a = amp[p];
+            float g = fade[p], c = re[p], s = im[p];
+
+            int n = 0;
+            for (; n + kMaxLanes <= num; n += kMaxLanes)
+            {
+                for (int k = 0; k < kMaxLanes; ++k)
+                {
+                    g = juce::jlimit(0.0f, 1.0f, g + step);
+                    out[n + k] += a * g * (s * stepCos[p][k] + c * stepSin[p][k]);
+                }
+                const float nc = c * advCos8[p] - s * advSin8[p];
+                s = c * advSin8[p] + s * advCos8[p];
+                c = nc;
+            }
+            for (int k = 0; n + k < num; ++k)
+            {
+                g = juce::jlimit(0.0f, 1.0f, g + step);
+                out[n + k] += a * g * (s * stepCos[p][k] + c * stepSin[p][k]);
+            }
+            if (n < num)
+            {
+                const int r = num - n;
+                const float nc = c * stepCos[p][r] - s * stepSin[p][r];
+                s = c * stepSin[p][r] + s * stepCos[p][r];
+                c = nc;
+            }
+
+            fade[p] = g;
+            storePhasor(*this, p, c, s);
+        }
+
+        while (numSteady < targetPartials && fade[numSteady] >= 1.0f)
+            ++numSteady;
+        while (numPartials > targetPartials && fade[numPartials - 1] <= 0.0f)
+            --numPartials;
+    }
+
+    // Stores the phasor back, renormalised to unit length to stop drift.
+    static inline void storePhasor(PartialBank& b, int p, float c, float s) noexcept
+    {
+        const float g = 1.0f / std::sqrt(c * c + s * s);
+        b.re[p] = c * g;
+        b.im[p] = s * g;
+    }
+
+    static void renderScalar(PartialBank& b, float* out, int num) noexcept
+    {
+        for (int p = 0; p < b.numSteady; ++p)
+        {
+            if (b.amp[p] == 0.0f)
+                continue;
+
+            const float a = b.amp[p], ac = b.advCos8[p], as = b.advSin8[p];
+            float c = b.re[p], s = b.im[p];
+
+            int n = 0;
+            for (; n + kMaxLanes <= num; n += kMaxLanes)
+            {
+                for (int k = 0; k < kMaxLanes; ++k)
+                    out[n + k] += a * (s * b.stepCos[p][k] + c * b.stepSin[p][k]);
+                const float nc = c * ac - s * as;
+                s = c * as + s * ac;
+                c = nc;
+            }
+            if (n < num)
+                renderTail(b, p, out + n, num - n, c, s);
+            storePhasor(b, p, c, s);
+        }
+    }
+
+   #if SC_PARTIALBANK_X86
+    static void renderSSE(PartialBank& b, float* out, int num) noexcept
+    {
+        for (int p = 0; p < b.numSteady; ++p)
+        {
+            if (b.amp[p] == 0.0f)
+                continue;
+
+            const __m128 a = _mm_set1_ps(b.amp[p]);
+            const __m128 cosK = _mm_mul_ps(a, _mm_load_ps(b.stepCos[p]));
+            const __m128 sinK = _mm_mul_ps(a, _mm_load_ps(b.stepSin[p]));
+            const float ac = b.advCos4[p], as = b.advSin4[p];
+            float c = b.re[p], s = b.im[p];
+
+            int n = 0;
+            for (; n + 4 <= num; n += 4)
+            {
+                const __m128 v = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(s), cosK),
+                                            _mm_mul_ps(_mm_set1_ps(c), sinK));
+                _mm_storeu_ps(out + n, _mm_add_ps(_mm_loadu_ps(out + n), v));
+                const float nc = c * ac - s * as;
+                s = c * as + s * ac;
+                c = nc;
+            }
+            if (n < num)
+                renderTail(b, p, out + n, num - n, c, s);
+            storePhasor(b, p, c, s);
+        }
+    }
+
+    SC_TARGET_AVX static void renderAVX(PartialBank& b, float* out, int num) noexcept
+    {
+        for (int p = 0; p < b.numSteady; ++p)
+        {
+            if (b.amp[p] == 0.0f)
+                continue;
+
+            const __m256 a = _mm256_set1_ps(b.amp[p]);
+            const __m256 cosK = _mm256_mul_ps(a, _mm256_load_ps(b.stepCos[p]));
+            const __m256 sinK = _mm256_mul_ps(a, _mm256_load_ps(b.stepSin[p]));
+            const float ac = b.advCos8[p], as = b.advSin8[p];
+            float c = b.re[p], s = b.im[p];
+
+            int n = 0;
+            for (; n + 8 <= num; n += 8)
+            {
+                const __m256 v = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(s), cosK),
+                                               _mm256_mul_ps(_mm256_set1_ps(c), sinK));
+                _mm256_storeu_ps(out + n, _mm256_add_ps(_mm256_loadu_ps(out + n), v));
+                const float nc = c * ac - s * as;
+                s = c * as + s * ac;
+                c = nc;
+            }
+            if (n < num)
+                renderTail(b, p, out + n, num - n, c, s);
+            storePhasor(b, p, c, s);
+        }
+    }
+   #endif
+
+   #if SC_PARTIALBANK_NEON
+    static void renderNEON(PartialBank& b, float* out, int num) noexcept
+    {
+        for (int p = 0; p < b.numSteady; ++p)
+        {
+            if (b.amp[p] == 0.0f)
+                continue;
+
+            const float32x4_t cosK = vmulq_n_f32(vld1q_f32(b.stepCos[p]), b.amp[p]);
+            const float32x4_t sinK = vmulq_n_f32(vld1q_f32(b.stepSin[p]), b.amp[p]);
+            const float ac = b.advCos4[p], as = b.advSin4[p];
+            float c = b.re[p], s = b.im[p];
+
+            int n = 0;
+            for (; n + 4 <= num; n += 4)
+            {
+                float32x4_t v = vmlaq_n_f32(vld1q_f32(out + n), cosK, s);
+                vst1q_f32(out + n, vmlaq_n_f32(v, sinK, c));
+                const float nc = c * ac - s * as;
+                s = c * as + s * ac;
+                c = nc;
+            }
+            if (n < num)
+                renderTail(b, p, out + n, num - n, c, s);
+            storePhasor(b, p, c, s);
+        }
+    }
+   #endif
+
+    // Per-partial step tables: cos/sin(kω) for k = 0..7, 32-byte aligned rows
+    alignas(32) float stepCos[kMaxPartials][kMaxLanes] {};
+    alignas(32) float stepSin[kMaxPartials][kMaxLanes] {};
+    alignas(32) float advCos4[kMaxPartials] {};
+    alignas(32) float advSin4[kMaxPartials] {};
+    alignas(32) float advCos8[kMaxPartials] {};
+    alignas(32) float advSin8[kMaxPartials] {};
+
+    // Phasor state and gain
+    alignas(32) float re[kMaxPartials] {};
+    alignas(32) float im[kMaxPartials] {};
+    alignas(32) float amp[kMaxPartials] {};
+    float fade[kMaxPartials] {};          // ramp gain, 1 for every partial below numSteady
+    float fadeStep = 1.0f / 256.0f;
+
+    int numPartials = 0;                  // sounding, including partials fading out
+    int numSteady = 0;                    // [0, numSteady) render at full gain
+    int targetPartials = 0;
+    Isa isa = Isa::Scalar;
+    Kernel kernel = &renderScalar;
+};
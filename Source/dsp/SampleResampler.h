@@ -0,0 +1,303 @@
+#pragma once
+#include <JuceHeader.h>
+#include <cmath>
+#include <vector>
+
+// Immutable windowed-sinc tables shared by every SampleResampler in the process
+// (hold through juce::SharedResourcePointer, like SynthTables). For each tap
+// count there is a one-sided kernel shape for arbitrary offsets, plus a
+// polyphase bank: kPhases + 1 rows of DC-normalised coefficients, one row per
+// fractional read position, laid out contiguously so a frame's coefficients
+// are a linear blend of two neighbouring rows.
+struct ResamplerTables
+{
+    static constexpr int kPhases = 256;   // rows per source sample
+
+    struct Kernel
+    {
+        int halfTaps = 0;
+        std::vector<float> shape;         // h(x) for x = i / kPhases, i in [0, halfTaps * kPhases]
+        std::vector<float> rows;          // (kPhases + 1) x (2 * halfTaps)
+    };
+
+    ResamplerTables()
+        : sinc16(build(8, 0.90f, 7.0)),
+          sinc32(build(16, 0.95f, 9.0))
+    {
+    }
+
+    Kernel sinc16, sinc32;
+
+private:
+    static double besselI0(double x)
+    {
+        double sum = 1.0, term = 1.0;
+        for (int k = 1; k < 32; ++k)
+        {
+            term *= (x * 0.5 / k) * (x * 0.5 / k);
+            sum += term;
+        }
+        return sum;
+    }
+
+    // Kaiser-windowed sinc with its cutoff at `cutoff` x Nyquist
+    static Kernel build(int halfTaps, float cutoff, double beta)
+    {
+        Kernel k;
+        k.halfTaps = halfTaps;
+
+        const int shapeSize = halfTaps * kPhases + 1;
+        k.shape.resize((size_t) shapeSize + 1, 0.0f); // trailing zero guards interpolation
+        for (int i = 0; i < shapeSize; ++i)
+        {
+            const double x = (double) i / kPhases;
+            const double r = x / halfTaps;
+            const double sinc = x == 0.0 ? 1.0 : std::sin(juce::MathConstants<double>::pi * cutoff * x)
+                                                     / (juce::MathConstants<double>::pi * cutoff * x);
+            const double window = besselI0(beta * std::sqrt(juce::jmax(0.0, 1.0 - r * r))) / besselI0(beta);
+            k.shape[(size_t) i] = (float) (cutoff * sinc * window);
+        }
+
+        const int taps = 2 * halfTaps;
+        k.rows.resize((size_t) ((kPhases + 1) * taps));
+        for (int p = 0; p <= kPhases; ++p)
+        {
+            float* row = k.rows.data() + p * taps;
+            double sum = 0.0;
+            for (int t = 0; t < taps; ++t)
+            {
+                // Tap t reads source index floor(pos) - halfTaps + 1 + t
+                const double x = std::abs((double) (t - halfTaps + 1) - (double) p / kPhases);
+                const double index = x * kPhases;
+                const int i0 = (int) index;
+                const double v = i0 >= shapeSize - 1 ? 0.0
+                                                     : k.shape[(size_t) i0] + (index - i0) * (k.shape[(size_t) i0 + 1] - k.shape[(size_t) i0]);
+                row[t] = (float) v;
+                sum += v;
+            }
+            for (int t = 0; t < taps; ++t)
+                row[t] = (float) (row[t] / sum);
+        }
+        return k;
+    }
+};
+
+// Varispeed reader for sample playback, shared by SampleMaskingEngine,
+// ForgeVoice and EMUSampleVoice. Quality tiers trade CPU for alias rejection:
+//   Linear  - 2 taps, the historic behaviour
+//   Hermite - 4-point, 3rd-order Hermite
+//   Sinc16 / Sinc32 - Kaiser-windowed sinc, 16 or 32 taps
+// Above unity increment the sinc kernels widen by the increment (capped at
+// kMaxStretch) so sped-up playback stays band-limited to the output Nyquist;
+// their cost grows accordingly.
+//
+// Every call produces whole frames: coefficients are worked out once per
+// frame and applied to all channels. Output channel c reads source channel
+// min(c, numSourceChannels - 1). Reads outside [0, length) are silence,
+// unless wrap is set, in which case the whole source is treated as a loop,
+// or a Loop region is given (see readFrame).
+// Nothing allocates after construction.
+class SampleResampler
+{
+public:
+    enum class Quality { Linear, Hermite, Sinc16, Sinc32 };
+
+    static constexpr double kMaxStretch = 4.0;
+    static constexpr int kMaxTaps = 2 * 16 * 4;
+    static constexpr int kMaxChannels = 16;     // per process() call
+
+    explicit SampleResampler(Quality initialQuality = Quality::Linear) noexcept : quality(initialQuality) {}
+
+    void setQuality(Quality newQuality) noexcept { quality = newQuality; }
+    Quality getQuality() const noexcept { return quality; }
+
+    // A loop region [start, end) of the source. Reads past `end` continue
+    // from `start`. Before the first wrap (`wrapped` false) the lead-in before
+    // `start` reads as recorded, so the attack is untouched; after it, taps
+    // reaching back across `start` come from the loop's tail, so every pass
+    // sees the same seam. Reads before 0 are silence either way.
+    struct Loop
+    {
+        int start = 0;
+        int end = 0;
+        bool wrapped = false;
+    };
+
+    // Writes one frame read at `position` into frame[0 .. numChannels).
+    // `increment` is the distance to the next frame and only sets the
+    // anti-alias bandwidth.
+    void readFrame(const juce::AudioBuffer<float>& source, double position, double increment, bool wrap,
+                   float* frame, int numChannels) const noexcept
+    {
+        const int length = source.getNumSamples();
+        readFrame(source, position, increment, wrap ? Loop { 0, length, true } : Loop {}, frame, numChannels);
+    }
+
+    // As above, looping inside `loop` (clamped to the source; an empty
+    // region does not loop).
+    void readFrame(const juce::AudioBuffer<float>& source, double position, double increment, const Loop& loop,
+                   float* frame, int numChannels) const noexcept
+    {
+        const int length = source.getNumSamples();
+        const int sourceChannels = source.getNumChannels();
+        if (length <= 0 || sourceChannels <= 0)
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+                frame[ch] = 0.0f;
+            return;
+        }
+
+        const int loopStart = juce::jlimit(0, length, loop.start);
+        const int loopEnd = juce::jlimit(0, length, loop.end);
+        const int loopLength = loopEnd - loopStart;
+        const bool looping = loopLength > 0;
+
+        if (looping && (position >= loopEnd || (loop.wrapped && position < loopStart)))
+        {
+            position = loopStart + std::fmod(position - loopStart, (double) loopLength);
+            if (position < loopStart)
+                position += loopLength;
+        }
+
+        float coeffs[kMaxTaps];
+        const double base = std::floor(position);
+        const float frac = (float) (position - base);
+        int numTaps = 0;
+        const int first = computeCoefficients(frac, (int) base, std::abs(increment), coeffs, numTaps);
+
+        const auto* const* channels = source.getArrayOfReadPointers();
+        const int lowest = looping && loop.wrapped ? loopStart : 0;
+        const int highest = looping ? loopEnd : length;
+        const bool inRange = first >= lowest && first + numTaps <= highest;
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const float* src = channels[juce::jmin(ch, sourceChannels - 1)];
+            float sum = 0.0f;
+
+            if (inRange)
+            {
+                const float* s = src + first;
+                for (int t = 0; t < numTaps; ++t)
+                    sum += coeffs[t] * s[t];
+            }
+            else
+            {
+                for (int t = 0; t < numTaps; ++t)
+                {
+                    int index = first + t;
+                    if (looping && index >= loopEnd)
+                        index = loopStart + (index - loopStart) % loopLength;
+                    else if (looping && loop.wrapped && index < loopStart)
+                        index = loopEnd - 1 - (loopStart - 1 - index) % loopLength;
+                    if (index < 0 || index >= length)
+                        continue;
+                    sum += coeffs[t] * src[index];
+                }
+            }
+
+            frame[ch] = sum;
+        }
+    }
+
+    // Renders numFrames frames into dest (all of its channels) from
+    // destStart, advancing by increment per frame. Returns the position of
+    // the next frame (not wrapped).
+    double process(const juce::AudioBuffer<float>& source, juce::AudioBuffer<float>& dest, int destStart,
+                   int numFrames, double position, double increment, bool wrap) const noexcept
+    {
+        const int numChannels = juce::jmin(dest.getNumChannels(), kMaxChannels);
+        auto* const* out = dest.getArrayOfWritePointers();
+        float frame[kMaxChannels];
+
+        for (int i = 0; i < numFrames; ++i)
+        {
+            readFrame(source, position, increment, wrap, frame, numChannels);
+            for (int ch = 0; ch < numChannels; ++ch)
+                out[ch][destStart + i] = frame[ch];
+            position += increment;
+        }
+        return position;
+    }
+
+private:
+    // Fills coeffs for a read at base + frac and returns the source index of
+    // the first tap
+    int computeCoefficients(float frac, int base, double increment, float* coeffs, int& numTaps) const noexcept
+    {
+        switch (quality)
+        {
+            case Quality::Linear:
+                coeffs[0] = 1.0f - frac;
+                coeffs[1] = frac;
+                numTaps = 2;
+                return base;
+
+            case Quality::Hermite:
+            {
+                const float f2 = frac * frac, f3 = f2 * frac;
+                coeffs[0] = -0.5f * frac + f2 - 0.5f * f3;
+                coeffs[1] = 1.0f - 2.5f * f2 + 1.5f * f3;
+                coeffs[2] = 0.5f * frac + 2.0f * f2 - 1.5f * f3;
+                coeffs[3] = -0.5f * f2 + 0.5f * f3;
+                numTaps = 4;
+                return base - 1;
+            }
+
+            case Quality::Sinc16:
+            case Quality::Sinc32:
+                break;
+        }
+
+        const auto& kernel = quality == Quality::Sinc16 ? tables->sinc16 : tables->sinc32;
+        const int halfTaps = kernel.halfTaps;
+
+        if (increment <= 1.0)
+        {
+            // Polyphase: blend the two rows either side of the fractional position
+            const int taps = 2 * halfTaps;
+            const float phase = frac * (float) ResamplerTables::kPhases;
+            const int row = juce::jmin((int) phase, ResamplerTables::kPhases - 1);
+            const float blend = phase - (float) row;
+            const float* r0 = kernel.rows.data() + row * taps;
+            const float* r1 = r0 + taps;
+            for (int t = 0; t < taps; ++t)
+                coeffs[t] = r0[t] + blend * (r1[t] - r0[t]);
+            numTaps = taps;
+            return base - halfTaps + 1;
+        }
+
+        // Stretched kernel h(x / stretch): lowers the cutoff to the output
+        // Nyquist, widening the support by the same factor
+        const double stretch = juce::jmin(increment, kMaxStretch);
+        const int reach = (int) std::ceil(halfTaps * stretch);
+        const int taps = 2 * reach;
+        const float scale = (float) (ResamplerTables::kPhases / stretch);
+        const float limit = (float) (halfTaps * ResamplerTables::kPhases);
+        const float* shape = kernel.shape.data();
+
+        float sum = 0.0f;
+        for (int t = 0; t < taps; ++t)
+        {
+            const float x = std::abs((float) (t - reach + 1) - frac) * scale;
+            float value = 0.0f;
+            if (x < limit)
+            {
+                const int i0 = (int) x;
+                value = shape[i0] + (x - (float) i0) * (shape[i0 + 1] - shape[i0]);
+            }
+            coeffs[t] = value;
+            sum += value;
+        }
+
+        const float norm = sum > 0.0f ? 1.0f / sum : 0.0f;
+        for (int t = 0; t < taps; ++t)
+            coeffs[t] *= norm;
+
+        numTaps = taps;
+        return base - reach + 1;
+    }
+
+    juce::SharedResourcePointer<ResamplerTables> tables;
+    Quality quality;
+};
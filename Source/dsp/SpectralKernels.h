@@ -0,0 +1,204 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+ #include <emmintrin.h>
+ #define SC_SPECTRAL_SSE2 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+ #include <arm_neon.h>
+ #define SC_SPECTRAL_NEON 1
+#endif
+
+// Block kernels for spectra stored as interleaved (re, im) pairs, the layout
+// juce::dsp::FFT::performRealOnlyForwardTransform produces for bins 0..N/2.
+//
+// SSE2 is part of every x86-64 target and AArch64 always has NEON, so the
+// vector paths are chosen at compile time; other targets use the scalar tail
+// loops. atan2/sin/cos are polynomial approximations (phase error < 5e-6 rad,
+// sin/cos error < 2e-6), plenty for spectral effects and far cheaper than libm.
+namespace SpectralKernels
+{
+    constexpr float kPi = 3.14159265358979f;
+    constexpr float kHalfPi = 1.57079632679490f;
+    constexpr float kTinyMagnitude = 1.0e-20f;
+
+    inline float atan2Approx(float y, float x) noexcept
+    {
+        const float ax = std::abs(x), ay = std::abs(y);
+        const float hi = ax > ay ? ax : ay;
+        const float lo = ax > ay ? ay : ax;
+        const float a = hi > 0.0f ? lo / hi : 0.0f;
+        const float s = a * a;
+        float r = a * (0.99997726f + s * (-0.33262347f + s * (0.19354346f + s * (-0.11643287f
+                     + s * (0.05265332f + s * -0.01172120f)))));
+        if (ay > ax) r = kHalfPi - r;
+        if (x < 0.0f) r = kPi - r;
+        return y < 0.0f ? -r : r;
+    }
+
+    // Reduces to [-pi/4, pi/4] by quadrant, then evaluates short Taylor series
+    inline void sinCosApprox(float x, float& s, float& c) noexcept
+    {
+        const float qf = std::nearbyint(x * (1.0f / kHalfPi));
+        const int q = (int) qf;
+        const float r = (x - qf * 1.5703125f) - qf * 4.83826794897e-4f; // two-step pi/2
+        const float r2 = r * r;
+        const float sr = r * (1.0f + r2 * (-1.6666667e-1f + r2 * (8.3333333e-3f + r2 * -1.98412698e-4f)));
+        const float cr = 1.0f + r2 * (-0.5f + r2 * (4.16666667e-2f + r2 * (-1.38888889e-3f + r2 * 2.48015873e-5f)));
+        const bool swap = (q & 1) != 0;
+        s = swap ? cr : sr;
+        c = swap ? sr : cr;
+        if (q & 2) s = -s;
+        if ((q + 1) & 2) c = -c;
+    }
+
+    // mags[k] = |bins[k]|
+    inline void magnitudes(const float* bins, float* mags, int numBins) noexcept
+    {
+        int k = 0;
+       #if SC_SPECTRAL_SSE2
+        for (; k + 4 <= numBins; k += 4)
+        {
+            const __m128 a = _mm_loadu_ps(bins + 2 * k);
+            const __m128 b = _mm_loadu_ps(bins + 2 * k + 4);
+            const __m128 re = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+            const __m128 im = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+            _mm_storeu_ps(mags + k, _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(re, re), _mm_mul_ps(im, im))));
+        }
+       #elif SC_SPECTRAL_NEON
+        for (; k + 4 <= numBins; k += 4)
+        {
+            const float32x4x2_t v = vld2q_f32(bins + 2 * k);
+            vst1q_f32(mags + k, vsqrtq_f32(vmlaq_f32(vmulq_f32(v.val[0], v.val[0]), v.val[1], v.val[1])));
+        }
+       #endif
+        for (; k < numBins; ++k)
+            mags[k] = std::sqrt(bins[2 * k] * bins[2 * k] + bins[2 * k + 1] * bins[2 * k + 1]);
+    }
+
+    // phases[k] = arg(bins[k])
+    inline void phases(const float* bins, float* ph, int numBins) noexcept
+    {
+        int k = 0;
+       #if SC_SPECTRAL_SSE2
+        const __m128 signMask = _mm_set1_ps(-0.0f);
+        const __m128 zero = _mm_setzero_ps();
+        for (; k + 4 <= numBins; k += 4)
+        {
+            const __m128 a = _mm_loadu_ps(bins + 2 * k);
+            const __m128 b = _mm_loadu_ps(bins + 2 * k + 4);
+            const __m128 x = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+            const __m128 y = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+            const __m128 ax = _mm_andnot_ps(signMask, x);
+            const __m128 ay = _mm_andnot_ps(signMask, y);
+            const __m128 hi = _mm_max_ps(ax, ay);
+            const __m128 lo = _mm_min_ps(ax, ay);
+            const __m128 nonZero = _mm_cmpgt_ps(hi, zero);
+            const __m128 q = _mm_and_ps(nonZero, _mm_div_ps(lo, _mm_or_ps(hi, _mm_andnot_ps(nonZero, _mm_set1_ps(1.0f)))));
+            const __m128 s = _mm_mul_ps(q, q);
+            __m128 r = _mm_add_ps(_mm_mul_ps(s, _mm_set1_ps(-0.01172120f)), _mm_set1_ps(0.05265332f));
+            r = _mm_add_ps(_mm_mul_ps(s, r), _mm_set1_ps(-0.11643287f));
+            r = _mm_add_ps(_mm_mul_ps(s, r), _mm_set1_ps(0.19354346f));
+            r = _mm_add_ps(_mm_mul_ps(s, r), _mm_set1_ps(-0.33262347f));
+            r = _mm_mul_ps(q, _mm_add_ps(_mm_mul_ps(s, r), _mm_set1_ps(0.99997726f)));
+            const __m128 steep = _mm_cmpgt_ps(ay, ax);
+            r = _mm_or_ps(_mm_and_ps(steep, _mm_sub_ps(_mm_set1_ps(kHalfPi), r)), _mm_andnot_ps(steep, r));
+            const __m128 left = _mm_cmplt_ps(x, zero);
+            r = _mm_or_ps(_mm_and_ps(left, _mm_sub_ps(_mm_set1_ps(kPi), r)), _mm_andnot_ps(left, r));
+            r = _mm_or_ps(r, _mm_and_ps(_mm_cmplt_ps(y, zero), signMask)); // r >= 0 here
+            _mm_storeu_ps(ph + k, r);
+        }
+       #endif
+        for (; k < numBins; ++k)
+            ph[k] = atan2Approx(bins[2 * k + 1], bins[2 * k]);
+    }
+
+    // bins[k] = mags[k] * e^(i phases[k])
+    inline void fromPolar(const float* mags, const float* ph, float* bins, int numBins) noexcept
+    {
+        int k = 0;
+       #if SC_SPECTRAL_SSE2
+        for (; k + 4 <= numBins; k += 4)
+        {
+            const __m128 x = _mm_loadu_ps(ph + k);
+            const __m128i q = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(1.0f / kHalfPi)));
+            const __m128 qf = _mm_cvtepi32_ps(q);
+            const __m128 r = _mm_sub_ps(_mm_sub_ps(x, _mm_mul_ps(qf, _mm_set1_ps(1.5703125f))),
+                                        _mm_mul_ps(qf, _mm_set1_ps(4.83826794897e-4f)));
+            const __m128 r2 = _mm_mul_ps(r, r);
+
+            __m128 sr = _mm_add_ps(_mm_mul_ps(r2, _mm_set1_ps(-1.98412698e-4f)), _mm_set1_ps(8.3333333e-3f));
+            sr = _mm_add_ps(_mm_mul_ps(r2, sr), _mm_set1_ps(-1.6666667e-1f));
+            sr = _mm_mul_ps(r, _mm_add_ps(_mm_mul_ps(r2, sr), _mm_set1_ps(1.0f)));
+
+            __m128 cr = _mm_add_ps(_mm_mul_ps(r2, _mm_set1_ps(2.48015873e-5f)), _mm_set1_ps(-1.38888889e-3f));
+            cr = _mm_add_ps(_mm_mul_ps(r2, cr), _mm_set1_ps(4.16666667e-2f));
+            cr = _mm_add_ps(_mm_mul_ps(r2, cr), _mm_set1_ps(-0.5f));
+            cr = _mm_add_ps(_mm_mul_ps(r2, cr), _mm_set1_ps(1.0f));
+
+            const __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(q, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+            const __m128 sinSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(q, _mm_set1_epi32(2)), 30));
+            const __m128 cosSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(q, _mm_set1_epi32(1)), _mm_set1_epi32(2)), 30));
+            const __m128 s = _mm_xor_ps(_mm_or_ps(_mm_and_ps(swap, cr), _mm_andnot_ps(swap, sr)), sinSign);
+            const __m128 c = _mm_xor_ps(_mm_or_ps(_mm_and_ps(swap, sr), _mm_andnot_ps(swap, cr)), cosSign);
+
+            const __m128 m = _mm_loadu_ps(mags + k);
+            const __m128 re = _mm_mul_ps(m, c);
+            const __m128 im = _mm_mul_ps(m, s);
+            _mm_storeu_ps(bins + 2 * k, _mm_unpacklo_ps(re, im));
+            _mm_storeu_ps(bins + 2 * k + 4, _mm_unpackhi_ps(re, im));
+        }
+       #endif
+        for (; k < numBins; ++k)
+        {
+            float s, c;
+            sinCosApprox(ph[k], s, c);
+            bins[2 * k] = mags[k] * c;
+            bins[2 * k + 1] = mags[k] * s;
+        }
+    }
+
+    // Rescales each bin from oldMags[k] to newMags[k] keeping its phase, so
+    // magnitude-only effects never leave the cartesian domain. A bin that was
+    // silent takes phase 0, as the polar round trip would give it.
+    inline void applyMagnitudes(float* bins, const float* oldMags, const float* newMags, int numBins) noexcept
+    {
+        int k = 0;
+       #if SC_SPECTRAL_SSE2
+        const __m128 tiny = _mm_set1_ps(kTinyMagnitude);
+        for (; k + 4 <= numBins; k += 4)
+        {
+            const __m128 oldM = _mm_loadu_ps(oldMags + k);
+            const __m128 newM = _mm_loadu_ps(newMags + k);
+            const __m128 silent = _mm_cmple_ps(oldM, tiny);
+            const __m128 g = _mm_div_ps(newM, _mm_max_ps(oldM, tiny));
+            const __m128 g01 = _mm_unpacklo_ps(g, g);
+            const __m128 g23 = _mm_unpackhi_ps(g, g);
+            // silent bins: (new, 0)
+            const __m128 s01 = _mm_unpacklo_ps(silent, silent);
+            const __m128 s23 = _mm_unpackhi_ps(silent, silent);
+            const __m128 z01 = _mm_unpacklo_ps(newM, _mm_setzero_ps());
+            const __m128 z23 = _mm_unpackhi_ps(newM, _mm_setzero_ps());
+            const __m128 a = _mm_mul_ps(_mm_loadu_ps(bins + 2 * k), g01);
+            const __m128 b = _mm_mul_ps(_mm_loadu_ps(bins + 2 * k + 4), g23);
+            _mm_storeu_ps(bins + 2 * k, _mm_or_ps(_mm_and_ps(s01, z01), _mm_andnot_ps(s01, a)));
+            _mm_storeu_ps(bins + 2 * k + 4, _mm_or_ps(_mm_and_ps(s23, z23), _mm_andnot_ps(s23, b)));
+        }
+       #endif
+        for (; k < numBins; ++k)
+        {
+            if (oldMags[k] <= kTinyMagnitude)
+            {
+                bins[2 * k] = newMags[k];
+                bins[2 * k + 1] = 0.0f;
+            }
+            else
+            {
+                const float g = newMags[k] / oldMags[k];
+                bins[2 * k] *= g;
+                bins[2 * k + 1] *= g;
+            }
+        }
+    }
+}
@@ -1,11 +1,18 @@
 #pragma once
+#include <algorithm>
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <type_traits>
 
 // Single-producer / single-consumer lock-free ring buffer.
-// Power-of-two capacity for cheap masking.
+// Power-of-two capacity for cheap masking. Head and tail are free-running
+// counters, so all CapacityPow2 slots are usable.
+//
+// Bulk operations (pushN / popN, beginWrite / commitWrite, beginRead /
+// commitRead) move contiguous spans with a single acquire/release pair.
+// The producer also maintains a high-water mark and a dropped-item count
+// that any thread may read without locking.
 template <typename T, size_t CapacityPow2>
 class SpscRing
 {
@@ -13,6 +20,19 @@ class SpscRing
     static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable for lock-free SPSC");
 
 public:
+    // Up to two contiguous regions of the ring (the second is non-empty only
+    // when the reservation wraps around the end of the buffer).
+    struct Span
+    {
+        T* data1 = nullptr;
+        size_t size1 = 0;
+        T* data2 = nullptr;
+        size_t size2 = 0;
+
+        size_t size() const noexcept { return size1 + size2; }
+        T& operator[](size_t i) const noexcept { return i < size1 ? data1[i] : data2[i - size1]; }
+    };
+
     SpscRing() : head(0), tail(0) {}
 
     // Producer thread (UI/Message thread)
@@ -20,45 +40,130 @@ public:
     {
         const auto h = head.load(std::memory_order_relaxed);
         const auto t = tail.load(std::memory_order_acquire);
-        if (((h + 1) & mask()) == (t & mask()))
+        if (h - t >= CapacityPow2)
+        {
+            recordDrop(1);
             return false; // full
+        }
         buffer[h & mask()] = v;
         head.store(h + 1, std::memory_order_release);
+        updateHighWater(h + 1 - t);
         return true;
     }
 
+    // Pushes as many of items[0..count) as fit; the rest are counted as dropped.
+    size_t pushN(const T* items, size_t count)
+    {
+        auto span = beginWrite(count);
+        const size_t n = span.size();
+        std::copy(items, items + span.size1, span.data1);
+        std::copy(items + span.size1, items + n, span.data2);
+        commitWrite(n);
+        if (n < count)
+            recordDrop(count - n);
+        return n;
+    }
+
+    // Reserves up to count free slots for in-place writing. Nothing is visible
+    // to the consumer until commitWrite().
+    Span beginWrite(size_t count)
+    {
+        const auto h = head.load(std::memory_order_relaxed);
+        const auto t = tail.load(std::memory_order_acquire);
+        return makeSpan(h, std::min(count, CapacityPow2 - (h - t)));
+    }
+
+    // Publishes the first count slots of the last beginWrite() reservation.
+    void commitWrite(size_t count)
+    {
+        if (count == 0)
+            return;
+        const auto h = head.load(std::memory_order_relaxed) + count;
+        head.store(h, std::memory_order_release);
+        updateHighWater(h - tail.load(std::memory_order_relaxed));
+    }
+
+    // Counts items the caller gave up on (e.g. after a failed beginWrite).
+    void recordDrop(size_t count) noexcept
+    {
+        dropped.store(dropped.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+    }
+
     // Consumer thread (audio thread)
     bool pop(T& out)
     {
         const auto t = tail.load(std::memory_order_relaxed);
         const auto h = head.load(std::memory_order_acquire);
-        if ((t & mask()) == (h & mask()))
+        if (t == h)
             return false; // empty
         out = buffer[t & mask()];
         tail.store(t + 1, std::memory_order_release);
         return true;
     }
 
-    size_t size() const
+    // Pops up to maxCount items into out; returns the number popped.
+    size_t popN(T* out, size_t maxCount)
     {
+        auto span = beginRead(maxCount);
+        const size_t n = span.size();
+        std::copy(span.data1, span.data1 + span.size1, out);
+        std::copy(span.data2, span.data2 + span.size2, out + span.size1);
+        commitRead(n);
+        return n;
+    }
+
+    // Exposes up to maxCount queued items in place; release them with commitRead().
+    Span beginRead(size_t maxCount)
+    {
+        const auto t = tail.load(std::memory_order_relaxed);
         const auto h = head.load(std::memory_order_acquire);
+        return makeSpan(t, std::min(maxCount, static_cast<size_t>(h - t)));
+    }
+
+    void commitRead(size_t count)
+    {
+        if (count != 0)
+            tail.store(tail.load(std::memory_order_relaxed) + count, std::memory_order_release);
+    }
+
+    size_t size() const
+    {
         const auto t = tail.load(std::memory_order_acquire);
-        return (h - t) & ((size_t{1} << kBits) - 1);
+        const auto h = head.load(std::memory_order_acquire);
+        return std::min(static_cast<size_t>(h - t), CapacityPow2);
     }
 
-    size_t freeSpace() const { return capacity() - size() - 1; }
+    size_t freeSpace() const { return capacity() - size(); }
     static constexpr size_t capacity() { return CapacityPow2; }
 
-private:
-    static constexpr size_t kBits = [] {
-        size_t n = 0, c = CapacityPow2;
-        while (c >>= 1) ++n;
-        return n;
-    }();
+    // Telemetry, readable from any thread
+    size_t getHighWaterMark() const noexcept { return highWater.load(std::memory_order_relaxed); }
+    uint64_t getDroppedCount() const noexcept { return dropped.load(std::memory_order_relaxed); }
 
+private:
     static constexpr size_t mask() { return CapacityPow2 - 1; }
 
+    Span makeSpan(size_t start, size_t count)
+    {
+        Span s;
+        const size_t index = start & mask();
+        s.data1 = buffer + index;
+        s.size1 = std::min(count, CapacityPow2 - index);
+        s.data2 = buffer;
+        s.size2 = count - s.size1;
+        return s;
+    }
+
+    // Producer-only writer, so a relaxed load/compare/store is race-free
+    void updateHighWater(size_t depth) noexcept
+    {
+        if (depth > highWater.load(std::memory_order_relaxed))
+            highWater.store(depth, std::memory_order_relaxed);
+    }
+
     alignas(64) std::atomic<size_t> head;
+    std::atomic<size_t> highWater{0};
+    std::atomic<uint64_t> dropped{0};
     alignas(64) std::atomic<size_t> tail;
     alignas(64) T buffer[CapacityPow2];
-};
\ No newline at end of file
+};
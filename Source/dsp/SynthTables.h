@@ -0,0 +1,21 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include "PartialBank.h"
+
+// Immutable lookup tables shared by every SpectralSynthEngine in the process.
+// Hold through juce::SharedResourcePointer<SynthTables>: the first engine builds
+// them, later instances reuse the same copy, and the last one frees it. Nothing
+// is written after construction, so any thread may read without locking.
+struct SynthTables
+{
+    static constexpr int kMaxPartials = PartialBank::kMaxPartials;
+
+    SynthTables()
+    {
+        for (int h = 0; h < kMaxPartials; ++h)
+            harmonicGain[(size_t) h] = 1.0f / (float) (h + 1); // simple 1/h falloff
+    }
+
+    std::array<float, kMaxPartials> harmonicGain {};
+};
@@ -1,67 +1,158 @@
 #pragma once
 #include <JuceHeader.h>
-#include <array>
+#include <vector>
+#include "PartialBank.h"
+#include "SynthTables.h"
 
 class Voice
 {
 public:
-    void prepare(double sr, int maxBlock, int maxPartialsToUse)
+    void prepare(double sr, int maxBlock, int maxPartialsToUse, const SynthTables* sharedTables = nullptr)
     {
+        tables = sharedTables;
         sampleRate = sr;
         partialsCount = std::clamp(maxPartialsToUse, 1, kMaxPartials);
         env.setSampleRate(sr);
         env.setParameters({ 0.002f, 0.01f, 0.8f, 0.05f }); // snappy defaults
-        for (int i = 0; i < kMaxPartials; ++i)
-        {
-            osc[i].initialise([](float x) { return std::sin(x); }, 2048);
-            osc[i].setFrequency(440.0f);
-        }
-        gain.setRampDurationSeconds(0.0);
+        bank.reset();
+        bank.setFadeLength(juce::jmax(1, (int) (sr * kPartialFadeSeconds)));
+        scratch.assign((size_t) juce::jmax(16, maxBlock), 0.0f);
+        lastLevel = 0.0f;
+        stealing = false;
         active = false;
     }
 
     bool isActive() const noexcept { return active; }
 
-    void noteOn(float baseHz, float amp, uint16_t partials, float panIn)
+    // outputGain is the gain applied after the voice (e.g. engine master gain);
+    // it only affects which partials count as audible.
+    void noteOn(float baseHz, float amp, uint16_t partials, float panIn, float outputGain = 1.0f)
     {
+        // Clear any steal fade first: a stolen slot reused for an inaudible
+        // note must not stay marked as stealing while it sits idle
+        stealGain = 1.0f;
+        stealStep = 0.0f;
+        stealing = false;
+
         partialsCount = std::clamp<int>(partials, 1, kMaxPartials);
         baseAmp = juce::jlimit(0.0f, 1.0f, amp);
         pan = juce::jlimit(-1.0f, 1.0f, panIn);
+        cullGain = baseAmp * outputGain;
+
+        setPartialFrequencies(baseHz, true);
+
+        // Nothing audible below Nyquist: leave the voice idle so the pool reclaims it
+        if (audiblePartials == 0)
+        {
+            active = false;
+            return;
+        }
 
-        for (int i = 0; i < partialsCount; ++i)
-            osc[i].setFrequency(baseHz * (i + 1), true);
+        lastLevel = baseAmp; // a fresh note must not look like the quietest steal candidate
 
         env.noteOn();
         active = true;
     }
 
+    // Whether noteOn() with these arguments would sound at all: the
+    // fundamental is the loudest partial and the first to fit under Nyquist,
+    // so this is noteOn's culling applied to it alone.
+    bool wouldSound(float baseHz, float amp, float outputGain = 1.0f) const noexcept
+    {
+        return (double) baseHz < kNyquistGuard * sampleRate
+            && juce::jlimit(0.0f, 1.0f, amp) * outputGain * harmonicGain(0) >= kAudibilityFloor;
+    }
+
     void noteOff() { env.noteOff(); }
 
+    // Glides to a new fundamental without resetting partial phases, re-culling
+    // partials that would now alias or that newly fit under Nyquist.
+    void setPitch(float baseHz) noexcept
+    {
+        if (active)
+            setPartialFrequencies(baseHz, false);
+    }
+
+    int getNumAudiblePartials() const noexcept { return audiblePartials; }
+
+    // Fades the voice out linearly over fadeSamples, then deactivates it. Used by
+    // VoicePool when the voice is stolen so the cut-off never clicks.
+    void beginSteal(int fadeSamples) noexcept
+    {
+        stealing = true;
+        stealStep = stealGain / (float) juce::jmax(1, fadeSamples);
+    }
+
+    bool isStealing() const noexcept { return stealing; }
+
+    // Renders only the lowest ceil(scale x partials) harmonics; the highest go
+    // first since they contribute least. Used by the CPU load governor; the
+    // dropped or restored partials fade over kPartialFadeSeconds.
+    void setPartialScale(float scale) noexcept
+    {
+        partialScale = juce::jlimit(0.0f, 1.0f, scale);
+        applyPartialScale(false);
+    }
+
+    // Output gain (amplitude x envelope x steal fade) at the end of the last block.
+    float getLevel() const noexcept { return lastLevel; }
+
+    // Renders the partial bank into a mono scratch block, then applies the
+    // envelope and pan once per sample rather than once per partial.
     void process(juce::AudioBuffer<float>& buffer, int start, int num, bool autoDeactivate = true)
     {
         if (! active) return;
 
-        juce::dsp::AudioBlock<float> block (buffer);
-        auto left  = block.getChannelPointer(0) + start;
-        auto right = block.getNumChannels() > 1 ? block.getChannelPointer(1) + start : nullptr;
+        auto left  = buffer.getWritePointer(0, start);
+        auto right = buffer.getNumChannels() > 1 ? buffer.getWritePointer(1, start) : nullptr;
 
-        const float panL = 0.5f * (1.0f - pan);
-        const float panR = 0.5f * (1.0f + pan);
+        const float panL = 0.5f * (1.0f - pan) * baseAmp;
+        const float panR = 0.5f * (1.0f + pan) * baseAmp;
+        const int maxChunk = (int) scratch.size();
 
-        for (int n = 0; n < num; ++n)
+        for (int offset = 0; offset < num; )
         {
-            float s = 0.0f;
-            for (int i = 0; i < partialsCount; ++i)
-                s += osc[i].processSample(0.0f) * (1.0f / (i + 1)); // simple 1/h falloff
+            const int chunk = juce::jmin(maxChunk, num - offset);
+            float* s = scratch.data();
 
-            const float envVal = env.getNextSample();
-            const float out = s * baseAmp * envVal;
+            std::fill(s, s + chunk, 0.0f);
+            bank.render(s, chunk);
 
-            left[n]  += out * panL;
-            if (right) right[n] += out * panR;
+            float envVal = 0.0f;
+            if (stealing)
+            {
+                for (int n = 0; n < chunk; ++n)
+                {
+                    envVal = env.getNextSample() * stealGain;
+                    stealGain = juce::jmax(0.0f, stealGain - stealStep);
+                    const float out = s[n] * envVal;
+                    left[offset + n] += out * panL;
+                    if (right) right[offset + n] += out * panR;
+                }
+            }
+            else
+            {
+                for (int n = 0; n < chunk; ++n)
+                {
+                    envVal = env.getNextSample();
+                    const float out = s[n] * envVal;
+                    left[offset + n] += out * panL;
+                    if (right) right[offset + n] += out * panR;
+                }
+            }
+
+            offset += chunk;
+            lastLevel = baseAmp * envVal;
+
+            // a stolen voice always ends once its fade completes
+            if (stealing && stealGain <= 0.0f)
+            {
+                active = false;
+                break;
+            }
 
-            // voice silently ends near zero
-            if (autoDeactivate && env.isActive() == false && std::abs(out) < 1.0e-5f)
+            // voice silently ends once the release has finished
+            if (autoDeactivate && ! env.isActive())
             {
                 active = false;
                 break;
@@ -69,15 +160,77 @@ public:
         }
     }
 
+    PartialBank::Isa getIsa() const noexcept { return bank.getIsa(); }
+    void forceIsa(PartialBank::Isa isa) noexcept { bank.forceIsa(isa); }
+
 private:
-    static constexpr int kMaxPartials = 64;
+    static constexpr int kMaxPartials = PartialBank::kMaxPartials;
+
+    // -100 dB: partials quieter than this after all gains are not rendered
+    static constexpr float kAudibilityFloor = 1.0e-5f;
+    // Keep partials a little below Nyquist so the top one never folds back
+    static constexpr double kNyquistGuard = 0.49;
+    // Partials joining or leaving a sounding voice ramp over this long
+    static constexpr double kPartialFadeSeconds = 0.005;
+
+    float harmonicGain(int i) const noexcept
+    {
+        return tables != nullptr ? tables->harmonicGain[(size_t) i]
+                                 : 1.0f / (float) (i + 1); // simple 1/h falloff
+    }
+
+    // Only partials below Nyquist and above the audibility floor are loaded into
+    // the bank; the harmonic gains fall monotonically, so that is always the
+    // contiguous range [0, audiblePartials). A partial that is still fading out
+    // keeps its phase if it comes back.
+    void setPartialFrequencies(float baseHz, bool resetPhase) noexcept
+    {
+        const double nyquistLimit = kNyquistGuard * sampleRate;
+        int count = 0;
+        while (count < partialsCount
+               && (double) baseHz * (count + 1) < nyquistLimit
+               && cullGain * harmonicGain(count) >= kAudibilityFloor)
+            ++count;
+
+        for (int i = 0; i < count; ++i)
+        {
+            const double hz = (double) baseHz * (i + 1);
+            if (resetPhase || i >= juce::jmax(audiblePartials, bank.getNumPartials()))
+                bank.setPartial(i, hz, harmonicGain(i), sampleRate);
+            else
+                bank.setFrequency(i, hz, sampleRate);
+        }
+
+        audiblePartials = count;
+        applyPartialScale(resetPhase);
+    }
+
+    // At note start the count switches at once (the attack covers it); on a
+    // sounding voice the bank fades partials in and out instead of clicking.
+    void applyPartialScale(bool immediate) noexcept
+    {
+        const int scaled = (int) std::ceil((float) audiblePartials * partialScale);
+        const int n = audiblePartials > 0 ? juce::jmax(1, scaled) : 0;
+        if (immediate)
+            bank.setNumPartials(n);
+        else
+            bank.fadeToNumPartials(n);
+    }
 
-    std::array<juce::dsp::Oscillator<float>, kMaxPartials> osc;
+    PartialBank bank;
+    const SynthTables* tables = nullptr;
+    std::vector<float> scratch;
     juce::ADSR env;
-    juce::dsp::Gain<float> gain;
     double sampleRate = 44100.0;
     int    partialsCount = 1;
+    int    audiblePartials = 0;
+    float  cullGain = 1.0f;
     float  baseAmp = 0.0f;
     float  pan = 0.0f;
+    float  partialScale = 1.0f;
+    float  lastLevel = 0.0f;
+    float  stealGain = 1.0f;
+    float  stealStep = 0.0f;
+    bool   stealing = false;
     bool   active = false;
-};
\ No newline at end of file
+};
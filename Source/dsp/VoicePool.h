@@ -2,31 +2,197 @@
 #include "Voice.h"
 #include <vector>
 
+// Fixed-size voice pool with O(1) allocation.
+//
+// Free voices live on an index stack; active voices are kept in a compact
+// index list (swap-remove), so render() touches only voices that sound and
+// an idle pool costs nothing. When the sounding-voice limit is reached the
+// quietest voice (oldest on ties) is faded out over a few milliseconds in one
+// of a small set of headroom slots, so stealing never clicks.
 class VoicePool
 {
 public:
-    explicit VoicePool(int numVoices = 64) { voices.resize(numVoices); }
+    explicit VoicePool(int numVoices = 64)
+        : maxVoiceLimit(juce::jmax(1, numVoices)),
+          voiceLimit(maxVoiceLimit),
+          headroom(juce::jmax(4, voiceLimit / 8))
+    {
+        const int total = voiceLimit + headroom;
+        voices.resize((size_t) total);
+        freeList.reserve((size_t) total);
+        activeList.reserve((size_t) total);
+        activePos.assign((size_t) total, -1);
+        startStamp.assign((size_t) total, 0);
+        resetLists();
+    }
 
-    void prepare(double sr, int maxBlock, int maxPartials)
+    void prepare(double sr, int maxBlock, int maxPartials, const SynthTables* tables = nullptr)
     {
-        for (auto& v : voices) v.prepare(sr, maxBlock, maxPartials);
+        for (auto& v : voices) v.prepare(sr, maxBlock, maxPartials, tables);
+        stealFadeSamples = juce::jmax(1, (int) (sr * kStealFadeSeconds));
+        resetLists();
     }
 
-    Voice* allocate()
+    // Starts a note on a free voice, stealing one if the pool is full. A note
+    // that would not sound is rejected first (nullptr), so it never steals.
+    Voice* noteOn(float baseHz, float amp, uint16_t partials, float pan, float outputGain = 1.0f)
     {
-        for (auto& v : voices) if (!v.isActive()) return &v;
-        // simple voice steal: take the first one
-        return &voices.front();
+        if (! voices.front().wouldSound(baseHz, amp, outputGain))
+            return nullptr;
+
+        auto* voice = allocate();
+        voice->noteOn(baseHz, amp, partials, pan, outputGain);
+        return voice;
     }
 
     void render(juce::AudioBuffer<float>& buf)
     {
-        const int n = buf.getNumSamples();
-        for (auto& v : voices)
+        render(buf, 0, buf.getNumSamples());
+    }
+
+    void render(juce::AudioBuffer<float>& buf, int start, int num)
+    {
+        for (size_t i = 0; i < activeList.size(); )
+        {
+            const int index = activeList[i];
+            auto& v = voices[(size_t) index];
+            const bool wasStealing = v.isStealing();
+
+            v.process(buf, start, num);
+
             if (v.isActive())
-                v.process(buf, 0, n);
+            {
+                ++i;
+                continue;
+            }
+
+            if (wasStealing)
+                --numStealing;
+            release(index); // swaps the last active voice into slot i
+        }
     }
 
+    // Lowers or restores the sounding-voice limit (never above the constructed
+    // size). Voices over a lowered limit are faded out quietest-first.
+    void setVoiceLimit(int n) noexcept
+    {
+        voiceLimit = juce::jlimit(1, maxVoiceLimit, n);
+        while (soundingCount() > voiceLimit)
+        {
+            const int victim = pickQuietest(false);
+            if (victim < 0 || voices[(size_t) victim].isStealing())
+                break;
+            voices[(size_t) victim].beginSteal(stealFadeSamples);
+            ++numStealing;
+        }
+    }
+
+    void setPartialScale(float scale) noexcept
+    {
+        for (auto& v : voices) v.setPartialScale(scale);
+    }
+
+    int getNumActive() const noexcept { return (int) activeList.size(); }
+    int getVoiceLimit() const noexcept { return voiceLimit; }
+
 private:
+    static constexpr double kStealFadeSeconds = 0.005;
+
+    // A free voice, after fading out the quietest one if the limit is reached
+    Voice* allocate()
+    {
+        if (soundingCount() >= voiceLimit)
+            if (auto victim = pickQuietest(false); victim >= 0)
+            {
+                voices[(size_t) victim].beginSteal(stealFadeSamples);
+                ++numStealing;
+            }
+
+        int index;
+        if (! freeList.empty())
+        {
+            index = freeList.back();
+            freeList.pop_back();
+            activePos[(size_t) index] = (int) activeList.size();
+            activeList.push_back(index);
+        }
+        else
+        {
+            // Headroom exhausted by a burst of steals: hard-reuse the quietest
+            // fading voice, which is already close to silence.
+            index = pickQuietest(true);
+            if (voices[(size_t) index].isStealing())
+                --numStealing;
+        }
+
+        startStamp[(size_t) index] = ++allocationCounter;
+        return &voices[(size_t) index];
+    }
+
+    int soundingCount() const noexcept { return (int) activeList.size() - numStealing; }
+
+    // Lowest output level wins; the oldest voice breaks ties. Scans only the
+    // active list, and only when the pool is saturated.
+    int pickQuietest(bool fadingOnly) const noexcept
+    {
+        int best = -1;
+        float bestLevel = 0.0f;
+        uint64_t bestStamp = 0;
+
+        for (int index : activeList)
+        {
+            const auto& v = voices[(size_t) index];
+            if (v.isStealing() != fadingOnly)
+                continue;
+
+            const float level = v.getLevel();
+            const uint64_t stamp = startStamp[(size_t) index];
+            if (best < 0 || level < bestLevel || (level == bestLevel && stamp < bestStamp))
+            {
+                best = index;
+                bestLevel = level;
+                bestStamp = stamp;
+            }
+        }
+
+        if (best < 0 && ! activeList.empty())
+            best = activeList.front();
+        return best;
+    }
+
+    void release(int index) noexcept
+    {
+        const int pos = activePos[(size_t) index];
+        const int last = activeList.back();
+        activeList[(size_t) pos] = last;
+        activePos[(size_t) last] = pos;
+        activeList.pop_back();
+        activePos[(size_t) index] = -1;
+        freeList.push_back(index);
+    }
+
+    void resetLists() noexcept
+    {
+        freeList.clear();
+        activeList.clear();
+        for (int i = (int) voices.size() - 1; i >= 0; --i)
+        {
+            freeList.push_back(i);
+            activePos[(size_t) i] = -1;
+        }
+        numStealing = 0;
+    }
+
     std::vector<Voice> voices;
-};
\ No newline at end of file
+    std::vector<int> freeList;    // stack of free voice indices
+    std::vector<int> activeList;  // compact list of sounding/fading voices
+    std::vector<int> activePos;   // voice index -> position in activeList
+    std::vector<uint64_t> startStamp;
+
+    int maxVoiceLimit;
+    int voiceLimit;
+    int headroom;
+    int numStealing = 0;
+    int stealFadeSamples = 220;
+    uint64_t allocationCounter = 0;
+};
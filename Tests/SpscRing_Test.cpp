@@ -24,17 +24,20 @@ public:
         {
             SpscRing<int, 4> q; // capacity of 4
             
-            // Fill queue to capacity (should be able to store 3 items due to fullness check)
+            // Fill queue to capacity (all 4 slots are usable)
             expect(q.push(1));
             expect(q.push(2));
             expect(q.push(3));
-            expect(!q.push(4)); // Should fail - queue full
+            expect(q.push(4));
+            expect(!q.push(5)); // Should fail - queue full
+            expectEquals(static_cast<int>(q.getDroppedCount()), 1);
             
             // Pop and verify order
             int val;
             expect(q.pop(val) && val == 1);
             expect(q.pop(val) && val == 2);
             expect(q.pop(val) && val == 3);
+            expect(q.pop(val) && val == 4);
             expect(!q.pop(val)); // Should fail - queue empty
         }
         
@@ -63,16 +66,64 @@ public:
         {
             SpscRing<int, 8> q;
             expectEquals(static_cast<int>(q.size()), 0);
-            expectEquals(static_cast<int>(q.freeSpace()), 6); // capacity - 1 due to fullness logic
+            expectEquals(static_cast<int>(q.freeSpace()), 8);
             
             q.push(1);
             expectEquals(static_cast<int>(q.size()), 1);
-            expectEquals(static_cast<int>(q.freeSpace()), 5);
+            expectEquals(static_cast<int>(q.freeSpace()), 7);
             
             q.push(2);
             q.push(3);
             expectEquals(static_cast<int>(q.size()), 3);
-            expectEquals(static_cast<int>(q.freeSpace()), 3);
+            expectEquals(static_cast<int>(q.freeSpace()), 5);
+            expectEquals(static_cast<int>(q.getHighWaterMark()), 3);
+        }
+        
+        beginTest("bulk pushN/popN across wrap");
+        {
+            SpscRing<int, 8> q;
+            int in[6] = { 1, 2, 3, 4, 5, 6 };
+            int out[8] = {};
+            
+            expectEquals(static_cast<int>(q.pushN(in, 6)), 6);
+            expectEquals(static_cast<int>(q.popN(out, 4)), 4);
+            expectEquals(out[3], 4);
+            
+            // head is now at 6, so this write wraps around the end of the buffer
+            expectEquals(static_cast<int>(q.pushN(in, 6)), 6);
+            expectEquals(static_cast<int>(q.pushN(in, 2)), 0);
+            expectEquals(static_cast<int>(q.getDroppedCount()), 2);
+            expectEquals(static_cast<int>(q.getHighWaterMark()), 8);
+            
+            expectEquals(static_cast<int>(q.popN(out, 8)), 8);
+            expectEquals(out[0], 5);
+            expectEquals(out[1], 6);
+            expectEquals(out[2], 1);
+            expectEquals(out[7], 6);
+        }
+        
+        beginTest("zero-copy reservation");
+        {
+            SpscRing<int, 4> q;
+            int val;
+            q.push(0);
+            q.pop(val);
+            
+            auto span = q.beginWrite(4);
+            expectEquals(static_cast<int>(span.size()), 4);
+            expectEquals(static_cast<int>(span.size1), 3);
+            for (size_t i = 0; i < span.size(); ++i)
+                span[i] = static_cast<int>(i) + 10;
+            
+            expect(!q.pop(val)); // not visible until committed
+            q.commitWrite(3);
+            expectEquals(static_cast<int>(q.size()), 3);
+            
+            auto readSpan = q.beginRead(8);
+            expectEquals(static_cast<int>(readSpan.size()), 3);
+            expectEquals(readSpan[2], 12);
+            q.commitRead(readSpan.size());
+            expectEquals(static_cast<int>(q.size()), 0);
         }
     }
 };